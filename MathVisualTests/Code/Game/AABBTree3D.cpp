@@ -0,0 +1,457 @@
+#include "Game/AABBTree3D.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Plane3.hpp"
+
+//-----------------------------------------------------------------------------------------------
+static AABB3 GetUnion(AABB3 const& boundsA, AABB3 const& boundsB)
+{
+	AABB3 result;
+	result.m_mins = Vec3(fminf(boundsA.m_mins.x, boundsB.m_mins.x), fminf(boundsA.m_mins.y, boundsB.m_mins.y), fminf(boundsA.m_mins.z, boundsB.m_mins.z));
+	result.m_maxs = Vec3(fmaxf(boundsA.m_maxs.x, boundsB.m_maxs.x), fmaxf(boundsA.m_maxs.y, boundsB.m_maxs.y), fmaxf(boundsA.m_maxs.z, boundsB.m_maxs.z));
+	return result;
+}
+
+static float GetSurfaceArea(AABB3 const& bounds)
+{
+	Vec3 dimensions = bounds.m_maxs - bounds.m_mins;
+	return 2.f * (dimensions.x * dimensions.y + dimensions.y * dimensions.z + dimensions.z * dimensions.x);
+}
+
+static bool IsContaining(AABB3 const& outer, AABB3 const& inner)
+{
+	return outer.m_mins.x <= inner.m_mins.x && outer.m_mins.y <= inner.m_mins.y && outer.m_mins.z <= inner.m_mins.z
+		&& outer.m_maxs.x >= inner.m_maxs.x && outer.m_maxs.y >= inner.m_maxs.y && outer.m_maxs.z >= inner.m_maxs.z;
+}
+
+static bool IsOverlapping(AABB3 const& boundsA, AABB3 const& boundsB)
+{
+	return boundsA.m_mins.x <= boundsB.m_maxs.x && boundsA.m_maxs.x >= boundsB.m_mins.x
+		&& boundsA.m_mins.y <= boundsB.m_maxs.y && boundsA.m_maxs.y >= boundsB.m_mins.y
+		&& boundsA.m_mins.z <= boundsB.m_maxs.z && boundsA.m_maxs.z >= boundsB.m_mins.z;
+}
+
+//-----------------------------------------------------------------------------------------------
+AABBTree3D::AABBTree3D(float fatMargin)
+	: m_fatMargin(fatMargin)
+{
+}
+
+void AABBTree3D::Clear()
+{
+	m_nodes.clear();
+	m_rootIndex = -1;
+	m_freeListIndex = -1;
+	m_numProxies = 0;
+}
+
+int AABBTree3D::CreateProxy(AABB3 const& tightBounds, int userIndex)
+{
+	int proxyId = AllocateNode();
+	AABBTreeNode3D& node = m_nodes[proxyId];
+	Vec3 margin = Vec3(m_fatMargin, m_fatMargin, m_fatMargin);
+	node.m_bounds = AABB3(tightBounds.m_mins - margin, tightBounds.m_maxs + margin);
+	node.m_userIndex = userIndex;
+	node.m_height = 0;
+
+	InsertLeaf(proxyId);
+	++m_numProxies;
+	return proxyId;
+}
+
+void AABBTree3D::DestroyProxy(int proxyId)
+{
+	GUARANTEE_OR_DIE(proxyId >= 0 && proxyId < (int)m_nodes.size() && m_nodes[proxyId].IsLeaf(), "Invalid AABBTree3D proxy!");
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+	--m_numProxies;
+}
+
+bool AABBTree3D::MoveProxy(int proxyId, AABB3 const& tightBounds)
+{
+	GUARANTEE_OR_DIE(proxyId >= 0 && proxyId < (int)m_nodes.size() && m_nodes[proxyId].IsLeaf(), "Invalid AABBTree3D proxy!");
+	if (IsContaining(m_nodes[proxyId].m_bounds, tightBounds))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxyId);
+	Vec3 margin = Vec3(m_fatMargin, m_fatMargin, m_fatMargin);
+	m_nodes[proxyId].m_bounds = AABB3(tightBounds.m_mins - margin, tightBounds.m_maxs + margin);
+	InsertLeaf(proxyId);
+	return true;
+}
+
+int AABBTree3D::GetUserIndex(int proxyId) const
+{
+	return m_nodes[proxyId].m_userIndex;
+}
+
+AABB3 const& AABBTree3D::GetFatBounds(int proxyId) const
+{
+	return m_nodes[proxyId].m_bounds;
+}
+
+int AABBTree3D::GetHeight() const
+{
+	return (m_rootIndex == -1) ? 0 : m_nodes[m_rootIndex].m_height;
+}
+
+int AABBTree3D::GetNumProxies() const
+{
+	return m_numProxies;
+}
+
+void AABBTree3D::QueryOverlappingPairs(std::vector<std::pair<int, int>>& out_userIndexPairs) const
+{
+	if (m_rootIndex == -1)
+	{
+		return;
+	}
+	QuerySelfPairs(m_rootIndex, out_userIndexPairs);
+}
+
+void AABBTree3D::QueryPlane(Plane3 const& plane, std::vector<int>& out_userIndexes) const
+{
+	if (m_rootIndex == -1)
+	{
+		return;
+	}
+
+	std::vector<int> stack;
+	stack.reserve(64);
+	stack.push_back(m_rootIndex);
+	while (!stack.empty())
+	{
+		int nodeIndex = stack.back();
+		stack.pop_back();
+
+		AABBTreeNode3D const& node = m_nodes[nodeIndex];
+		if (!DoAABBAndPlaneOverlap3D(node.m_bounds, plane))
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			out_userIndexes.push_back(node.m_userIndex);
+		}
+		else
+		{
+			stack.push_back(node.m_childA);
+			stack.push_back(node.m_childB);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+int AABBTree3D::AllocateNode()
+{
+	if (m_freeListIndex == -1)
+	{
+		m_nodes.emplace_back();
+		return (int)m_nodes.size() - 1;
+	}
+
+	int nodeIndex = m_freeListIndex;
+	m_freeListIndex = m_nodes[nodeIndex].m_parent;
+	m_nodes[nodeIndex] = AABBTreeNode3D();
+	return nodeIndex;
+}
+
+void AABBTree3D::FreeNode(int nodeIndex)
+{
+	m_nodes[nodeIndex].m_parent = m_freeListIndex;
+	m_nodes[nodeIndex].m_height = -1;
+	m_freeListIndex = nodeIndex;
+}
+
+void AABBTree3D::InsertLeaf(int leafIndex)
+{
+	if (m_rootIndex == -1)
+	{
+		m_rootIndex = leafIndex;
+		m_nodes[leafIndex].m_parent = -1;
+		return;
+	}
+
+	// Find the best sibling with the surface area heuristic
+	AABB3 leafBounds = m_nodes[leafIndex].m_bounds;
+	int siblingIndex = m_rootIndex;
+	while (!m_nodes[siblingIndex].IsLeaf())
+	{
+		AABBTreeNode3D const& node = m_nodes[siblingIndex];
+		float area = GetSurfaceArea(node.m_bounds);
+		float combinedArea = GetSurfaceArea(GetUnion(node.m_bounds, leafBounds));
+
+		// Cost of creating a new parent for this node and the new leaf
+		float cost = 2.f * combinedArea;
+		// Minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.f * (combinedArea - area);
+
+		AABBTreeNode3D const& childA = m_nodes[node.m_childA];
+		float costA = GetSurfaceArea(GetUnion(childA.m_bounds, leafBounds)) + inheritanceCost;
+		if (!childA.IsLeaf())
+		{
+			costA -= GetSurfaceArea(childA.m_bounds);
+		}
+		AABBTreeNode3D const& childB = m_nodes[node.m_childB];
+		float costB = GetSurfaceArea(GetUnion(childB.m_bounds, leafBounds)) + inheritanceCost;
+		if (!childB.IsLeaf())
+		{
+			costB -= GetSurfaceArea(childB.m_bounds);
+		}
+
+		if (cost < costA && cost < costB)
+		{
+			break;
+		}
+		siblingIndex = (costA < costB) ? node.m_childA : node.m_childB;
+	}
+
+	// Create a new parent for the sibling and the leaf
+	int oldParentIndex = m_nodes[siblingIndex].m_parent;
+	int newParentIndex = AllocateNode();
+	AABBTreeNode3D& newParent = m_nodes[newParentIndex];
+	newParent.m_parent = oldParentIndex;
+	newParent.m_bounds = GetUnion(leafBounds, m_nodes[siblingIndex].m_bounds);
+	newParent.m_height = m_nodes[siblingIndex].m_height + 1;
+	newParent.m_childA = siblingIndex;
+	newParent.m_childB = leafIndex;
+	m_nodes[siblingIndex].m_parent = newParentIndex;
+	m_nodes[leafIndex].m_parent = newParentIndex;
+
+	if (oldParentIndex == -1)
+	{
+		m_rootIndex = newParentIndex;
+	}
+	else if (m_nodes[oldParentIndex].m_childA == siblingIndex)
+	{
+		m_nodes[oldParentIndex].m_childA = newParentIndex;
+	}
+	else
+	{
+		m_nodes[oldParentIndex].m_childB = newParentIndex;
+	}
+
+	// Walk back up, rebalancing and refitting the ancestors
+	int nodeIndex = m_nodes[leafIndex].m_parent;
+	while (nodeIndex != -1)
+	{
+		nodeIndex = Balance(nodeIndex);
+
+		AABBTreeNode3D& node = m_nodes[nodeIndex];
+		AABBTreeNode3D const& childA = m_nodes[node.m_childA];
+		AABBTreeNode3D const& childB = m_nodes[node.m_childB];
+		node.m_height = 1 + (childA.m_height > childB.m_height ? childA.m_height : childB.m_height);
+		node.m_bounds = GetUnion(childA.m_bounds, childB.m_bounds);
+
+		nodeIndex = node.m_parent;
+	}
+}
+
+void AABBTree3D::RemoveLeaf(int leafIndex)
+{
+	if (leafIndex == m_rootIndex)
+	{
+		m_rootIndex = -1;
+		return;
+	}
+
+	int parentIndex = m_nodes[leafIndex].m_parent;
+	int grandParentIndex = m_nodes[parentIndex].m_parent;
+	int siblingIndex = (m_nodes[parentIndex].m_childA == leafIndex) ? m_nodes[parentIndex].m_childB : m_nodes[parentIndex].m_childA;
+
+	if (grandParentIndex == -1)
+	{
+		m_rootIndex = siblingIndex;
+		m_nodes[siblingIndex].m_parent = -1;
+		FreeNode(parentIndex);
+		return;
+	}
+
+	// Replace the parent with the sibling, then refit the ancestors
+	if (m_nodes[grandParentIndex].m_childA == parentIndex)
+	{
+		m_nodes[grandParentIndex].m_childA = siblingIndex;
+	}
+	else
+	{
+		m_nodes[grandParentIndex].m_childB = siblingIndex;
+	}
+	m_nodes[siblingIndex].m_parent = grandParentIndex;
+	FreeNode(parentIndex);
+
+	int nodeIndex = grandParentIndex;
+	while (nodeIndex != -1)
+	{
+		nodeIndex = Balance(nodeIndex);
+
+		AABBTreeNode3D& node = m_nodes[nodeIndex];
+		AABBTreeNode3D const& childA = m_nodes[node.m_childA];
+		AABBTreeNode3D const& childB = m_nodes[node.m_childB];
+		node.m_height = 1 + (childA.m_height > childB.m_height ? childA.m_height : childB.m_height);
+		node.m_bounds = GetUnion(childA.m_bounds, childB.m_bounds);
+
+		nodeIndex = node.m_parent;
+	}
+}
+
+int AABBTree3D::Balance(int indexA)
+{
+	// Rotate the taller child C up when the children heights of A differ by more than one
+	// A keeps the shorter child B plus the shorter child of C, C takes A's place
+	AABBTreeNode3D& nodeA = m_nodes[indexA];
+	if (nodeA.IsLeaf() || nodeA.m_height < 2)
+	{
+		return indexA;
+	}
+
+	int indexB = nodeA.m_childA;
+	int indexC = nodeA.m_childB;
+	int balance = m_nodes[indexC].m_height - m_nodes[indexB].m_height;
+
+	if (balance > 1 || balance < -1)
+	{
+		// Make C the taller child, B the shorter one
+		bool isRotatingChildB = balance > 1;
+		if (!isRotatingChildB)
+		{
+			int temp = indexB;
+			indexB = indexC;
+			indexC = temp;
+		}
+
+		AABBTreeNode3D& nodeB = m_nodes[indexB];
+		AABBTreeNode3D& nodeC = m_nodes[indexC];
+		int indexF = nodeC.m_childA;
+		int indexG = nodeC.m_childB;
+		AABBTreeNode3D& nodeF = m_nodes[indexF];
+		AABBTreeNode3D& nodeG = m_nodes[indexG];
+
+		// Swap A and C
+		nodeC.m_childA = indexA;
+		nodeC.m_parent = nodeA.m_parent;
+		nodeA.m_parent = indexC;
+
+		if (nodeC.m_parent == -1)
+		{
+			m_rootIndex = indexC;
+		}
+		else if (m_nodes[nodeC.m_parent].m_childA == indexA)
+		{
+			m_nodes[nodeC.m_parent].m_childA = indexC;
+		}
+		else
+		{
+			m_nodes[nodeC.m_parent].m_childB = indexC;
+		}
+
+		// Keep the taller of F and G under C, hand the other one to A
+		int keptIndex = indexF;
+		int movedIndex = indexG;
+		if (nodeF.m_height <= nodeG.m_height)
+		{
+			keptIndex = indexG;
+			movedIndex = indexF;
+		}
+		nodeC.m_childB = keptIndex;
+		if (isRotatingChildB)
+		{
+			nodeA.m_childB = movedIndex;
+		}
+		else
+		{
+			nodeA.m_childA = movedIndex;
+		}
+		m_nodes[movedIndex].m_parent = indexA;
+
+		nodeA.m_bounds = GetUnion(nodeB.m_bounds, m_nodes[movedIndex].m_bounds);
+		nodeC.m_bounds = GetUnion(nodeA.m_bounds, m_nodes[keptIndex].m_bounds);
+		int heightB = nodeB.m_height;
+		int heightMoved = m_nodes[movedIndex].m_height;
+		int heightKept = m_nodes[keptIndex].m_height;
+		nodeA.m_height = 1 + (heightB > heightMoved ? heightB : heightMoved);
+		nodeC.m_height = 1 + (nodeA.m_height > heightKept ? nodeA.m_height : heightKept);
+
+		return indexC;
+	}
+
+	return indexA;
+}
+
+void AABBTree3D::QuerySelfPairs(int nodeIndex, std::vector<std::pair<int, int>>& out_userIndexPairs) const
+{
+	AABBTreeNode3D const& node = m_nodes[nodeIndex];
+	if (node.IsLeaf())
+	{
+		return;
+	}
+
+	QuerySelfPairs(node.m_childA, out_userIndexPairs);
+	QuerySelfPairs(node.m_childB, out_userIndexPairs);
+	QueryNodePairs(node.m_childA, node.m_childB, out_userIndexPairs);
+}
+
+void AABBTree3D::QueryNodePairs(int nodeIndexA, int nodeIndexB, std::vector<std::pair<int, int>>& out_userIndexPairs) const
+{
+	AABBTreeNode3D const& nodeA = m_nodes[nodeIndexA];
+	AABBTreeNode3D const& nodeB = m_nodes[nodeIndexB];
+	if (!IsOverlapping(nodeA.m_bounds, nodeB.m_bounds))
+	{
+		return;
+	}
+
+	if (nodeA.IsLeaf() && nodeB.IsLeaf())
+	{
+		out_userIndexPairs.emplace_back(nodeA.m_userIndex, nodeB.m_userIndex);
+		return;
+	}
+
+	// Descend into the taller internal node
+	if (nodeB.IsLeaf() || (!nodeA.IsLeaf() && nodeA.m_height >= nodeB.m_height))
+	{
+		QueryNodePairs(nodeA.m_childA, nodeIndexB, out_userIndexPairs);
+		QueryNodePairs(nodeA.m_childB, nodeIndexB, out_userIndexPairs);
+	}
+	else
+	{
+		QueryNodePairs(nodeIndexA, nodeB.m_childA, out_userIndexPairs);
+		QueryNodePairs(nodeIndexA, nodeB.m_childB, out_userIndexPairs);
+	}
+}
+
+Vec3 AABBTree3D::GetSafeInverseDirection(Vec3 const& rayForwardNormal)
+{
+	// Avoid 0 * inf in the slab test when the ray is parallel to an axis
+	constexpr float HUGE_INVERSE = 1e30f;
+	Vec3 inverseDirection;
+	inverseDirection.x = (fabsf(rayForwardNormal.x) > 1e-20f) ? 1.f / rayForwardNormal.x : (rayForwardNormal.x < 0.f ? -HUGE_INVERSE : HUGE_INVERSE);
+	inverseDirection.y = (fabsf(rayForwardNormal.y) > 1e-20f) ? 1.f / rayForwardNormal.y : (rayForwardNormal.y < 0.f ? -HUGE_INVERSE : HUGE_INVERSE);
+	inverseDirection.z = (fabsf(rayForwardNormal.z) > 1e-20f) ? 1.f / rayForwardNormal.z : (rayForwardNormal.z < 0.f ? -HUGE_INVERSE : HUGE_INVERSE);
+	return inverseDirection;
+}
+
+float AABBTree3D::GetDistanceSquaredToBounds(AABB3 const& bounds, Vec3 const& point)
+{
+	float dx = fmaxf(fmaxf(bounds.m_mins.x - point.x, point.x - bounds.m_maxs.x), 0.f);
+	float dy = fmaxf(fmaxf(bounds.m_mins.y - point.y, point.y - bounds.m_maxs.y), 0.f);
+	float dz = fmaxf(fmaxf(bounds.m_mins.z - point.z, point.z - bounds.m_maxs.z), 0.f);
+	return dx * dx + dy * dy + dz * dz;
+}
+
+float AABBTree3D::GetRayEntryDistance(AABB3 const& bounds, Vec3 const& rayStart, Vec3 const& inverseDirection, float maxDist)
+{
+	// Slab test, returns the entry distance (0 if the start is inside) or -1 on a miss
+	float tx1 = (bounds.m_mins.x - rayStart.x) * inverseDirection.x;
+	float tx2 = (bounds.m_maxs.x - rayStart.x) * inverseDirection.x;
+	float ty1 = (bounds.m_mins.y - rayStart.y) * inverseDirection.y;
+	float ty2 = (bounds.m_maxs.y - rayStart.y) * inverseDirection.y;
+	float tz1 = (bounds.m_mins.z - rayStart.z) * inverseDirection.z;
+	float tz2 = (bounds.m_maxs.z - rayStart.z) * inverseDirection.z;
+
+	float entryDist = fmaxf(fmaxf(fminf(tx1, tx2), fminf(ty1, ty2)), fmaxf(fminf(tz1, tz2), 0.f));
+	float exitDist = fminf(fminf(fmaxf(tx1, tx2), fmaxf(ty1, ty2)), fminf(fmaxf(tz1, tz2), maxDist));
+
+	return (entryDist <= exitDist) ? entryDist : -1.f;
+}
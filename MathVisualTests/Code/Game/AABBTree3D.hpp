@@ -0,0 +1,237 @@
+#pragma once
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+struct Plane3;
+
+//-----------------------------------------------------------------------------------------------
+struct AABBTreeNode3D
+{
+	AABB3	m_bounds;
+	int		m_parent	= -1; // next free node while the node is on the free list
+	int		m_childA	= -1;
+	int		m_childB	= -1;
+	int		m_height	= -1; // leaf = 0, free node = -1
+	int		m_userIndex = -1;
+
+	bool IsLeaf() const { return m_childA == -1; }
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Dynamic bounding volume tree over world space AABB3 proxies
+// Leaves keep fattened bounds, so a moving proxy is only reinserted when its tight bounds escape them
+// Shapes without finite bounds (planes) must be kept out of the tree
+class AABBTree3D
+{
+public:
+	AABBTree3D(float fatMargin = 0.1f);
+
+	void Clear();
+	int CreateProxy(AABB3 const& tightBounds, int userIndex);
+	void DestroyProxy(int proxyId);
+	bool MoveProxy(int proxyId, AABB3 const& tightBounds); // returns true if the proxy was reinserted
+
+	int GetUserIndex(int proxyId) const;
+	AABB3 const& GetFatBounds(int proxyId) const;
+	int GetHeight() const;
+	int GetNumProxies() const;
+
+	// leafRaycast(userIndex, closestDistSoFar) returns the impact distance, or a negative value on a miss
+	// Children are visited front to back, subtrees entered beyond the closest impact are skipped
+	template<typename LeafRaycastFunc>
+	void RaycastClosest(Vec3 const& rayStart, Vec3 const& rayForwardNormal, float rayLength, LeafRaycastFunc& leafRaycast) const;
+
+	// leafDistanceSquared(userIndex) returns the squared distance from the point to the shape itself
+	// Nodes are expanded nearest bounds first, anything farther than the best shape so far is pruned
+	// Returns the user index of the nearest shape, or -1 if nothing is within sqrt(inout_bestDistanceSquared)
+	template<typename LeafDistanceFunc>
+	int FindNearest(Vec3 const& point, LeafDistanceFunc& leafDistanceSquared, float& inout_bestDistanceSquared) const;
+
+	// Leaf pairs whose fat bounds overlap, found by descending the tree against itself
+	void QueryOverlappingPairs(std::vector<std::pair<int, int>>& out_userIndexPairs) const;
+	void QueryPlane(Plane3 const& plane, std::vector<int>& out_userIndexes) const;
+
+	// Slab test helpers, also used by leaf callbacks to cull their own tight bounds
+	static Vec3 GetSafeInverseDirection(Vec3 const& rayForwardNormal);
+	static float GetRayEntryDistance(AABB3 const& bounds, Vec3 const& rayStart, Vec3 const& inverseDirection, float maxDist); // -1 on a miss
+
+private:
+	int AllocateNode();
+	void FreeNode(int nodeIndex);
+	void InsertLeaf(int leafIndex);
+	void RemoveLeaf(int leafIndex);
+	int Balance(int nodeIndex);
+
+	void QuerySelfPairs(int nodeIndex, std::vector<std::pair<int, int>>& out_userIndexPairs) const;
+	void QueryNodePairs(int nodeIndexA, int nodeIndexB, std::vector<std::pair<int, int>>& out_userIndexPairs) const;
+
+	static float GetDistanceSquaredToBounds(AABB3 const& bounds, Vec3 const& point);
+
+private:
+	std::vector<AABBTreeNode3D> m_nodes;
+	int		m_rootIndex		= -1;
+	int		m_freeListIndex	= -1;
+	int		m_numProxies	= 0;
+	float	m_fatMargin		= 0.1f;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename LeafRaycastFunc>
+void AABBTree3D::RaycastClosest(Vec3 const& rayStart, Vec3 const& rayForwardNormal, float rayLength, LeafRaycastFunc& leafRaycast) const
+{
+	if (m_rootIndex == -1)
+	{
+		return;
+	}
+
+	Vec3 inverseDirection = GetSafeInverseDirection(rayForwardNormal);
+	float closestDist = rayLength;
+
+	float rootEntryDist = GetRayEntryDistance(m_nodes[m_rootIndex].m_bounds, rayStart, inverseDirection, closestDist);
+	if (rootEntryDist < 0.f)
+	{
+		return;
+	}
+
+	// Tree height stays logarithmic thanks to Balance(), so 64 entries cover millions of leaves.
+	// A tree churned deeper than that before its next Balance() spills into a vector instead of losing nodes.
+	struct StackEntry
+	{
+		int m_nodeIndex;
+		float m_entryDist;
+	};
+	constexpr int INLINE_STACK_SIZE = 64;
+	StackEntry inlineStack[INLINE_STACK_SIZE];
+	int inlineStackSize = 0;
+	std::vector<StackEntry> spilledStack; // entries pushed while the inline stack was full, popped first
+	auto pushEntry = [&](StackEntry const& entry)
+		{
+			if (inlineStackSize < INLINE_STACK_SIZE)
+			{
+				inlineStack[inlineStackSize++] = entry;
+			}
+			else
+			{
+				spilledStack.push_back(entry);
+			}
+		};
+	pushEntry({ m_rootIndex, rootEntryDist });
+
+	while (inlineStackSize > 0 || !spilledStack.empty())
+	{
+		StackEntry entry;
+		if (!spilledStack.empty())
+		{
+			entry = spilledStack.back();
+			spilledStack.pop_back();
+		}
+		else
+		{
+			entry = inlineStack[--inlineStackSize];
+		}
+		if (entry.m_entryDist > closestDist)
+		{
+			continue;
+		}
+
+		AABBTreeNode3D const& node = m_nodes[entry.m_nodeIndex];
+		if (node.IsLeaf())
+		{
+			float impactDist = leafRaycast(node.m_userIndex, closestDist);
+			if (impactDist >= 0.f && impactDist < closestDist)
+			{
+				closestDist = impactDist;
+			}
+			continue;
+		}
+
+		float entryDistA = GetRayEntryDistance(m_nodes[node.m_childA].m_bounds, rayStart, inverseDirection, closestDist);
+		float entryDistB = GetRayEntryDistance(m_nodes[node.m_childB].m_bounds, rayStart, inverseDirection, closestDist);
+
+		// Push the far child first so the near child is popped next
+		StackEntry nearEntry = { node.m_childA, entryDistA };
+		StackEntry farEntry = { node.m_childB, entryDistB };
+		if (entryDistB >= 0.f && (entryDistA < 0.f || entryDistB < entryDistA))
+		{
+			nearEntry = { node.m_childB, entryDistB };
+			farEntry = { node.m_childA, entryDistA };
+		}
+		if (farEntry.m_entryDist >= 0.f)
+		{
+			pushEntry(farEntry);
+		}
+		if (nearEntry.m_entryDist >= 0.f)
+		{
+			pushEntry(nearEntry);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename LeafDistanceFunc>
+int AABBTree3D::FindNearest(Vec3 const& point, LeafDistanceFunc& leafDistanceSquared, float& inout_bestDistanceSquared) const
+{
+	if (m_rootIndex == -1)
+	{
+		return -1;
+	}
+
+	struct QueueEntry
+	{
+		float m_boundsDistanceSquared;
+		int m_nodeIndex;
+
+		bool operator>(QueueEntry const& other) const { return m_boundsDistanceSquared > other.m_boundsDistanceSquared; }
+	};
+
+	// Min heap on the distance to the node bounds, which is a lower bound for every shape below it
+	std::vector<QueueEntry> queue;
+	queue.reserve(64);
+	queue.push_back({ GetDistanceSquaredToBounds(m_nodes[m_rootIndex].m_bounds, point), m_rootIndex });
+
+	int nearestUserIndex = -1;
+	while (!queue.empty())
+	{
+		std::pop_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+		QueueEntry entry = queue.back();
+		queue.pop_back();
+
+		// Everything left in the queue is at least this far away
+		if (entry.m_boundsDistanceSquared >= inout_bestDistanceSquared)
+		{
+			break;
+		}
+
+		AABBTreeNode3D const& node = m_nodes[entry.m_nodeIndex];
+		if (node.IsLeaf())
+		{
+			float distanceSquared = leafDistanceSquared(node.m_userIndex);
+			if (distanceSquared < inout_bestDistanceSquared)
+			{
+				inout_bestDistanceSquared = distanceSquared;
+				nearestUserIndex = node.m_userIndex;
+			}
+			continue;
+		}
+
+		int childIndexes[2] = { node.m_childA, node.m_childB };
+		for (int childIndex : childIndexes)
+		{
+			float boundsDistanceSquared = GetDistanceSquaredToBounds(m_nodes[childIndex].m_bounds, point);
+			if (boundsDistanceSquared < inout_bestDistanceSquared)
+			{
+				queue.push_back({ boundsDistanceSquared, childIndex });
+				std::push_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+			}
+		}
+	}
+
+	return nearestUserIndex;
+}
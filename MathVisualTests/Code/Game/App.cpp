@@ -1,21 +1,17 @@
 #include "Game/App.hpp"
-#include "Game/GameNearestPoint.hpp"
-#include "Game/GameRaycastVsDiscs.hpp"
-#include "Game/GameRaycastVsLineSegments.hpp"
-#include "Game/GameRaycastVsAABBs.hpp"
-#include "Game/Game3DTestShapes.hpp"
-#include "Game/Game2DCurves.hpp"
-#include "Game/Game2DPachinkoMachine.hpp"
-#include "Game/Game2DFastVoxelRaycast.hpp"
-#include "Game/Game2DExposureAvoidance.hpp"
-#include "Game/Game2DFlowField.hpp"
-#include "Game/Game3DQuaternion.hpp"
-#include "Game/Game3DCurves.hpp"
+#include "Game/DrawQueue.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/Game.hpp"
+#include "Game/GameModes.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/DebugRender.hpp"
+#include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/DX11Renderer.hpp"
 #include "Engine/Window/Window.hpp"
 
@@ -26,6 +22,9 @@ Window*			g_theWindow		= nullptr;		// Created and owned by the App
 Renderer*		g_theRenderer	= nullptr;		// Created and owned by the App
 bool			g_isDebugDraw	= false;
 RandomNumberGenerator g_rng;
+FrameArena		g_frameArena;
+DrawQueue		g_drawQueue;
+TextLayoutCache	g_textLayoutCache;
 
 //-----------------------------------------------------------------------------------------------
 bool OnQuitEvent(EventArgs& args)
@@ -46,6 +45,8 @@ App::~App()
 
 void App::Startup()
 {
+	ProfilerStartup();
+
 	// Parse Data/GameConfig.xml
 	LoadGameConfig("Data/GameConfig.xml");
 
@@ -78,6 +79,7 @@ void App::Startup()
 	g_theWindow->Startup();
 	g_theRenderer->Startup();
 	DebugRenderSystemStartup(debugRenderConfig);
+	m_overlayFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 
 	// Initialize game-related stuff: create and start the game
 	g_theEventSystem->SubscribeEventCallbackFunction("Quit", OnQuitEvent);
@@ -106,6 +108,8 @@ void App::Shutdown()
 	g_theInput = nullptr;
 	delete g_theEventSystem;
 	g_theEventSystem = nullptr;
+
+	ProfilerShutdown();
 }
 
 void App::RunMainLoop()
@@ -118,6 +122,9 @@ void App::RunMainLoop()
 
 void App::RunFrame()
 {
+	ProfilerBeginFrame();	// Closes the previous frame's profiler stats
+	PROFILE_ZONE("App::RunFrame");
+
 	Clock::TickSystemClock();
 
 	BeginFrame();			// Engine pre-frame stuff
@@ -133,6 +140,7 @@ void App::HandleQuitRequested()
 
 void App::BeginFrame()
 {
+	PROFILE_ZONE("App::BeginFrame");
 	g_theEventSystem->BeginFrame();
 	g_theInput->BeginFrame();
 	g_theWindow->BeginFrame();
@@ -142,6 +150,7 @@ void App::BeginFrame()
 
 void App::Update()
 {
+	PROFILE_ZONE("App::Update");
 	if (g_theInput->WasKeyJustPressed(KEYCODE_ESCAPE))
 	{
 		g_theApp->HandleQuitRequested();
@@ -157,12 +166,19 @@ void App::Update()
 		delete m_theGame;
 		m_currentGameMode = static_cast<GameMode>((m_currentGameMode + 1) % GAME_MODE_NUM);
 		m_theGame = CreateNewGameForMode(m_currentGameMode);
+		m_benchmarkReport.Clear();
 	}
 	if (g_theInput->WasKeyJustPressed(KEYCODE_F6))
 	{
 		delete m_theGame;
 		m_currentGameMode = static_cast<GameMode>((m_currentGameMode + GAME_MODE_NUM - 1) % GAME_MODE_NUM);
 		m_theGame = CreateNewGameForMode(m_currentGameMode);
+		m_benchmarkReport.Clear();
+	}
+	UpdateProfilerOverlay();
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F9))
+	{
+		RunBenchmarks();
 	}
 
 	// No devconsole in MathVisualTests Now, no need to check g_theDevConsole->GetMode() == DevConsoleMode::HIDDEN
@@ -180,61 +196,107 @@ void App::Update()
 
 void App::Render() const
 {
+	PROFILE_ZONE("App::Render");
 	g_theRenderer->ClearScreen(Rgba8(0, 0, 0));
 	m_theGame->Render();
+
+	if (m_isProfilerOverlayVisible)
+	{
+		DrawProfilerOverlay();
+	}
+	if (!m_benchmarkReport.IsEmpty())
+	{
+		DrawBenchmarkReport();
+	}
 }
 
 void App::EndFrame()
 {
+	PROFILE_ZONE("App::EndFrame");
 	DebugRenderEndFrame();
 	g_theRenderer->EndFrame();
 	g_theWindow->EndFrame();
     g_theInput->EndFrame();
 	g_theEventSystem->EndFrame();
+	g_frameArena.Reset();
+	g_drawQueue.EndFrame();
 }
 
-Game* App::CreateNewGameForMode(GameMode mode)
+void App::UpdateProfilerOverlay()
 {
-	switch (mode)
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F2))
 	{
-	case GAME_MODE_NEAREST_POINT:
-		return new GameNearestPoint();
-		break;
-	case GAME_MODE_RAYCAST_VS_DISCS:
-		return new GameRaycastVsDiscs();
-		break;
-	case GAME_MODE_RAYCAST_VS_LINE_SEGMENTS:
-		return new GameRaycastVsLineSegments();
-		break;
-	case GAME_MODE_RAYCAST_VS_AABBS:
-		return new GameRaycastVsAABBs();
-		break;
-	case GAME_MODE_3D_TEST_SHAPES:
-		return new Game3DTestShapes();
-		break;
-	case GAME_MODE_2D_CURVES:
-		return new Game2DCurves();
-		break;
-	case GAME_MODE_2D_PACHIKO_MACHINE:
-		return new Game2DPachinkoMachine();
-		break;
-	case GAME_MODE_2D_FAST_VOXEL:
-		return new Game2DFastVoxelRaycast();
-		break;
-	case GAME_MODE_2D_EXPOSURE_AVOIDANCE:
-		return new Game2DExposureAvoidance();
-		break;
-	case GAME_MODE_2D_FLOW_FIELD:
-		return new Game2DFlowField();
-		break;
-	case GAME_MODE_3D_QUATERNION:
-		return new Game3DQuaternion();
-		break;
-	case GAME_MODE_3D_CURVES:
-		return new Game3DCurves();
-		break;
+		m_isProfilerOverlayVisible = !m_isProfilerOverlayVisible;
 	}
-	ERROR_AND_DIE("Invalid Game Mode");
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F3))
+	{
+		WriteProfilerChromeTrace("ProfilerTrace.json");
+	}
+	m_profilerCamera.SetOrthoView(Vec2(0.f, 0.f), Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y));
+}
+
+void App::DrawProfilerOverlay() const
+{
+	AABB2 overlayBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.05f, SCREEN_SIZE_X * 0.55f, SCREEN_SIZE_Y * 0.6f);
+	std::vector<Vertex_PCU>& backgroundVerts = g_frameArena.AcquireVertexBuffer();
+	AddVertsForAABB2D(backgroundVerts, overlayBox, Rgba8(0, 0, 0, 180));
+
+	std::vector<Vertex_PCU>& textVerts = g_frameArena.AcquireVertexBuffer();
+	std::string overlayText = "F2 - hide profiler, F3 - dump ProfilerTrace.json (chrome://tracing)\n" + GetProfilerStatsReport();
+	overlayText += Stringf("Frame arena: %.1f KB last frame in %d vertex buffers, %.1f KB peak, %.1f KB reserved\n",
+		g_frameArena.GetLastFrameBytes() / 1024.f, g_frameArena.GetLastFrameVertexBufferCount(), g_frameArena.GetPeakFrameBytes() / 1024.f, g_frameArena.GetReservedBytes() / 1024.f);
+	DrawQueueStats const& drawQueueStats = g_drawQueue.GetLastFrameStats();
+	overlayText += Stringf("Draw queue: %d submits in %d draws, %d draws and %d state calls saved\n",
+		drawQueueStats.m_numSubmits, drawQueueStats.m_numDrawCalls, drawQueueStats.GetNumDrawCallsSaved(), drawQueueStats.GetNumStateCallsSaved());
+	overlayText += Stringf("Text layout cache: %d hits, %d misses\n", g_textLayoutCache.GetNumHits(), g_textLayoutCache.GetNumMisses());
+	m_overlayFont->AddVertsForTextInBox2D(textVerts, overlayText, overlayBox, 12.f, Rgba8::OPAQUE_WHITE, 0.6f, Vec2(0.f, 1.f), TextBoxMode::SHRINK_TO_FIT);
+
+	g_theRenderer->BeginCamera(m_profilerCamera);
+	g_theRenderer->BindShader(nullptr);
+	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
+	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetDepthMode(DepthMode::DISABLED);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->DrawVertexArray(backgroundVerts);
+	g_theRenderer->BindTexture(&m_overlayFont->GetTexture());
+	g_theRenderer->DrawVertexArray(textVerts);
+	g_theRenderer->EndCamera(m_profilerCamera);
+}
+
+void App::RunBenchmarks()
+{
+	// Blocks the frame on purpose, the benchmarks take from a few milliseconds to a few seconds
+	m_benchmarkReport.Clear();
+	m_theGame->RunBenchmarks(m_benchmarkReport);
+	if (m_benchmarkReport.IsEmpty())
+	{
+		m_benchmarkReport.AddLine("No benchmarks in this mode");
+	}
+	DebuggerPrintf("%s", m_benchmarkReport.GetText().c_str());
+}
+
+void App::DrawBenchmarkReport() const
+{
+	AABB2 reportBox(SCREEN_SIZE_X * 0.56f, SCREEN_SIZE_Y * 0.05f, SCREEN_SIZE_X * 0.995f, SCREEN_SIZE_Y * 0.6f);
+	std::vector<Vertex_PCU>& backgroundVerts = g_frameArena.AcquireVertexBuffer();
+	AddVertsForAABB2D(backgroundVerts, reportBox, Rgba8(0, 0, 0, 180));
+
+	std::vector<Vertex_PCU>& textVerts = g_frameArena.AcquireVertexBuffer();
+	std::string reportText = "F9 - rerun benchmarks\n" + m_benchmarkReport.GetText();
+	g_textLayoutCache.AddVertsForTextInBox2D(textVerts, *m_overlayFont, reportText, reportBox, 12.f, Rgba8::OPAQUE_WHITE, 0.6f, Vec2(0.f, 1.f), TextBoxMode::SHRINK_TO_FIT);
+
+	g_theRenderer->BeginCamera(m_profilerCamera);
+	g_theRenderer->BindShader(nullptr);
+	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
+	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetDepthMode(DepthMode::DISABLED);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->DrawVertexArray(backgroundVerts);
+	g_theRenderer->BindTexture(&m_overlayFont->GetTexture());
+	g_theRenderer->DrawVertexArray(textVerts);
+	g_theRenderer->EndCamera(m_profilerCamera);
 }
 
 void App::LoadGameConfig(char const* gameConfigXmlFilePath)
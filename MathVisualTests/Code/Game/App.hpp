@@ -1,7 +1,10 @@
 #pragma once
+#include "Game/Benchmark.hpp"
 #include "Game/GameCommon.hpp"
+#include "Engine/Renderer/Camera.hpp"
 
 //-----------------------------------------------------------------------------------------------
+class BitmapFont;
 class Game;
 
 //-----------------------------------------------------------------------------------------------
@@ -23,11 +26,21 @@ private:
     void Update();
     void Render() const;
     void EndFrame();
+
+    void UpdateProfilerOverlay();
+    void DrawProfilerOverlay() const;
+    void RunBenchmarks();
+    void DrawBenchmarkReport() const;
     
     void LoadGameConfig(char const* gameConfigXmlFilePath);
-    Game* CreateNewGameForMode(GameMode mode);
 private:
     GameMode m_currentGameMode = GAME_MODE_3D_CURVES;
 	Game* m_theGame = nullptr;
     bool m_isQuitting = false;
+
+    bool m_isProfilerOverlayVisible = false;
+    Camera m_profilerCamera;
+    BitmapFont* m_overlayFont = nullptr; // looked up once in Startup, not every overlay frame
+
+    BenchmarkReport m_benchmarkReport; // results of the last F9 in the current mode
 };
@@ -0,0 +1,214 @@
+#include "Game/BVH2D.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <cfloat>
+
+//-----------------------------------------------------------------------------------------------
+static constexpr int	BVH_NUM_BINS = 16;
+static constexpr int	BVH_MAX_LEAF_PRIMITIVES = 4;
+static constexpr int	BVH_MAX_SAH_DEPTH = 32;		// median splits below this, at most log2(n) more levels
+static constexpr float	BVH_TRAVERSAL_COST = 1.f;	// relative to one primitive test
+
+static AABB2 GetUnion(AABB2 const& boundsA, AABB2 const& boundsB)
+{
+	return AABB2(fminf(boundsA.m_mins.x, boundsB.m_mins.x), fminf(boundsA.m_mins.y, boundsB.m_mins.y),
+		fmaxf(boundsA.m_maxs.x, boundsB.m_maxs.x), fmaxf(boundsA.m_maxs.y, boundsB.m_maxs.y));
+}
+
+static float GetHalfPerimeter(AABB2 const& bounds)
+{
+	// A ray crosses a 2D box with probability proportional to its perimeter
+	return (bounds.m_maxs.x - bounds.m_mins.x) + (bounds.m_maxs.y - bounds.m_mins.y);
+}
+
+static AABB2 GetEmptyBounds()
+{
+	return AABB2(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+}
+
+//-----------------------------------------------------------------------------------------------
+void BVH2D::Clear()
+{
+	m_nodes.clear();
+	m_primitiveIndexes.clear();
+	m_depth = 0;
+}
+
+void BVH2D::Build(std::vector<AABB2> const& primitiveBounds)
+{
+	Clear();
+	int numPrimitives = (int)primitiveBounds.size();
+	if (numPrimitives == 0)
+	{
+		return;
+	}
+
+	std::vector<Vec2> centroids(numPrimitives);
+	m_primitiveIndexes.resize(numPrimitives);
+	for (int primitiveIndex = 0; primitiveIndex < numPrimitives; ++primitiveIndex)
+	{
+		AABB2 const& bounds = primitiveBounds[primitiveIndex];
+		centroids[primitiveIndex] = (bounds.m_mins + bounds.m_maxs) * 0.5f;
+		m_primitiveIndexes[primitiveIndex] = primitiveIndex;
+	}
+	m_nodes.reserve(2 * numPrimitives / BVH_MAX_LEAF_PRIMITIVES + 1);
+
+	// Depth first with an explicit stack: the first child is always built right after its parent,
+	// the second child patches its index into the parent once it is reached
+	struct BuildTask
+	{
+		int m_firstIndex;
+		int m_endIndex;
+		int m_parentIndex;
+		int m_depth;
+	};
+	std::vector<BuildTask> tasks;
+	tasks.push_back({ 0, numPrimitives, -1, 0 });
+
+	while (!tasks.empty())
+	{
+		BuildTask task = tasks.back();
+		tasks.pop_back();
+
+		int nodeIndex = (int)m_nodes.size();
+		m_nodes.emplace_back();
+		if (task.m_parentIndex != -1 && task.m_parentIndex != nodeIndex - 1)
+		{
+			m_nodes[task.m_parentIndex].m_offset = nodeIndex;
+		}
+		m_depth = (task.m_depth > m_depth) ? task.m_depth : m_depth;
+
+		AABB2 bounds = GetEmptyBounds();
+		AABB2 centroidBounds = GetEmptyBounds();
+		for (int listIndex = task.m_firstIndex; listIndex < task.m_endIndex; ++listIndex)
+		{
+			int primitiveIndex = m_primitiveIndexes[listIndex];
+			bounds = GetUnion(bounds, primitiveBounds[primitiveIndex]);
+			centroidBounds = GetUnion(centroidBounds, AABB2(centroids[primitiveIndex], centroids[primitiveIndex]));
+		}
+		m_nodes[nodeIndex].m_bounds = bounds;
+
+		int count = task.m_endIndex - task.m_firstIndex;
+		Vec2 centroidExtent = centroidBounds.m_maxs - centroidBounds.m_mins;
+		int axis = (centroidExtent.x >= centroidExtent.y) ? 0 : 1;
+		float axisMin = (axis == 0) ? centroidBounds.m_mins.x : centroidBounds.m_mins.y;
+		float axisExtent = (axis == 0) ? centroidExtent.x : centroidExtent.y;
+		if (count <= BVH_MAX_LEAF_PRIMITIVES || axisExtent <= 0.f)
+		{
+			m_nodes[nodeIndex].m_offset = task.m_firstIndex;
+			m_nodes[nodeIndex].m_numPrimitives = count;
+			continue;
+		}
+
+		auto getAxisValue = [axis](Vec2 const& point) { return (axis == 0) ? point.x : point.y; };
+		int* listBegin = m_primitiveIndexes.data() + task.m_firstIndex;
+		int* listEnd = m_primitiveIndexes.data() + task.m_endIndex;
+		int splitIndex = -1;
+
+		if (task.m_depth < BVH_MAX_SAH_DEPTH)
+		{
+			// Bin centroids along the widest axis, then sweep the bins from both sides for the split costs
+			int binCounts[BVH_NUM_BINS] = {};
+			AABB2 binBounds[BVH_NUM_BINS];
+			for (int binIndex = 0; binIndex < BVH_NUM_BINS; ++binIndex)
+			{
+				binBounds[binIndex] = GetEmptyBounds();
+			}
+			float binScale = static_cast<float>(BVH_NUM_BINS) / axisExtent;
+			auto getBinIndex = [&](int primitiveIndex)
+				{
+					int binIndex = static_cast<int>((getAxisValue(centroids[primitiveIndex]) - axisMin) * binScale);
+					return (binIndex < BVH_NUM_BINS) ? binIndex : BVH_NUM_BINS - 1;
+				};
+			for (int* listEntry = listBegin; listEntry != listEnd; ++listEntry)
+			{
+				int binIndex = getBinIndex(*listEntry);
+				++binCounts[binIndex];
+				binBounds[binIndex] = GetUnion(binBounds[binIndex], primitiveBounds[*listEntry]);
+			}
+
+			float rightCosts[BVH_NUM_BINS] = {};
+			AABB2 rightBounds = GetEmptyBounds();
+			int rightCount = 0;
+			for (int binIndex = BVH_NUM_BINS - 1; binIndex > 0; --binIndex)
+			{
+				rightBounds = GetUnion(rightBounds, binBounds[binIndex]);
+				rightCount += binCounts[binIndex];
+				rightCosts[binIndex] = (rightCount > 0) ? static_cast<float>(rightCount) * GetHalfPerimeter(rightBounds) : 0.f;
+			}
+
+			float bestCost = FLT_MAX;
+			int bestSplitBin = -1;
+			AABB2 leftBounds = GetEmptyBounds();
+			int leftCount = 0;
+			for (int binIndex = 1; binIndex < BVH_NUM_BINS; ++binIndex)
+			{
+				leftBounds = GetUnion(leftBounds, binBounds[binIndex - 1]);
+				leftCount += binCounts[binIndex - 1];
+				if (leftCount == 0 || leftCount == count)
+				{
+					continue;
+				}
+				float cost = static_cast<float>(leftCount) * GetHalfPerimeter(leftBounds) + rightCosts[binIndex];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestSplitBin = binIndex;
+				}
+			}
+
+			float nodeHalfPerimeter = GetHalfPerimeter(bounds);
+			float splitCost = BVH_TRAVERSAL_COST + ((nodeHalfPerimeter > 0.f) ? bestCost / nodeHalfPerimeter : 0.f);
+			if (bestSplitBin == -1 || splitCost >= static_cast<float>(count))
+			{
+				m_nodes[nodeIndex].m_offset = task.m_firstIndex;
+				m_nodes[nodeIndex].m_numPrimitives = count;
+				continue;
+			}
+
+			int* splitEntry = std::partition(listBegin, listEnd, [&](int primitiveIndex) { return getBinIndex(primitiveIndex) < bestSplitBin; });
+			splitIndex = task.m_firstIndex + static_cast<int>(splitEntry - listBegin);
+		}
+		else
+		{
+			int* middleEntry = listBegin + count / 2;
+			std::nth_element(listBegin, middleEntry, listEnd, [&](int primitiveIndexA, int primitiveIndexB)
+				{
+					return getAxisValue(centroids[primitiveIndexA]) < getAxisValue(centroids[primitiveIndexB]);
+				});
+			splitIndex = task.m_firstIndex + count / 2;
+		}
+
+		// Second child first on the stack, so the first child is popped (and placed) next
+		tasks.push_back({ splitIndex, task.m_endIndex, nodeIndex, task.m_depth + 1 });
+		tasks.push_back({ task.m_firstIndex, splitIndex, nodeIndex, task.m_depth + 1 });
+	}
+
+	GUARANTEE_OR_DIE(m_depth < 64, "BVH2D is too deep for the traversal stack!");
+}
+
+//-----------------------------------------------------------------------------------------------
+Vec2 BVH2D::GetSafeInverseDirection(Vec2 const& rayForwardNormal)
+{
+	// Avoid 0 * inf in the slab test when the ray is parallel to an axis
+	constexpr float HUGE_INVERSE = 1e30f;
+	Vec2 inverseDirection;
+	inverseDirection.x = (fabsf(rayForwardNormal.x) > 1e-20f) ? 1.f / rayForwardNormal.x : (rayForwardNormal.x < 0.f ? -HUGE_INVERSE : HUGE_INVERSE);
+	inverseDirection.y = (fabsf(rayForwardNormal.y) > 1e-20f) ? 1.f / rayForwardNormal.y : (rayForwardNormal.y < 0.f ? -HUGE_INVERSE : HUGE_INVERSE);
+	return inverseDirection;
+}
+
+float BVH2D::GetRayEntryDistance(AABB2 const& bounds, Vec2 const& rayStart, Vec2 const& inverseDirection, float maxDist)
+{
+	// Slab test, returns the entry distance (0 if the start is inside) or -1 on a miss
+	float tx1 = (bounds.m_mins.x - rayStart.x) * inverseDirection.x;
+	float tx2 = (bounds.m_maxs.x - rayStart.x) * inverseDirection.x;
+	float ty1 = (bounds.m_mins.y - rayStart.y) * inverseDirection.y;
+	float ty2 = (bounds.m_maxs.y - rayStart.y) * inverseDirection.y;
+
+	float entryDist = fmaxf(fmaxf(fminf(tx1, tx2), fminf(ty1, ty2)), 0.f);
+	float exitDist = fminf(fminf(fmaxf(tx1, tx2), fmaxf(ty1, ty2)), maxDist);
+
+	return (entryDist <= exitDist) ? entryDist : -1.f;
+}
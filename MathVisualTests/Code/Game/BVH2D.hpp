@@ -0,0 +1,162 @@
+#pragma once
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Depth first node order: an interior node's first child is the next node in the array
+struct BVHNode2D
+{
+	AABB2	m_bounds;
+	int		m_offset = 0;			// first entry in the primitive index list for leaves, second child for interior nodes
+	int		m_numPrimitives = 0;	// 0 for interior nodes
+
+	bool IsLeaf() const { return m_numPrimitives > 0; }
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Static bounding volume hierarchy over 2D primitive bounds, built top down with a binned
+// surface area heuristic (perimeter in 2D) and flattened into one contiguous node array.
+// Rebuild whenever the primitives change.
+class BVH2D
+{
+public:
+	void Build(std::vector<AABB2> const& primitiveBounds);
+	void Clear();
+
+	int GetNumNodes() const { return (int)m_nodes.size(); }
+	int GetDepth() const { return m_depth; }
+
+	// leafRaycast(primitiveIndex, closestDistSoFar) returns the impact distance, or a negative value on a miss
+	// Children are visited front to back, nodes entered beyond the closest impact are skipped
+	template<typename LeafRaycastFunc>
+	void RaycastClosest(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength, LeafRaycastFunc& leafRaycast) const;
+
+	// leafHit(primitiveIndex) returns true on any impact within the ray length, the query stops at the first one
+	template<typename LeafHitFunc>
+	bool RaycastAny(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength, LeafHitFunc& leafHit) const;
+
+private:
+	static Vec2 GetSafeInverseDirection(Vec2 const& rayForwardNormal);
+	static float GetRayEntryDistance(AABB2 const& bounds, Vec2 const& rayStart, Vec2 const& inverseDirection, float maxDist);
+
+	template<typename NodeFunc>
+	void TraverseFrontToBack(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float& inout_maxDist, NodeFunc& visitLeaf) const;
+
+private:
+	std::vector<BVHNode2D> m_nodes;
+	std::vector<int> m_primitiveIndexes; // leaves reference contiguous runs of this list
+	int m_depth = 0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename NodeFunc>
+void BVH2D::TraverseFrontToBack(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float& inout_maxDist, NodeFunc& visitLeaf) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	Vec2 inverseDirection = GetSafeInverseDirection(rayForwardNormal);
+	float rootEntryDist = GetRayEntryDistance(m_nodes[0].m_bounds, rayStart, inverseDirection, inout_maxDist);
+	if (rootEntryDist < 0.f)
+	{
+		return;
+	}
+
+	// Build() keeps the depth under 64, so a fixed stack always fits
+	struct StackEntry
+	{
+		int m_nodeIndex;
+		float m_entryDist;
+	};
+	StackEntry stack[64];
+	int stackSize = 0;
+	stack[stackSize++] = { 0, rootEntryDist };
+
+	while (stackSize > 0)
+	{
+		StackEntry entry = stack[--stackSize];
+		if (entry.m_entryDist > inout_maxDist)
+		{
+			continue;
+		}
+
+		BVHNode2D const& node = m_nodes[entry.m_nodeIndex];
+		if (node.IsLeaf())
+		{
+			// visitLeaf returns false to stop the whole query
+			if (!visitLeaf(node))
+			{
+				return;
+			}
+			continue;
+		}
+
+		int childIndexA = entry.m_nodeIndex + 1;
+		int childIndexB = node.m_offset;
+		float entryDistA = GetRayEntryDistance(m_nodes[childIndexA].m_bounds, rayStart, inverseDirection, inout_maxDist);
+		float entryDistB = GetRayEntryDistance(m_nodes[childIndexB].m_bounds, rayStart, inverseDirection, inout_maxDist);
+
+		// Push the far child first so the near child is popped next
+		StackEntry nearEntry = { childIndexA, entryDistA };
+		StackEntry farEntry = { childIndexB, entryDistB };
+		if (entryDistB >= 0.f && (entryDistA < 0.f || entryDistB < entryDistA))
+		{
+			nearEntry = { childIndexB, entryDistB };
+			farEntry = { childIndexA, entryDistA };
+		}
+		if (farEntry.m_entryDist >= 0.f)
+		{
+			stack[stackSize++] = farEntry;
+		}
+		if (nearEntry.m_entryDist >= 0.f)
+		{
+			stack[stackSize++] = nearEntry;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+template<typename LeafRaycastFunc>
+void BVH2D::RaycastClosest(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength, LeafRaycastFunc& leafRaycast) const
+{
+	float closestDist = rayLength;
+	auto visitLeaf = [&](BVHNode2D const& leaf)
+		{
+			for (int listIndex = leaf.m_offset; listIndex < leaf.m_offset + leaf.m_numPrimitives; ++listIndex)
+			{
+				float impactDist = leafRaycast(m_primitiveIndexes[listIndex], closestDist);
+				if (impactDist >= 0.f && impactDist < closestDist)
+				{
+					closestDist = impactDist;
+				}
+			}
+			return true;
+		};
+	TraverseFrontToBack(rayStart, rayForwardNormal, closestDist, visitLeaf);
+}
+
+template<typename LeafHitFunc>
+bool BVH2D::RaycastAny(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength, LeafHitFunc& leafHit) const
+{
+	bool didImpact = false;
+	float maxDist = rayLength;
+	auto visitLeaf = [&](BVHNode2D const& leaf)
+		{
+			for (int listIndex = leaf.m_offset; listIndex < leaf.m_offset + leaf.m_numPrimitives; ++listIndex)
+			{
+				if (leafHit(m_primitiveIndexes[listIndex]))
+				{
+					didImpact = true;
+					return false;
+				}
+			}
+			return true;
+		};
+	TraverseFrontToBack(rayStart, rayForwardNormal, maxDist, visitLeaf);
+	return didImpact;
+}
@@ -0,0 +1,50 @@
+#include "Game/Benchmark.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+BenchmarkTimer::BenchmarkTimer()
+{
+	Restart();
+}
+
+void BenchmarkTimer::Restart()
+{
+	m_startTime = std::chrono::steady_clock::now();
+}
+
+double BenchmarkTimer::GetElapsedSeconds() const
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+}
+
+double BenchmarkTimer::GetElapsedMilliseconds() const
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_startTime).count();
+}
+
+double BenchmarkTimer::GetElapsedNanoseconds() const
+{
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_startTime).count();
+}
+
+//-----------------------------------------------------------------------------------------------
+void BenchmarkReport::AddSection(std::string const& title)
+{
+	if (!m_text.empty())
+	{
+		m_text += '\n';
+	}
+	m_text += title;
+	m_text += ":\n";
+}
+
+void BenchmarkReport::AddLine(std::string const& line)
+{
+	m_text += line;
+	m_text += '\n';
+}
+
+void BenchmarkReport::Clear()
+{
+	m_text.clear();
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+//-----------------------------------------------------------------------------------------------
+// Shared pieces for the per-mode benchmarks. App runs Game::RunBenchmarks() on F9 and the headless
+// runner on --benchmark; both hand in one BenchmarkReport, so the modes only time and fill lines.
+//
+// Wall clock on purpose: the benchmarks compare kernels against each other, not against the frame.
+class BenchmarkTimer
+{
+public:
+	BenchmarkTimer();
+	void Restart();
+	double GetElapsedSeconds() const;
+	double GetElapsedMilliseconds() const;
+	double GetElapsedNanoseconds() const;
+
+private:
+	std::chrono::steady_clock::time_point m_startTime;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+class BenchmarkReport
+{
+public:
+	void AddSection(std::string const& title); // starts a "title:" block, blank line before all but the first
+	void AddLine(std::string const& line);
+
+	std::string const& GetText() const { return m_text; }
+	bool IsEmpty() const { return m_text.empty(); }
+	void Clear();
+
+private:
+	std::string m_text;
+};
@@ -0,0 +1,163 @@
+#include "Game/DrawQueue.hpp"
+#include "Game/GameCommon.hpp"
+#include <algorithm>
+#include <functional>
+
+//-----------------------------------------------------------------------------------------------
+constexpr int RENDER_STATE_CALLS_PER_ITEM = 6; // texture, shader, blend, sampler, rasterizer, depth
+
+
+//-----------------------------------------------------------------------------------------------
+bool RenderStateKey::operator==(RenderStateKey const& compare) const
+{
+	return m_texture == compare.m_texture && m_shader == compare.m_shader && m_blendMode == compare.m_blendMode
+		&& m_samplerMode == compare.m_samplerMode && m_rasterizerMode == compare.m_rasterizerMode && m_depthMode == compare.m_depthMode;
+}
+
+bool RenderStateKey::operator<(RenderStateKey const& compare) const
+{
+	// Texture and shader first, the most expensive to switch
+	if (m_texture != compare.m_texture)
+	{
+		return std::less<Texture const*>()(m_texture, compare.m_texture);
+	}
+	if (m_shader != compare.m_shader)
+	{
+		return std::less<Shader*>()(m_shader, compare.m_shader);
+	}
+	if (m_blendMode != compare.m_blendMode)
+	{
+		return m_blendMode < compare.m_blendMode;
+	}
+	if (m_samplerMode != compare.m_samplerMode)
+	{
+		return m_samplerMode < compare.m_samplerMode;
+	}
+	if (m_rasterizerMode != compare.m_rasterizerMode)
+	{
+		return m_rasterizerMode < compare.m_rasterizerMode;
+	}
+	return m_depthMode < compare.m_depthMode;
+}
+
+int DrawQueueStats::GetNumStateCallsSaved() const
+{
+	return m_numSubmits * RENDER_STATE_CALLS_PER_ITEM - m_numStateCalls;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void DrawQueue::Submit(RenderStateKey const& state, std::vector<Vertex_PCU> const& verts)
+{
+	Submit(state, static_cast<int>(verts.size()), verts.data());
+}
+
+void DrawQueue::Submit(RenderStateKey const& state, int numVerts, Vertex_PCU const* verts)
+{
+	if (numVerts <= 0)
+	{
+		return;
+	}
+	m_frameStats.m_numSubmits++;
+
+	DrawQueueItem item;
+	item.m_state = state;
+	item.m_firstVertex = static_cast<int>(m_vertices.size());
+	item.m_numVertices = numVerts;
+	m_items.push_back(item);
+	m_vertices.insert(m_vertices.end(), verts, verts + numVerts);
+}
+
+void DrawQueue::Flush(DrawQueueOrder order)
+{
+	if (m_items.empty())
+	{
+		return;
+	}
+
+	// Items in draw order, with their vertices back to back
+	std::vector<Vertex_PCU> const* vertices = &m_vertices;
+	int numItems = static_cast<int>(m_items.size());
+	m_sortedItemIndexes.resize(numItems);
+	for (int itemIndex = 0; itemIndex < numItems; ++itemIndex)
+	{
+		m_sortedItemIndexes[itemIndex] = itemIndex;
+	}
+	if (order == DRAW_QUEUE_ORDER_BY_STATE)
+	{
+		std::stable_sort(m_sortedItemIndexes.begin(), m_sortedItemIndexes.end(),
+			[this](int a, int b) { return m_items[a].m_state < m_items[b].m_state; });
+		m_sortedVertices.clear();
+		for (int itemIndex : m_sortedItemIndexes)
+		{
+			DrawQueueItem& item = m_items[itemIndex];
+			int firstVertex = static_cast<int>(m_sortedVertices.size());
+			m_sortedVertices.insert(m_sortedVertices.end(), m_vertices.begin() + item.m_firstVertex, m_vertices.begin() + item.m_firstVertex + item.m_numVertices);
+			item.m_firstVertex = firstVertex;
+		}
+		vertices = &m_sortedVertices;
+	}
+
+	int runStart = 0;
+	while (runStart < numItems)
+	{
+		DrawQueueItem const& firstItem = m_items[m_sortedItemIndexes[runStart]];
+		int numRunVertices = firstItem.m_numVertices;
+		int runEnd = runStart + 1;
+		while (runEnd < numItems && m_items[m_sortedItemIndexes[runEnd]].m_state == firstItem.m_state)
+		{
+			numRunVertices += m_items[m_sortedItemIndexes[runEnd]].m_numVertices;
+			runEnd++;
+		}
+
+		ApplyState(firstItem.m_state, runStart == 0);
+		g_theRenderer->DrawVertexArray(numRunVertices, vertices->data() + firstItem.m_firstVertex);
+		m_frameStats.m_numDrawCalls++;
+		runStart = runEnd;
+	}
+
+	m_items.clear();
+	m_vertices.clear();
+}
+
+void DrawQueue::EndFrame()
+{
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = DrawQueueStats();
+}
+
+void DrawQueue::ApplyState(RenderStateKey const& state, bool isFirstState)
+{
+	// Code outside the queue may have changed anything since the last flush
+	if (isFirstState || state.m_texture != m_appliedState.m_texture)
+	{
+		g_theRenderer->BindTexture(state.m_texture);
+		m_frameStats.m_numStateCalls++;
+	}
+	if (isFirstState || state.m_shader != m_appliedState.m_shader)
+	{
+		g_theRenderer->BindShader(state.m_shader);
+		m_frameStats.m_numStateCalls++;
+	}
+	if (isFirstState || state.m_blendMode != m_appliedState.m_blendMode)
+	{
+		g_theRenderer->SetBlendMode(state.m_blendMode);
+		m_frameStats.m_numStateCalls++;
+	}
+	if (isFirstState || state.m_samplerMode != m_appliedState.m_samplerMode)
+	{
+		g_theRenderer->SetSamplerMode(state.m_samplerMode);
+		m_frameStats.m_numStateCalls++;
+	}
+	if (isFirstState || state.m_rasterizerMode != m_appliedState.m_rasterizerMode)
+	{
+		g_theRenderer->SetRasterizerMode(state.m_rasterizerMode);
+		m_frameStats.m_numStateCalls++;
+	}
+	if (isFirstState || state.m_depthMode != m_appliedState.m_depthMode)
+	{
+		g_theRenderer->SetDepthMode(state.m_depthMode);
+		m_frameStats.m_numStateCalls++;
+	}
+	m_appliedState = state;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Everything a draw helper sets before DrawVertexArray, defaults are the state the 2D modes use
+struct RenderStateKey
+{
+	Texture const* m_texture = nullptr;
+	Shader* m_shader = nullptr;
+	BlendMode m_blendMode = BlendMode::ALPHA;
+	SamplerMode m_samplerMode = SamplerMode::POINT_CLAMP;
+	RasterizerMode m_rasterizerMode = RasterizerMode::SOLID_CULL_BACK;
+	DepthMode m_depthMode = DepthMode::READ_WRITE_LESS_EQUAL;
+
+	RenderStateKey() = default;
+	explicit RenderStateKey(Texture const* texture) : m_texture(texture) {}
+
+	bool operator==(RenderStateKey const& compare) const;
+	bool operator!=(RenderStateKey const& compare) const { return !(*this == compare); }
+	bool operator<(RenderStateKey const& compare) const;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+enum DrawQueueOrder
+{
+	DRAW_QUEUE_ORDER_SUBMISSION,	// merge neighboring items with equal state, what you see is unchanged
+	DRAW_QUEUE_ORDER_BY_STATE,		// one draw per unique state, only for layers that never overlap
+};
+
+// Per frame, "naive" is what the submitted items would have cost as individual draw helpers
+struct DrawQueueStats
+{
+	int m_numSubmits = 0;
+	int m_numDrawCalls = 0;
+	int m_numStateCalls = 0;
+
+	int GetNumDrawCallsSaved() const { return m_numSubmits - m_numDrawCalls; }
+	int GetNumStateCallsSaved() const;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Draw helpers Submit() their verts with a state instead of setting state and drawing, Flush()
+// then issues one DrawVertexArray per run of equal state and skips state sets that would not
+// change anything. Vertices are copied on submit, so the caller's list can be reused at once.
+// All items of one flush share the current camera and model constants.
+class DrawQueue
+{
+public:
+	void Submit(RenderStateKey const& state, std::vector<Vertex_PCU> const& verts);
+	void Submit(RenderStateKey const& state, int numVerts, Vertex_PCU const* verts);
+	void Flush(DrawQueueOrder order = DRAW_QUEUE_ORDER_SUBMISSION);
+
+	void EndFrame(); // rolls the frame stats over, call after the last flush
+	DrawQueueStats const& GetLastFrameStats() const { return m_lastFrameStats; }
+
+private:
+	void ApplyState(RenderStateKey const& state, bool isFirstState);
+
+private:
+	struct DrawQueueItem
+	{
+		RenderStateKey m_state;
+		int m_firstVertex = 0;
+		int m_numVertices = 0;
+	};
+
+	std::vector<DrawQueueItem> m_items;
+	std::vector<Vertex_PCU> m_vertices;
+	std::vector<int> m_sortedItemIndexes;
+	std::vector<Vertex_PCU> m_sortedVertices;
+	RenderStateKey m_appliedState;
+
+	DrawQueueStats m_frameStats;
+	DrawQueueStats m_lastFrameStats;
+};
@@ -0,0 +1,151 @@
+#pragma once
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Easing curves as constexpr functors, the same curves as the engine's SmoothStart2 etc.
+// A functor passed to EvaluateEasingBatch is inlined into the loop, where the plain function
+// pointers in Game2DCurves::m_easingFunctions cost an indirect call per sample.
+typedef float (EasingFunction1D)(float t);
+typedef void (EasingBatchFunction)(int numSamples, float const* inputs, float* out_outputs);
+
+
+//-----------------------------------------------------------------------------------------------
+template<int POWER>
+struct EaseSmoothStart
+{
+	constexpr float operator()(float t) const
+	{
+		float result = t;
+		for (int i = 1; i < POWER; ++i)
+		{
+			result *= t;
+		}
+		return result;
+	}
+};
+
+template<int POWER>
+struct EaseSmoothEnd
+{
+	constexpr float operator()(float t) const
+	{
+		return 1.f - EaseSmoothStart<POWER>()(1.f - t);
+	}
+};
+
+struct EaseSmoothStep3
+{
+	constexpr float operator()(float t) const
+	{
+		return t * t * (3.f - 2.f * t);
+	}
+};
+
+struct EaseSmoothStep5
+{
+	constexpr float operator()(float t) const
+	{
+		return t * t * t * (t * (6.f * t - 15.f) + 10.f);
+	}
+};
+
+// Cubic Bezier with control values 0, 1, 0, 1
+struct EaseHesitate3
+{
+	constexpr float operator()(float t) const
+	{
+		float s = 1.f - t;
+		return 3.f * s * s * t + t * t * t;
+	}
+};
+
+// Quintic Bezier with control values 0, 1, 0, 1, 0, 1
+struct EaseHesitate5
+{
+	constexpr float operator()(float t) const
+	{
+		float s = 1.f - t;
+		float t2 = t * t;
+		float s2 = s * s;
+		return 5.f * s2 * s2 * t + 10.f * s2 * t2 * t + t2 * t2 * t;
+	}
+};
+
+// Any plain function as a functor, for curves that only exist in the engine
+template<EasingFunction1D* FUNCTION>
+struct EaseFunction
+{
+	float operator()(float t) const
+	{
+		return FUNCTION(t);
+	}
+};
+
+typedef EaseSmoothStart<2> EaseSmoothStart2;
+typedef EaseSmoothStart<3> EaseSmoothStart3;
+typedef EaseSmoothStart<4> EaseSmoothStart4;
+typedef EaseSmoothStart<5> EaseSmoothStart5;
+typedef EaseSmoothStart<6> EaseSmoothStart6;
+typedef EaseSmoothEnd<2> EaseSmoothEnd2;
+typedef EaseSmoothEnd<3> EaseSmoothEnd3;
+typedef EaseSmoothEnd<4> EaseSmoothEnd4;
+typedef EaseSmoothEnd<5> EaseSmoothEnd5;
+typedef EaseSmoothEnd<6> EaseSmoothEnd6;
+
+static_assert(EaseSmoothStart3()(0.5f) == 0.125f, "SmoothStart3 should fold at compile time");
+static_assert(EaseHesitate5()(1.f) == 1.f, "Hesitate5 should end at 1");
+
+
+//-----------------------------------------------------------------------------------------------
+// Works for functors and for EasingFunction1D pointers alike
+template<typename EasingType>
+void EvaluateEasingBatch(int numSamples, float const* inputs, float* out_outputs, EasingType const& easing)
+{
+	for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+	{
+		out_outputs[sampleIndex] = easing(inputs[sampleIndex]);
+	}
+}
+
+// Functor batches as plain function pointers, one indirect call per batch instead of per sample
+template<typename EasingType>
+void EvaluateEasingBatch(int numSamples, float const* inputs, float* out_outputs)
+{
+	EvaluateEasingBatch(numSamples, inputs, out_outputs, EasingType());
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Evenly spaced samples of an easing curve over [0,1], linearly interpolated
+// For the Bezier based curves a lookup is cheaper than evaluating the polynomial
+class EasingLUT
+{
+public:
+	template<typename EasingType>
+	void Build(EasingType const& easing, int numIntervals = 256)
+	{
+		m_numIntervals = numIntervals;
+		m_values.resize(numIntervals + 2); // one repeat at the end so t = 1 needs no special case
+		float step = 1.f / static_cast<float>(numIntervals);
+		for (int sampleIndex = 0; sampleIndex <= numIntervals; ++sampleIndex)
+		{
+			m_values[sampleIndex] = easing(static_cast<float>(sampleIndex) * step);
+		}
+		m_values[numIntervals + 1] = m_values[numIntervals];
+	}
+
+	bool IsValid() const { return m_numIntervals > 0; }
+
+	float operator()(float t) const
+	{
+		t = (t < 0.f) ? 0.f : ((t > 1.f) ? 1.f : t);
+		float scaledT = t * static_cast<float>(m_numIntervals);
+		int sampleIndex = static_cast<int>(scaledT);
+		float fraction = scaledT - static_cast<float>(sampleIndex);
+		return m_values[sampleIndex] + (m_values[sampleIndex + 1] - m_values[sampleIndex]) * fraction;
+	}
+
+private:
+	int m_numIntervals = 0;
+	std::vector<float> m_values;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstring>
+#include <immintrin.h>
+
+//-----------------------------------------------------------------------------------------------
+// Thin SIMD wrappers so kernels are written once for SSE and AVX (/arch:AVX)
+#if defined(__AVX__)
+constexpr int FLOAT_LANE_COUNT = 8;
+typedef __m256 FloatLanes;
+inline FloatLanes LanesSet(float value)						{ return _mm256_set1_ps(value); }
+inline FloatLanes LanesLoad(float const* values)				{ return _mm256_load_ps(values); }
+inline FloatLanes LanesLoadUnaligned(float const* values)	{ return _mm256_loadu_ps(values); }
+inline void LanesStore(float* out_values, FloatLanes a)		{ _mm256_store_ps(out_values, a); }
+inline void LanesStoreUnaligned(float* out_values, FloatLanes a) { _mm256_storeu_ps(out_values, a); }
+inline FloatLanes LanesAdd(FloatLanes a, FloatLanes b)		{ return _mm256_add_ps(a, b); }
+inline FloatLanes LanesSub(FloatLanes a, FloatLanes b)		{ return _mm256_sub_ps(a, b); }
+inline FloatLanes LanesMul(FloatLanes a, FloatLanes b)		{ return _mm256_mul_ps(a, b); }
+inline FloatLanes LanesDiv(FloatLanes a, FloatLanes b)		{ return _mm256_div_ps(a, b); }
+inline FloatLanes LanesMin(FloatLanes a, FloatLanes b)		{ return _mm256_min_ps(a, b); }
+inline FloatLanes LanesMax(FloatLanes a, FloatLanes b)		{ return _mm256_max_ps(a, b); }
+inline FloatLanes LanesSqrt(FloatLanes a)					{ return _mm256_sqrt_ps(a); }
+inline FloatLanes LanesAnd(FloatLanes a, FloatLanes b)		{ return _mm256_and_ps(a, b); }
+inline FloatLanes LanesOr(FloatLanes a, FloatLanes b)		{ return _mm256_or_ps(a, b); }
+inline FloatLanes LanesAndNot(FloatLanes a, FloatLanes b)	{ return _mm256_andnot_ps(a, b); } // ~a & b
+inline FloatLanes LanesLess(FloatLanes a, FloatLanes b)		{ return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+inline FloatLanes LanesLessEqual(FloatLanes a, FloatLanes b)	{ return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+inline FloatLanes LanesGreater(FloatLanes a, FloatLanes b)	{ return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+inline FloatLanes LanesSelect(FloatLanes mask, FloatLanes ifTrue, FloatLanes ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, mask); }
+inline FloatLanes LanesSetIndex(int index)					{ return _mm256_castsi256_ps(_mm256_set1_epi32(index)); }
+inline FloatLanes LanesSetIndexSequence(int firstIndex)		{ return _mm256_castsi256_ps(_mm256_setr_epi32(firstIndex, firstIndex + 1, firstIndex + 2, firstIndex + 3, firstIndex + 4, firstIndex + 5, firstIndex + 6, firstIndex + 7)); }
+inline bool IsAnyLaneSet(FloatLanes mask)					{ return _mm256_movemask_ps(mask) != 0; }
+#else
+constexpr int FLOAT_LANE_COUNT = 4;
+typedef __m128 FloatLanes;
+inline FloatLanes LanesSet(float value)						{ return _mm_set1_ps(value); }
+inline FloatLanes LanesLoad(float const* values)				{ return _mm_load_ps(values); }
+inline FloatLanes LanesLoadUnaligned(float const* values)	{ return _mm_loadu_ps(values); }
+inline void LanesStore(float* out_values, FloatLanes a)		{ _mm_store_ps(out_values, a); }
+inline void LanesStoreUnaligned(float* out_values, FloatLanes a) { _mm_storeu_ps(out_values, a); }
+inline FloatLanes LanesAdd(FloatLanes a, FloatLanes b)		{ return _mm_add_ps(a, b); }
+inline FloatLanes LanesSub(FloatLanes a, FloatLanes b)		{ return _mm_sub_ps(a, b); }
+inline FloatLanes LanesMul(FloatLanes a, FloatLanes b)		{ return _mm_mul_ps(a, b); }
+inline FloatLanes LanesDiv(FloatLanes a, FloatLanes b)		{ return _mm_div_ps(a, b); }
+inline FloatLanes LanesMin(FloatLanes a, FloatLanes b)		{ return _mm_min_ps(a, b); }
+inline FloatLanes LanesMax(FloatLanes a, FloatLanes b)		{ return _mm_max_ps(a, b); }
+inline FloatLanes LanesSqrt(FloatLanes a)					{ return _mm_sqrt_ps(a); }
+inline FloatLanes LanesAnd(FloatLanes a, FloatLanes b)		{ return _mm_and_ps(a, b); }
+inline FloatLanes LanesOr(FloatLanes a, FloatLanes b)		{ return _mm_or_ps(a, b); }
+inline FloatLanes LanesAndNot(FloatLanes a, FloatLanes b)	{ return _mm_andnot_ps(a, b); } // ~a & b
+inline FloatLanes LanesLess(FloatLanes a, FloatLanes b)		{ return _mm_cmplt_ps(a, b); }
+inline FloatLanes LanesLessEqual(FloatLanes a, FloatLanes b)	{ return _mm_cmple_ps(a, b); }
+inline FloatLanes LanesGreater(FloatLanes a, FloatLanes b)	{ return _mm_cmpgt_ps(a, b); }
+inline FloatLanes LanesSelect(FloatLanes mask, FloatLanes ifTrue, FloatLanes ifFalse) { return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse)); }
+inline FloatLanes LanesSetIndex(int index)					{ return _mm_castsi128_ps(_mm_set1_epi32(index)); }
+inline FloatLanes LanesSetIndexSequence(int firstIndex)		{ return _mm_castsi128_ps(_mm_setr_epi32(firstIndex, firstIndex + 1, firstIndex + 2, firstIndex + 3)); }
+inline bool IsAnyLaneSet(FloatLanes mask)					{ return _mm_movemask_ps(mask) != 0; }
+#endif
+
+inline FloatLanes LanesNegate(FloatLanes a)					{ return LanesSub(LanesSet(0.f), a); }
+
+// Index lanes hold int bits, this unpacks them next to a float lane store
+inline void LanesStoreIndexes(int* out_indexes, FloatLanes indexLanes)
+{
+	alignas(32) float indexBits[FLOAT_LANE_COUNT];
+	LanesStore(indexBits, indexLanes);
+	memcpy(out_indexes, indexBits, sizeof(indexBits));
+}
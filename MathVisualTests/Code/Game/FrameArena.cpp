@@ -0,0 +1,115 @@
+#include "Game/FrameArena.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include <cstdint>
+#include <cstdlib>
+
+//-----------------------------------------------------------------------------------------------
+constexpr size_t FRAME_ARENA_MIN_BLOCK_BYTES = 64 * 1024;
+
+
+//-----------------------------------------------------------------------------------------------
+FrameArena::~FrameArena()
+{
+	FreeBlocks();
+}
+
+void* FrameArena::Allocate(size_t numBytes, size_t alignment)
+{
+	GUARANTEE_OR_DIE(alignment != 0 && (alignment & (alignment - 1)) == 0, "FrameArena alignment must be a power of two!");
+	while (true)
+	{
+		if (m_currentBlockIndex < static_cast<int>(m_blocks.size()))
+		{
+			FrameArenaBlock const& block = m_blocks[m_currentBlockIndex];
+			uintptr_t blockStart = reinterpret_cast<uintptr_t>(block.m_memory);
+			uintptr_t alignedAddress = (blockStart + m_currentBlockOffset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+			size_t alignedOffset = static_cast<size_t>(alignedAddress - blockStart);
+			if (alignedOffset + numBytes <= block.m_numBytes)
+			{
+				m_bumpBytesThisFrame += alignedOffset + numBytes - m_currentBlockOffset;
+				m_currentBlockOffset = alignedOffset + numBytes;
+				return block.m_memory + alignedOffset;
+			}
+			m_currentBlockIndex++;
+			m_currentBlockOffset = 0;
+			continue;
+		}
+		AddBlock(numBytes + alignment);
+	}
+}
+
+std::vector<Vertex_PCU>& FrameArena::AcquireVertexBuffer()
+{
+	if (m_numVertexBuffersInUse == static_cast<int>(m_vertexBuffers.size()))
+	{
+		m_vertexBuffers.emplace_back();
+	}
+	std::vector<Vertex_PCU>& vertexBuffer = m_vertexBuffers[m_numVertexBuffersInUse];
+	m_numVertexBuffersInUse++;
+	vertexBuffer.clear();
+	return vertexBuffer;
+}
+
+void FrameArena::Reset()
+{
+	size_t frameBytes = m_bumpBytesThisFrame;
+	for (int bufferIndex = 0; bufferIndex < m_numVertexBuffersInUse; ++bufferIndex)
+	{
+		frameBytes += m_vertexBuffers[bufferIndex].size() * sizeof(Vertex_PCU);
+	}
+	m_lastFrameBytes = frameBytes;
+	m_peakFrameBytes = (frameBytes > m_peakFrameBytes) ? frameBytes : m_peakFrameBytes;
+	m_lastFrameVertexBufferCount = m_numVertexBuffersInUse;
+
+	// A frame that spilled into more blocks gets one block that holds it all next time
+	if (m_blocks.size() > 1)
+	{
+		size_t totalBytes = 0;
+		for (FrameArenaBlock const& block : m_blocks)
+		{
+			totalBytes += block.m_numBytes;
+		}
+		FreeBlocks();
+		AddBlock(totalBytes);
+	}
+
+	m_currentBlockIndex = 0;
+	m_currentBlockOffset = 0;
+	m_bumpBytesThisFrame = 0;
+	m_numVertexBuffersInUse = 0;
+}
+
+size_t FrameArena::GetReservedBytes() const
+{
+	size_t reservedBytes = 0;
+	for (FrameArenaBlock const& block : m_blocks)
+	{
+		reservedBytes += block.m_numBytes;
+	}
+	for (std::vector<Vertex_PCU> const& vertexBuffer : m_vertexBuffers)
+	{
+		reservedBytes += vertexBuffer.capacity() * sizeof(Vertex_PCU);
+	}
+	return reservedBytes;
+}
+
+void FrameArena::AddBlock(size_t minNumBytes)
+{
+	size_t numBytes = m_blocks.empty() ? FRAME_ARENA_MIN_BLOCK_BYTES : m_blocks.back().m_numBytes * 2;
+	numBytes = (numBytes > minNumBytes) ? numBytes : minNumBytes;
+
+	FrameArenaBlock block;
+	block.m_memory = static_cast<unsigned char*>(malloc(numBytes));
+	GUARANTEE_OR_DIE(block.m_memory != nullptr, "FrameArena ran out of memory!");
+	block.m_numBytes = numBytes;
+	m_blocks.push_back(block);
+}
+
+void FrameArena::FreeBlocks()
+{
+	for (FrameArenaBlock& block : m_blocks)
+	{
+		free(block.m_memory);
+	}
+	m_blocks.clear();
+}
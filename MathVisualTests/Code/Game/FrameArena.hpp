@@ -0,0 +1,77 @@
+#pragma once
+#include "Engine/Core/Vertex_PCU.hpp"
+#include <cstddef>
+#include <deque>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Memory that lives until the end of the frame, for the scratch arrays and vertex lists that draw
+// code used to allocate and free every frame. Reset() in App::EndFrame releases everything at once.
+//
+// Allocate() bumps a pointer through one block. A frame that outgrows it chains more blocks, and
+// the next Reset() merges them into a single block big enough for that frame, so a steady frame
+// never reaches malloc.
+//
+// Engine vertex helpers take std::vector<Vertex_PCU>&, so vertex lists are pooled vectors instead
+// of raw arena memory: AcquireVertexBuffer() hands out an empty one that keeps its capacity from
+// earlier frames.
+class FrameArena
+{
+public:
+	FrameArena() = default;
+	~FrameArena();
+	FrameArena(FrameArena const& copy) = delete;
+	FrameArena& operator=(FrameArena const& copy) = delete;
+
+	void* Allocate(size_t numBytes, size_t alignment = alignof(std::max_align_t));
+	template<typename T>
+	T* AllocateArray(int count);
+	std::vector<Vertex_PCU>& AcquireVertexBuffer();
+
+	void Reset();
+
+	// Bytes handed out: bump allocations plus vertices in acquired buffers
+	size_t GetLastFrameBytes() const { return m_lastFrameBytes; }
+	size_t GetPeakFrameBytes() const { return m_peakFrameBytes; }
+	int GetLastFrameVertexBufferCount() const { return m_lastFrameVertexBufferCount; }
+	size_t GetReservedBytes() const;
+
+private:
+	struct FrameArenaBlock
+	{
+		unsigned char* m_memory = nullptr;
+		size_t m_numBytes = 0;
+	};
+	void AddBlock(size_t minNumBytes);
+	void FreeBlocks();
+
+private:
+	std::vector<FrameArenaBlock> m_blocks;
+	int m_currentBlockIndex = 0;
+	size_t m_currentBlockOffset = 0;
+	size_t m_bumpBytesThisFrame = 0;
+
+	std::deque<std::vector<Vertex_PCU>> m_vertexBuffers; // deque so handed out references stay valid
+	int m_numVertexBuffersInUse = 0;
+
+	size_t m_lastFrameBytes = 0;
+	size_t m_peakFrameBytes = 0;
+	int m_lastFrameVertexBufferCount = 0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+T* FrameArena::AllocateArray(int count)
+{
+	// Reset() runs no destructors
+	static_assert(std::is_trivially_destructible<T>::value, "FrameArena only holds trivially destructible types");
+	T* elements = static_cast<T*>(Allocate(sizeof(T) * static_cast<size_t>(count), alignof(T)));
+	for (int elementIndex = 0; elementIndex < count; ++elementIndex)
+	{
+		new (&elements[elementIndex]) T();
+	}
+	return elements;
+}
@@ -0,0 +1,335 @@
+#include "Game/FrameProfiler.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <vector>
+#if defined(PROFILER_USE_RDTSC)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+//-----------------------------------------------------------------------------------------------
+struct ProfilerEvent
+{
+	char const* m_name = nullptr;
+	uint64_t m_startTicks = 0;
+	uint64_t m_endTicks = 0;
+};
+
+// Written only by its own thread, read by the main thread in ProfilerBeginFrame and trace dumps
+struct ProfilerThreadBuffer
+{
+	int m_threadIndex = 0;
+	std::atomic<uint64_t> m_numWritten{ 0 };
+	uint64_t m_numFolded = 0; // events already added to the zone stats
+	ProfilerEvent m_events[PROFILER_EVENTS_PER_THREAD];
+};
+
+struct ProfilerZoneStats
+{
+	char const* m_name = nullptr;
+	float m_frameMilliseconds[PROFILER_STATS_FRAME_COUNT] = {};
+	bool m_isFrameSampled[PROFILER_STATS_FRAME_COUNT] = {}; // false for frames the zone did not run in, or before it existed
+	uint64_t m_currentFrameTicks = 0;
+	int m_currentFrameCalls = 0;
+	int m_lastFrameCalls = 0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+static std::mutex s_threadBuffersMutex;
+static std::vector<ProfilerThreadBuffer*> s_threadBuffers;
+static std::atomic<int> s_generation{ 0 }; // bumped by startup and shutdown so threads drop stale buffers
+static std::atomic<bool> s_isRunning{ false };
+
+static thread_local ProfilerThreadBuffer* t_threadBuffer = nullptr;
+static thread_local int t_threadBufferGeneration = -1;
+
+static uint64_t s_startupTicks = 0;
+static double s_ticksPerSecond = 1e9;
+#if defined(PROFILER_USE_RDTSC)
+static std::chrono::steady_clock::time_point s_startupTime;
+#endif
+
+static std::vector<ProfilerZoneStats> s_zoneStats;
+static int s_numFramesRecorded = 0;
+static bool s_isFrameOpen = false; // between ProfilerBeginFrame and ProfilerEndFrame
+
+
+//-----------------------------------------------------------------------------------------------
+uint64_t GetProfilerTicks()
+{
+#if defined(PROFILER_USE_RDTSC)
+	return __rdtsc();
+#else
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void ProfilerStartup()
+{
+	std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+	s_startupTicks = GetProfilerTicks();
+#if defined(PROFILER_USE_RDTSC)
+	s_startupTime = std::chrono::steady_clock::now();
+#endif
+	s_zoneStats.clear();
+	s_numFramesRecorded = 0;
+	s_isFrameOpen = false;
+	s_generation.fetch_add(1);
+	s_isRunning.store(true);
+}
+
+void ProfilerShutdown()
+{
+	std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+	s_isRunning.store(false);
+	s_generation.fetch_add(1);
+	for (ProfilerThreadBuffer* buffer : s_threadBuffers)
+	{
+		delete buffer;
+	}
+	s_threadBuffers.clear();
+	s_zoneStats.clear();
+	s_isFrameOpen = false;
+}
+
+static ProfilerThreadBuffer* CreateThreadBuffer()
+{
+	std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+	ProfilerThreadBuffer* buffer = new ProfilerThreadBuffer();
+	buffer->m_threadIndex = static_cast<int>(s_threadBuffers.size());
+	s_threadBuffers.push_back(buffer);
+	return buffer;
+}
+
+void AddProfilerEvent(char const* name, uint64_t startTicks, uint64_t endTicks)
+{
+	if (!s_isRunning.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	int generation = s_generation.load(std::memory_order_relaxed);
+	if (t_threadBufferGeneration != generation)
+	{
+		t_threadBuffer = CreateThreadBuffer();
+		t_threadBufferGeneration = generation;
+	}
+
+	uint64_t eventIndex = t_threadBuffer->m_numWritten.load(std::memory_order_relaxed);
+	ProfilerEvent& event = t_threadBuffer->m_events[eventIndex % PROFILER_EVENTS_PER_THREAD];
+	event.m_name = name;
+	event.m_startTicks = startTicks;
+	event.m_endTicks = endTicks;
+	t_threadBuffer->m_numWritten.store(eventIndex + 1, std::memory_order_release);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static ProfilerZoneStats& GetOrCreateZoneStats(char const* name)
+{
+	// Few zones, and the same name is almost always the same pointer
+	for (ProfilerZoneStats& zone : s_zoneStats)
+	{
+		if (zone.m_name == name || strcmp(zone.m_name, name) == 0)
+		{
+			return zone;
+		}
+	}
+	s_zoneStats.emplace_back();
+	s_zoneStats.back().m_name = name;
+	return s_zoneStats.back();
+}
+
+// Events written since the last fold go into the current frame's zone totals, or are dropped when outside any frame
+static void FoldThreadBuffers(bool isInFrame)
+{
+	for (ProfilerThreadBuffer* buffer : s_threadBuffers)
+	{
+		uint64_t numWritten = buffer->m_numWritten.load(std::memory_order_acquire);
+		uint64_t firstAvailable = (numWritten > PROFILER_EVENTS_PER_THREAD) ? numWritten - PROFILER_EVENTS_PER_THREAD : 0;
+		if (isInFrame)
+		{
+			for (uint64_t eventIndex = std::max(buffer->m_numFolded, firstAvailable); eventIndex < numWritten; ++eventIndex)
+			{
+				ProfilerEvent const& event = buffer->m_events[eventIndex % PROFILER_EVENTS_PER_THREAD];
+				ProfilerZoneStats& zone = GetOrCreateZoneStats(event.m_name);
+				zone.m_currentFrameTicks += event.m_endTicks - event.m_startTicks;
+				zone.m_currentFrameCalls++;
+			}
+		}
+		buffer->m_numFolded = numWritten;
+	}
+}
+
+static void CloseFrame()
+{
+#if defined(PROFILER_USE_RDTSC)
+	// Recalibrated every frame, gets more accurate the longer the app runs
+	double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - s_startupTime).count();
+	if (elapsedSeconds > 0.01)
+	{
+		s_ticksPerSecond = static_cast<double>(GetProfilerTicks() - s_startupTicks) / elapsedSeconds;
+	}
+#endif
+
+	FoldThreadBuffers(true);
+	int frameSlot = s_numFramesRecorded % PROFILER_STATS_FRAME_COUNT;
+	double millisecondsPerTick = 1000.0 / s_ticksPerSecond;
+	for (ProfilerZoneStats& zone : s_zoneStats)
+	{
+		zone.m_frameMilliseconds[frameSlot] = static_cast<float>(static_cast<double>(zone.m_currentFrameTicks) * millisecondsPerTick);
+		zone.m_isFrameSampled[frameSlot] = zone.m_currentFrameCalls > 0;
+		zone.m_lastFrameCalls = zone.m_currentFrameCalls;
+		zone.m_currentFrameTicks = 0;
+		zone.m_currentFrameCalls = 0;
+	}
+	s_numFramesRecorded++;
+	s_isFrameOpen = false;
+}
+
+void ProfilerBeginFrame()
+{
+	if (!s_isRunning.load())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+	if (s_isFrameOpen)
+	{
+		CloseFrame();
+	}
+	else
+	{
+		FoldThreadBuffers(false);
+	}
+	s_isFrameOpen = true;
+}
+
+void ProfilerEndFrame()
+{
+	if (!s_isRunning.load())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+	if (s_isFrameOpen)
+	{
+		CloseFrame();
+	}
+}
+
+void ProfilerResetStats()
+{
+	if (!s_isRunning.load())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+	FoldThreadBuffers(false);
+	s_zoneStats.clear();
+	s_numFramesRecorded = 0;
+	s_isFrameOpen = false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+std::string GetProfilerStatsReport()
+{
+	struct ZoneSummary
+	{
+		char const* m_name;
+		int m_calls;
+		int m_numSampledFrames;
+		float m_min;
+		float m_avg;
+		float m_p99;
+	};
+
+	std::vector<ZoneSummary> summaries;
+	{
+		std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+		int numFrames = std::min(s_numFramesRecorded, PROFILER_STATS_FRAME_COUNT);
+		if (numFrames == 0)
+		{
+			return std::string();
+		}
+
+		float sortedMilliseconds[PROFILER_STATS_FRAME_COUNT];
+		for (ProfilerZoneStats const& zone : s_zoneStats)
+		{
+			// Only frames the zone ran in, so late or occasional zones are not averaged with zeros
+			float sum = 0.f;
+			int numSampledFrames = 0;
+			for (int frameIndex = 0; frameIndex < numFrames; ++frameIndex)
+			{
+				if (zone.m_isFrameSampled[frameIndex])
+				{
+					sortedMilliseconds[numSampledFrames] = zone.m_frameMilliseconds[frameIndex];
+					sum += zone.m_frameMilliseconds[frameIndex];
+					numSampledFrames++;
+				}
+			}
+			if (numSampledFrames == 0)
+			{
+				continue;
+			}
+			std::sort(sortedMilliseconds, sortedMilliseconds + numSampledFrames);
+			int p99Index = (numSampledFrames * 99 + 99) / 100 - 1;
+			summaries.push_back({ zone.m_name, zone.m_lastFrameCalls, numSampledFrames, sortedMilliseconds[0], sum / static_cast<float>(numSampledFrames), sortedMilliseconds[p99Index] });
+		}
+	}
+
+	std::sort(summaries.begin(), summaries.end(), [](ZoneSummary const& a, ZoneSummary const& b) { return a.m_avg > b.m_avg; });
+	std::string report = Stringf("%-40s %5s %6s %7s %7s %7s  (ms per frame ran in, last %d frames)\n", "Zone", "Calls", "Frames", "Min", "Avg", "P99", PROFILER_STATS_FRAME_COUNT);
+	for (ZoneSummary const& summary : summaries)
+	{
+		report += Stringf("%-40.40s %5d %6d %7.3f %7.3f %7.3f\n", summary.m_name, summary.m_calls, summary.m_numSampledFrames, summary.m_min, summary.m_avg, summary.m_p99);
+	}
+	return report;
+}
+
+bool WriteProfilerChromeTrace(char const* filePath)
+{
+	std::ofstream traceFile(filePath);
+	if (!traceFile.is_open())
+	{
+		DebuggerPrintf("WARNING: failed to open profiler trace file \"%s\"\n", filePath);
+		return false;
+	}
+
+	// Events of other threads may be overwritten while this runs, the main thread's are stable
+	std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+	double microsecondsPerTick = 1e6 / s_ticksPerSecond;
+	bool isFirstEvent = true;
+	traceFile << "{\"traceEvents\":[\n";
+	for (ProfilerThreadBuffer const* buffer : s_threadBuffers)
+	{
+		uint64_t numWritten = buffer->m_numWritten.load(std::memory_order_acquire);
+		uint64_t firstAvailable = (numWritten > PROFILER_EVENTS_PER_THREAD) ? numWritten - PROFILER_EVENTS_PER_THREAD : 0;
+		for (uint64_t eventIndex = firstAvailable; eventIndex < numWritten; ++eventIndex)
+		{
+			ProfilerEvent const& event = buffer->m_events[eventIndex % PROFILER_EVENTS_PER_THREAD];
+			double startMicroseconds = static_cast<double>(static_cast<int64_t>(event.m_startTicks - s_startupTicks)) * microsecondsPerTick;
+			double durationMicroseconds = static_cast<double>(event.m_endTicks - event.m_startTicks) * microsecondsPerTick;
+			traceFile << (isFirstEvent ? "" : ",\n");
+			traceFile << Stringf("{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%d}", event.m_name, startMicroseconds, durationMicroseconds, buffer->m_threadIndex);
+			isFirstEvent = false;
+		}
+	}
+	traceFile << "\n]}\n";
+	DebuggerPrintf("Profiler trace written to \"%s\"\n", filePath);
+	return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+//-----------------------------------------------------------------------------------------------
+// Scoped timing zones for finding where a frame goes
+//
+//	void Game2DFlowField::RecreateDistanceMapAndFlowField()
+//	{
+//		PROFILE_FUNCTION();
+//		...
+//	}
+//
+// Every zone that closes appends one event to a ring buffer owned by its thread, no locks and no
+// allocations after the first zone on that thread. Closing a frame folds its events into rolling
+// per-zone stats, and the ring buffers are what a Chrome trace dump writes out (open it in
+// chrome://tracing or ui.perfetto.dev). Zones that close outside any frame are left out of the stats.
+//
+// Zone names must outlive the profiler: string literals or __FUNCTION__.
+// Timestamps come from std::chrono::steady_clock, or from rdtsc when PROFILER_USE_RDTSC is
+// defined, which is cheaper but assumes an invariant TSC.
+//-----------------------------------------------------------------------------------------------
+
+//#define PROFILER_USE_RDTSC
+
+constexpr int PROFILER_EVENTS_PER_THREAD = 1 << 16; // ring buffer size, oldest events are overwritten
+constexpr int PROFILER_STATS_FRAME_COUNT = 120; // frames in the rolling min/avg/p99 window
+
+
+//-----------------------------------------------------------------------------------------------
+void ProfilerStartup();
+void ProfilerShutdown();
+void ProfilerBeginFrame(); // call first thing every frame, closes the previous one if still open
+void ProfilerEndFrame(); // optional, closes the frame now instead of at the next ProfilerBeginFrame
+void ProfilerResetStats(); // forgets every zone and frame so far, e.g. between headless runs
+
+uint64_t GetProfilerTicks();
+void AddProfilerEvent(char const* name, uint64_t startTicks, uint64_t endTicks);
+
+// One line per zone seen in the window: calls last frame, frames it ran in, and min/avg/p99
+// milliseconds over just those frames
+std::string GetProfilerStatsReport();
+bool WriteProfilerChromeTrace(char const* filePath);
+
+
+//-----------------------------------------------------------------------------------------------
+class ProfileZone
+{
+public:
+	explicit ProfileZone(char const* name) : m_name(name), m_startTicks(GetProfilerTicks()) {}
+	~ProfileZone() { AddProfilerEvent(m_name, m_startTicks, GetProfilerTicks()); }
+
+	ProfileZone(ProfileZone const& copy) = delete;
+	ProfileZone& operator=(ProfileZone const& copy) = delete;
+
+private:
+	char const* m_name = nullptr;
+	uint64_t m_startTicks = 0;
+};
+
+#define PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_ZONE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
@@ -2,12 +2,14 @@
 #include "Game/App.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Input/InputSystem.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 
 
 Game::Game()
 {
 	m_clock = new Clock();
+	m_font = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 }
 
 Game::~Game()
@@ -20,6 +22,11 @@ CursorMode Game::GetCursorMode()
 	return m_cursorMode;
 }
 
+void Game::RunBenchmarks(BenchmarkReport& report)
+{
+	UNUSED(report);
+}
+
 void Game::UpdateDeveloperCheats()
 {
 	if (g_theInput->WasKeyJustPressed(KEYCODE_F1))
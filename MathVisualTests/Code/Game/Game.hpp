@@ -3,6 +3,10 @@
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Input/InputSystem.hpp"
 
+//-----------------------------------------------------------------------------------------------
+class BenchmarkReport;
+class BitmapFont;
+
 // ----------------------------------------------------------------------------------------------
 class Game
 {
@@ -13,6 +17,7 @@ public:
 	virtual void Render() const = 0;
 	virtual void RandomizeSceneObjects() = 0;
 	virtual CursorMode GetCursorMode();
+	virtual void RunBenchmarks(BenchmarkReport& report); // F9 in App, --benchmark headless; modes without any leave it empty
 
 protected:
 	virtual void UpdateCameras() = 0;
@@ -24,6 +29,7 @@ protected:
 	// Camera m_screenCamera;
 	Clock* m_clock = nullptr;
 	CursorMode m_cursorMode = CursorMode::POINTER;
+	BitmapFont* m_font = nullptr; // looked up once instead of by name every draw
 };
 
 
@@ -1,5 +1,11 @@
 #include "Game/Game2DCurves.hpp"
 #include "Game/App.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/SplineBuilder.hpp"
+#include "Game/SplineTessellation.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Input/InputSystem.hpp"
@@ -8,10 +14,11 @@
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 
-static const char* G2C_TEXT = "Easing, Curves, Splines (2D): W/E = prev/next Easing function; N/M = curve subdivisions (%d),  F1 Highlight Layout";
+static const char* G2C_TEXT = "Easing, Curves, Splines (2D): W/E = prev/next Easing function; N/M = curve subdivisions (%d), L = easing LUT (%s),  F1 Highlight Layout";
 static std::string SENTENCE = "The quick brown fox jumps over the lazy dog";
 static constexpr float G2C_POINT_RADIUS = 4.f;
 static constexpr float G2C_LINE_WIDTH = 2.5f;
+static constexpr float G2C_FLATNESS_TOLERANCE = 0.25f; // pixels, for the adaptive reference curves
 
 //-----------------------------------------------------------------------------------------------
 Game2DCurves::Game2DCurves()
@@ -41,23 +48,27 @@ Game2DCurves::Game2DCurves()
 
 
 	m_easingFunctions = {
-		{ SmoothStart2, "SmoothStart2 (EaseInQuadratic)" },
-		{ SmoothStart3, "SmoothStart3 (EaseInCubic)" },
-		{ SmoothStart4, "SmoothStart4 (EaseInQuartic)" },
-		{ SmoothStart5, "SmoothStart5 (EaseInQuintic)" },
-		{ SmoothStart6, "SmoothStart6 (EaseIn6thOrder)" },
-		{ SmoothEnd2,   "SmoothEnd2 (EaseOutQuadratic)" },
-		{ SmoothEnd3,   "SmoothEnd3 (EaseOutCubic)" },
-		{ SmoothEnd4,   "SmoothEnd4 (EaseOutQuartic)" },
-		{ SmoothEnd5,   "SmoothEnd5 (EaseOutQuintic)" },
-		{ SmoothEnd6,   "SmoothEnd6 (EaseOut6thOrder)" },
-		{ SmoothStep3,	"SmoothStep3 (EaseInOutCubic)" },
-		{ SmoothStep5,	"SmoothStep5 (EaseInOutQuintic)" },
-		{ Hesitate3,	"Hesitate3" },
-		{ Hesitate5,	"Hesitate5" },
-		{ BounceEndBezier5,	"Funky BounceEnd" },
+		{ SmoothStart2, "SmoothStart2 (EaseInQuadratic)",	EvaluateEasingBatch<EaseSmoothStart2> },
+		{ SmoothStart3, "SmoothStart3 (EaseInCubic)",		EvaluateEasingBatch<EaseSmoothStart3> },
+		{ SmoothStart4, "SmoothStart4 (EaseInQuartic)",		EvaluateEasingBatch<EaseSmoothStart4> },
+		{ SmoothStart5, "SmoothStart5 (EaseInQuintic)",		EvaluateEasingBatch<EaseSmoothStart5> },
+		{ SmoothStart6, "SmoothStart6 (EaseIn6thOrder)",	EvaluateEasingBatch<EaseSmoothStart6> },
+		{ SmoothEnd2,   "SmoothEnd2 (EaseOutQuadratic)",	EvaluateEasingBatch<EaseSmoothEnd2> },
+		{ SmoothEnd3,   "SmoothEnd3 (EaseOutCubic)",		EvaluateEasingBatch<EaseSmoothEnd3> },
+		{ SmoothEnd4,   "SmoothEnd4 (EaseOutQuartic)",		EvaluateEasingBatch<EaseSmoothEnd4> },
+		{ SmoothEnd5,   "SmoothEnd5 (EaseOutQuintic)",		EvaluateEasingBatch<EaseSmoothEnd5> },
+		{ SmoothEnd6,   "SmoothEnd6 (EaseOut6thOrder)",		EvaluateEasingBatch<EaseSmoothEnd6> },
+		{ SmoothStep3,	"SmoothStep3 (EaseInOutCubic)",		EvaluateEasingBatch<EaseSmoothStep3> },
+		{ SmoothStep5,	"SmoothStep5 (EaseInOutQuintic)",	EvaluateEasingBatch<EaseSmoothStep5> },
+		{ Hesitate3,	"Hesitate3",						EvaluateEasingBatch<EaseHesitate3> },
+		{ Hesitate5,	"Hesitate5",						EvaluateEasingBatch<EaseHesitate5> },
+		{ BounceEndBezier5,	"Funky BounceEnd",				EvaluateEasingBatch<EaseFunction<BounceEndBezier5>> },
 
 	};
+	for (EasingFunctionEntry& entry : m_easingFunctions)
+	{
+		entry.m_lut.Build(entry.m_func);
+	}
 
 	RandomizeSceneObjects();
 }
@@ -107,16 +118,14 @@ void Game2DCurves::UpdateCameras()
 
 void Game2DCurves::DrawUsage() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	AABB2 usageBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.93f, SCREEN_SIZE_X * 0.9995f, SCREEN_SIZE_Y * 0.99f);
 	Vec2 alignment(0.f, 1.f);
 	float cellAspect = 0.6f;
-	BitmapFont* testFont = nullptr;
-	testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 
-	std::string usageText = Stringf(G2C_TEXT, m_numSubdivisions);
-	testFont->AddVertsForTextInBox2D(verts, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&testFont->GetTexture());
+	std::string usageText = Stringf(G2C_TEXT, m_numSubdivisions, m_isUsingEasingLUT ? "on" : "off");
+	g_textLayoutCache.AddVertsForTextInBox2D(verts, *m_font, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
+	g_theRenderer->BindTexture(&m_font->GetTexture());
 
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -153,10 +162,7 @@ void Game2DCurves::RandomizeSceneObjects()
 	{
 		m_cubicSplinePoints.push_back(m_bottomHalfPane.GetPointAtUV(GetRandomUVs()));
 	}
-	BubbleSortVec2X(m_cubicSplinePoints);
-
-	m_cubicSpline.ClearAllSplinePoints();
-	m_cubicSpline.SetFromCatmullRomAlgorithm(m_cubicSplinePoints, false);
+	BuildCatmullRomSplineFromUnsortedPoints(m_cubicSpline, m_cubicSplinePoints, false);
 
 
 	RefreshCurves();
@@ -178,6 +184,10 @@ void Game2DCurves::HandleInput()
 	{
 		m_currentEasingIndex = (m_currentEasingIndex + 1) % numEasingFunctions;
 	}
+	if (g_theInput->WasKeyJustPressed(KEYCODE_L))
+	{
+		m_isUsingEasingLUT = !m_isUsingEasingLUT;
+	}
 	if (g_theInput->WasKeyJustPressed(KEYCODE_N))
 	{
 		m_numSubdivisions /= 2;
@@ -200,7 +210,7 @@ void Game2DCurves::DrawLayout() const
 	Rgba8 const color = Rgba8(128, 0, 0);
 	if (m_isLayoutHighlighted)
 	{
-		std::vector<Vertex_PCU> verts;
+		std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 		AddVertsForAABB2D(verts, m_topLeftQuarterPane, color);
 		AddVertsForAABB2D(verts, m_topRightQuarterPane, color);
@@ -218,10 +228,23 @@ void Game2DCurves::DrawLayout() const
 	}
 }
 
+void Game2DCurves::EvaluateCurrentEasing(int numSamples, float const* inputs, float* out_outputs) const
+{
+	EasingFunctionEntry const& entry = m_easingFunctions[m_currentEasingIndex];
+	if (m_isUsingEasingLUT)
+	{
+		EvaluateEasingBatch(numSamples, inputs, out_outputs, entry.m_lut);
+	}
+	else
+	{
+		entry.m_batchFunc(numSamples, inputs, out_outputs);
+	}
+}
+
 void Game2DCurves::DrawEasingFunction() const
 {
-	EasingFunction1D* currentFunc = m_easingFunctions[m_currentEasingIndex].m_func;
-	std::string currentName = m_easingFunctions[m_currentEasingIndex].m_name;
+	PROFILE_FUNCTION();
+	std::string const& currentName = m_easingFunctions[m_currentEasingIndex].m_name;
 
 	AABB2 textBox = m_topLeftQuarterPane;
 	textBox.ChopOffTop(0.9f);
@@ -231,35 +254,45 @@ void Game2DCurves::DrawEasingFunction() const
 	plotBox.ReduceToAspect(1.f);
 
 	//-----------------------------------------------------------------------------------------------
-	std::vector<Vertex_PCU> shapeVerts;
+	std::vector<Vertex_PCU>& shapeVerts = g_frameArena.AcquireVertexBuffer();
 	shapeVerts.reserve(6 + (DEFAULT_SUBDIVISION + 1) * 6 + (m_numSubdivisions + 1) * 6 + 32 * 3 + 6 * 2);
 
 	// Background (6)
 	AddVertsForAABB2D(shapeVerts, plotBox, DARKER_BLUE);
 
 	// Default Curve ((DEFAULT_SUBDIVISION + 1) * 6)
+	float greyCurveXs[DEFAULT_SUBDIVISION + 1];
+	float greyCurveYs[DEFAULT_SUBDIVISION + 1];
+	for (int i = 0; i <= DEFAULT_SUBDIVISION; ++i)
+	{
+		greyCurveXs[i] = static_cast<float>(i) * DEFAULT_STEP;
+	}
+	EvaluateCurrentEasing(DEFAULT_SUBDIVISION + 1, greyCurveXs, greyCurveYs);
+
 	std::vector<Vec2> greyCurvePoints;
 	greyCurvePoints.reserve(DEFAULT_SUBDIVISION + 1);
 	for (int i = 0; i <= DEFAULT_SUBDIVISION; ++i)
 	{
-		float x = static_cast<float>(i) * DEFAULT_STEP;
-		float y = currentFunc(x);
-
-		Vec2 point = plotBox.GetPointAtUV(Vec2(x, y));
+		Vec2 point = plotBox.GetPointAtUV(Vec2(greyCurveXs[i], greyCurveYs[i]));
 		greyCurvePoints.push_back(point);
 	}
 	AddVertsForSimpleLine2D(shapeVerts, greyCurvePoints, G2C_LINE_WIDTH, DARK_GREY);
 
 	// Curve ((m_numSubdivisions + 1) * 6)
-	std::vector<Vec2> curvePoints;
-	curvePoints.reserve(m_numSubdivisions + 1);
+	float* curveXs = g_frameArena.AllocateArray<float>(m_numSubdivisions + 1);
+	float* curveYs = g_frameArena.AllocateArray<float>(m_numSubdivisions + 1);
 	float step = 1.f / static_cast<float>(m_numSubdivisions);
 	for (int i = 0; i <= m_numSubdivisions; ++i)
 	{
-		float x = static_cast<float>(i) * step;
-		float y = currentFunc(x);
+		curveXs[i] = static_cast<float>(i) * step;
+	}
+	EvaluateCurrentEasing(m_numSubdivisions + 1, curveXs, curveYs);
 
-		Vec2 point = plotBox.GetPointAtUV(Vec2(x, y));
+	std::vector<Vec2> curvePoints;
+	curvePoints.reserve(m_numSubdivisions + 1);
+	for (int i = 0; i <= m_numSubdivisions; ++i)
+	{
+		Vec2 point = plotBox.GetPointAtUV(Vec2(curveXs[i], curveYs[i]));
 		curvePoints.push_back(point);
 	}
 
@@ -269,7 +302,7 @@ void Game2DCurves::DrawEasingFunction() const
 	float t = GetCurrentFraction();
 	Vec2 pos;
 	pos.x = t;
-	pos.y = currentFunc(pos.x);
+	EvaluateCurrentEasing(1, &pos.x, &pos.y);
 	pos = plotBox.GetPointAtUV(pos);
 
 	AddVertsForLineSegment2D(shapeVerts, pos, Vec2(pos.x, plotBox.m_mins.y), G2C_LINE_WIDTH, TRANSLUCENT_WHITE);
@@ -287,13 +320,12 @@ void Game2DCurves::DrawEasingFunction() const
 
 	//-----------------------------------------------------------------------------------------------
 	// Text
-	std::vector<Vertex_PCU> textVerts;
+	std::vector<Vertex_PCU>& textVerts = g_frameArena.AcquireVertexBuffer();
 	textVerts.reserve(6);
-	BitmapFont* font = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 
 
-	font->AddVertsForTextInBox2D(textVerts, currentName, textBox, 20.f, Rgba8(255, 150, 50), 0.6f, Vec2(0.5f, 0.5f), TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&font->GetTexture());
+	g_textLayoutCache.AddVertsForTextInBox2D(textVerts, *m_font, currentName, textBox, 20.f, Rgba8(255, 150, 50), 0.6f, Vec2(0.5f, 0.5f), TextBoxMode::SHRINK_TO_FIT);
+	g_theRenderer->BindTexture(&m_font->GetTexture());
 
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -307,8 +339,8 @@ void Game2DCurves::DrawEasingFunction() const
 
 void Game2DCurves::DrawCubicCurve() const
 {
-	std::vector<Vertex_PCU> shapeVerts;
-	shapeVerts.reserve(18 + 64 * 6 + m_numSubdivisions * 6 + 32 * 3 * 4 + 32 * 3 * 3);
+	std::vector<Vertex_PCU>& shapeVerts = g_frameArena.AcquireVertexBuffer();
+	shapeVerts.reserve(18 + m_cubicCurveLineVerts.size() + 32 * 3 * 4 + 32 * 3 * 3);
 
 
 	// ABCD ( 18 )
@@ -316,17 +348,8 @@ void Game2DCurves::DrawCubicCurve() const
 
 	AddVertsForSimpleLine2D(shapeVerts, ABCD, G2C_LINE_WIDTH, DARKER_BLUE);
 
-	// Curve 64 * 6
-	std::vector<Vec2> curvePoints1;
-	curvePoints1.reserve(64 + 1);
-	m_cubicCurve.GetPositionListWithSubdivisions(curvePoints1, 64);
-	AddVertsForSimpleLine2D(shapeVerts, curvePoints1, G2C_LINE_WIDTH, DARK_GREY);
-
-	// Curve m_numSubdivisions * 6
-	std::vector<Vec2> curvePoints;
-	curvePoints.reserve(m_numSubdivisions + 1);
-	m_cubicCurve.GetPositionListWithSubdivisions(curvePoints, m_numSubdivisions);
-	AddVertsForSimpleLine2D(shapeVerts, curvePoints, G2C_LINE_WIDTH, Rgba8::GREEN);
+	// Reference and subdivided curves (cached by RefreshCurves)
+	shapeVerts.insert(shapeVerts.end(), m_cubicCurveLineVerts.begin(), m_cubicCurveLineVerts.end());
 
 	// ABCD points (32 * 3 * 4)
 	AddVertsForDisc2D(shapeVerts, m_cubicCurvePoints[0], G2C_POINT_RADIUS * 0.8f, LIGHT_BLUE);
@@ -341,15 +364,14 @@ void Game2DCurves::DrawCubicCurve() const
 
 
 	// red dot (32 * 3)
-	float curveDistance = inputKey * m_cubicCurve.GetSplineLength();
-	float tempKey = m_cubicCurve.GetInputKeyAtDistanceAlongSpline(curveDistance);
+	float curveDistance = inputKey * m_cubicCurveArcLengths.GetSplineLength();
+	float tempKey = m_cubicCurveArcLengths.GetInputKeyAtDistance(m_cubicCurve, curveDistance);
 	Vec2 redDotPos = m_cubicCurve.GetPositionAtInputKey(tempKey);
 	AddVertsForDisc2D(shapeVerts, redDotPos, G2C_POINT_RADIUS, Rgba8::RED);
 
-	// green dot (32 * 3)
-	float linearCurveDistance = inputKey * m_linearCubicCurve.GetSplineLength();
-	float tempKey2 = m_linearCubicCurve.GetInputKeyAtDistanceAlongSpline(linearCurveDistance);
-	Vec2 greenDotPos = m_linearCubicCurve.GetPositionAtInputKey(tempKey2);
+	// green dot (32 * 3), straight along the subdivided points so it follows N/M
+	float linearCurveDistance = inputKey * m_linearCubicCurveArcLengths.GetSplineLength();
+	Vec2 greenDotPos = m_linearCubicCurveArcLengths.GetSampledPositionAtDistance(linearCurveDistance);
 	AddVertsForDisc2D(shapeVerts, greenDotPos, G2C_POINT_RADIUS, LIGHT_GREEN);
 
 
@@ -369,23 +391,14 @@ void Game2DCurves::DrawCubicSpline() const
 	int numPoints = (int)m_cubicSplinePoints.size();
 	int numSegments = (numPoints - 1);
 
-	std::vector<Vertex_PCU> shapeVerts;
-	shapeVerts.reserve(numSegments * 6 + 64 * numSegments * 6 + m_numSubdivisions * numSegments * 6 + 18 * (numPoints - 2) + numPoints * 32 * 3 + 32 * 3 * 3);
+	std::vector<Vertex_PCU>& shapeVerts = g_frameArena.AcquireVertexBuffer();
+	shapeVerts.reserve(numSegments * 6 + m_cubicSplineLineVerts.size() + 18 * (numPoints - 2) + numPoints * 32 * 3 + 32 * 3 * 3);
 
 	// line 012... (numSegments * 6)
 	AddVertsForSimpleLine2D(shapeVerts, m_cubicSplinePoints, G2C_LINE_WIDTH, DARKER_BLUE);
 
-	// Curve 64 * numSegments * 6
-	std::vector<Vec2> curvePoints1;
-	curvePoints1.reserve(64 * numSegments + 1);
-	m_cubicSpline.GetPositionListWithSubdivisions(curvePoints1, 64);
-	AddVertsForSimpleLine2D(shapeVerts, curvePoints1, G2C_LINE_WIDTH, DARK_GREY);
-
-	// Curve m_numSubdivisions * numSegments * 6
-	std::vector<Vec2> curvePoints2;
-	curvePoints2.reserve(m_numSubdivisions * numSegments + 1);
-	m_cubicSpline.GetPositionListWithSubdivisions(curvePoints2, m_numSubdivisions);
-	AddVertsForSimpleLine2D(shapeVerts, curvePoints2, G2C_LINE_WIDTH, Rgba8::GREEN);
+	// Reference and subdivided curves (cached by RefreshCurves)
+	shapeVerts.insert(shapeVerts.end(), m_cubicSplineLineVerts.begin(), m_cubicSplineLineVerts.end());
 
 
 	// Arrow 18 * (numPoints - 2)
@@ -410,15 +423,14 @@ void Game2DCurves::DrawCubicSpline() const
 
 
 	// red dot (32 * 3)
-	float splineDistance = inputKey / duration * m_cubicSpline.GetSplineLength();
-	float tempKey = m_cubicSpline.GetInputKeyAtDistanceAlongSpline(splineDistance);
+	float splineDistance = inputKey / duration * m_cubicSplineArcLengths.GetSplineLength();
+	float tempKey = m_cubicSplineArcLengths.GetInputKeyAtDistance(m_cubicSpline, splineDistance);
 	Vec2 redDotPos = m_cubicSpline.GetPositionAtInputKey(tempKey);
 	AddVertsForDisc2D(shapeVerts, redDotPos, G2C_POINT_RADIUS, Rgba8::RED);
 
-	// green dot (32 * 3)
-	float linearSplineDistance = inputKey / duration * m_linearCubicSpline.GetSplineLength();
-	float tempKey2 = m_linearCubicSpline.GetInputKeyAtDistanceAlongSpline(linearSplineDistance);
-	Vec2 greenDotPos = m_linearCubicSpline.GetPositionAtInputKey(tempKey2);
+	// green dot (32 * 3), straight along the subdivided points so it follows N/M
+	float linearSplineDistance = inputKey / duration * m_linearCubicSplineArcLengths.GetSplineLength();
+	Vec2 greenDotPos = m_linearCubicSplineArcLengths.GetSampledPositionAtDistance(linearSplineDistance);
 	AddVertsForDisc2D(shapeVerts, greenDotPos, G2C_POINT_RADIUS, LIGHT_GREEN);
 
 	g_theRenderer->BindTexture(nullptr);
@@ -433,13 +445,12 @@ void Game2DCurves::DrawCubicSpline() const
 
 	//-----------------------------------------------------------------------------------------------
 	// Spline Text
-	std::vector<Vertex_PCU> textVerts;
+	std::vector<Vertex_PCU>& textVerts = g_frameArena.AcquireVertexBuffer();
 	textVerts.reserve(200);
-	BitmapFont* font = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 
 
-	font->AddVertsForTextOnSpline2D(textVerts, m_cubicSpline, 15.f, SENTENCE, Rgba8::CYAN, 0.7f, splineDistance);
-	g_theRenderer->BindTexture(&font->GetTexture());
+	m_font->AddVertsForTextOnSpline2D(textVerts, m_cubicSpline, 15.f, SENTENCE, Rgba8::CYAN, 0.7f, splineDistance);
+	g_theRenderer->BindTexture(&m_font->GetTexture());
 
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -453,7 +464,7 @@ void Game2DCurves::DrawCubicSpline() const
 
 void Game2DCurves::DrawObjects() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 
 	g_theRenderer->BindTexture(nullptr);
@@ -480,6 +491,7 @@ Vec2 Game2DCurves::GetRandomUVs()
 
 void Game2DCurves::RefreshCurves()
 {
+	PROFILE_FUNCTION();
 	//-----------------------------------------------------------------------------------------------
 	m_cubicCurve.SetSubdivisionsPerSegment(m_numSubdivisions);
 
@@ -509,28 +521,71 @@ void Game2DCurves::RefreshCurves()
 	}
 	m_linearCubicSpline.SetSubdivisionsPerSegment(1);
 
+	//-----------------------------------------------------------------------------------------------
+	m_cubicCurveArcLengths.Build(m_cubicCurve);
+	m_linearCubicCurveArcLengths.Build(m_linearCubicCurve, 1); // one sample per segment: the subdivided points themselves
+	m_cubicSplineArcLengths.Build(m_cubicSpline);
+	m_linearCubicSplineArcLengths.Build(m_linearCubicSpline, 1);
+
+	//-----------------------------------------------------------------------------------------------
+	std::vector<Vec2> referencePoints;
+	GetAdaptivePositionListForSpline(m_cubicCurve, referencePoints, G2C_FLATNESS_TOLERANCE);
+	m_cubicCurveLineVerts.clear();
+	m_cubicCurveLineVerts.reserve((referencePoints.size() + curvePoints.size()) * 6);
+	AddVertsForSimpleLine2D(m_cubicCurveLineVerts, referencePoints, G2C_LINE_WIDTH, DARK_GREY);
+	AddVertsForSimpleLine2D(m_cubicCurveLineVerts, curvePoints, G2C_LINE_WIDTH, Rgba8::GREEN);
+
+	GetAdaptivePositionListForSpline(m_cubicSpline, referencePoints, G2C_FLATNESS_TOLERANCE);
+	m_cubicSplineLineVerts.clear();
+	m_cubicSplineLineVerts.reserve((referencePoints.size() + splinePoints.size()) * 6);
+	AddVertsForSimpleLine2D(m_cubicSplineLineVerts, referencePoints, G2C_LINE_WIDTH, DARK_GREY);
+	AddVertsForSimpleLine2D(m_cubicSplineLineVerts, splinePoints, G2C_LINE_WIDTH, Rgba8::GREEN);
+
 }
 
-void Game2DCurves::BubbleSortVec2X(std::vector<Vec2>& points)
+void Game2DCurves::RunBenchmarks(BenchmarkReport& report)
 {
-	int n = (int)points.size();
-	bool swapped;
+	RunEasingBenchmark(report);
+}
 
-	for (int i = 0; i < n - 1; ++i)
+void Game2DCurves::RunEasingBenchmark(BenchmarkReport& report) const
+{
+	// Same random inputs through each curve three ways: pointer call per sample, inlined functor, lookup table
+	constexpr int NUM_SAMPLES = 1000000;
+	std::vector<float> inputs(NUM_SAMPLES);
+	for (int sampleIndex = 0; sampleIndex < NUM_SAMPLES; ++sampleIndex)
 	{
-		swapped = false;
-		for (int j = 0; j < n - i - 1; ++j) {
-			if (points[j].x > points[j + 1].x) {
-				Vec2 temp = points[j];
-				points[j] = points[j + 1];
-				points[j + 1] = temp;
-
-				swapped = true;
-			}
-		}
+		inputs[sampleIndex] = g_rng.RollRandomFloatZeroToOne();
+	}
+	std::vector<float> pointerOutputs(NUM_SAMPLES);
+	std::vector<float> inlinedOutputs(NUM_SAMPLES);
+	std::vector<float> lutOutputs(NUM_SAMPLES);
 
-		if (!swapped) {
-			break;
+	report.AddSection(Stringf("Easing, ns/sample over %d samples", NUM_SAMPLES));
+	report.AddLine("Curve              Pointer Inlined   LUT  LUT error  Inlined diff");
+	for (EasingFunctionEntry const& entry : m_easingFunctions)
+	{
+		BenchmarkTimer pointerTimer;
+		EvaluateEasingBatch(NUM_SAMPLES, inputs.data(), pointerOutputs.data(), entry.m_func);
+		double pointerNanoseconds = pointerTimer.GetElapsedNanoseconds() / NUM_SAMPLES;
+
+		BenchmarkTimer inlinedTimer;
+		entry.m_batchFunc(NUM_SAMPLES, inputs.data(), inlinedOutputs.data());
+		double inlinedNanoseconds = inlinedTimer.GetElapsedNanoseconds() / NUM_SAMPLES;
+
+		BenchmarkTimer lutTimer;
+		EvaluateEasingBatch(NUM_SAMPLES, inputs.data(), lutOutputs.data(), entry.m_lut);
+		double lutNanoseconds = lutTimer.GetElapsedNanoseconds() / NUM_SAMPLES;
+
+		float maxLUTError = 0.f;
+		float maxInlinedDifference = 0.f;
+		for (int sampleIndex = 0; sampleIndex < NUM_SAMPLES; ++sampleIndex)
+		{
+			maxLUTError = fmaxf(maxLUTError, fabsf(lutOutputs[sampleIndex] - pointerOutputs[sampleIndex]));
+			maxInlinedDifference = fmaxf(maxInlinedDifference, fabsf(inlinedOutputs[sampleIndex] - pointerOutputs[sampleIndex]));
 		}
+
+		std::string shortName = entry.m_name.substr(0, entry.m_name.find(" ("));
+		report.AddLine(Stringf("%-18s %7.2f %7.2f %5.2f  %9.6f  %12.8f", shortName.c_str(), pointerNanoseconds, inlinedNanoseconds, lutNanoseconds, maxLUTError, maxInlinedDifference));
 	}
 }
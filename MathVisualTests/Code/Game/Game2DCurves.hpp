@@ -1,17 +1,19 @@
 #pragma once
 #include "Game/Game.hpp"
+#include "Game/Easing.hpp"
+#include "Game/SplineArcLengthTable.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Math/RaycastUtils.hpp"
 #include "Engine/Math/Spline.hpp"
 #include <vector>
 
 //-----------------------------------------------------------------------------------------------
-typedef float (EasingFunction1D)(float t);
-
 struct EasingFunctionEntry
 {
 	EasingFunction1D* m_func = nullptr;
 	std::string m_name;
+	EasingBatchFunction* m_batchFunc = nullptr; // same curve with the functor inlined
+	EasingLUT m_lut; // built from m_func in the constructor
 };
 
 constexpr int DEFAULT_SUBDIVISION = 64;
@@ -26,6 +28,7 @@ public:
 	virtual void Update() override;
 	virtual void Render() const override;
 	virtual void RandomizeSceneObjects() override;
+	virtual void RunBenchmarks(BenchmarkReport& report) override;
 
 
 private:
@@ -33,9 +36,11 @@ private:
 	virtual void DrawUsage() const override;
 	
 	void HandleInput();
+	void RunEasingBenchmark(BenchmarkReport& report) const;
 
 
 	void DrawLayout() const;
+	void EvaluateCurrentEasing(int numSamples, float const* inputs, float* out_outputs) const;
 	void DrawEasingFunction() const;
 	void DrawCubicCurve() const;
 	void DrawCubicSpline() const;
@@ -47,7 +52,6 @@ private:
 
 	void RefreshCurves();
 
-	void BubbleSortVec2X(std::vector<Vec2>& points);
 private:
 	Camera m_camera;
 
@@ -61,6 +65,7 @@ private:
 
 	std::vector<EasingFunctionEntry> m_easingFunctions;
 	int m_currentEasingIndex = 0;
+	bool m_isUsingEasingLUT = false;
 	// t game clock time %n
 
 	Spline2D m_cubicCurve;
@@ -70,5 +75,15 @@ private:
 	Spline2D m_cubicSpline;
 	Spline2D m_linearCubicSpline;
 	std::vector<Vec2> m_cubicSplinePoints;
+
+	// Rebuilt by RefreshCurves whenever the points or subdivisions change
+	SplineArcLengthTable2D m_cubicCurveArcLengths;
+	SplineArcLengthTable2D m_linearCubicCurveArcLengths;
+	SplineArcLengthTable2D m_cubicSplineArcLengths;
+	SplineArcLengthTable2D m_linearCubicSplineArcLengths;
+
+	// Grey reference and green subdivided curve lines, also only rebuilt by RefreshCurves
+	std::vector<Vertex_PCU> m_cubicCurveLineVerts;
+	std::vector<Vertex_PCU> m_cubicSplineLineVerts;
 };
 
@@ -1,6 +1,8 @@
 #include "Game/Game2DExposureAvoidance.hpp"
-
-#include "Game/Game2DExposureAvoidance.hpp"
+#include "Game/DrawQueue.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Input/InputSystem.hpp"
@@ -9,6 +11,7 @@
 #include "Engine/Math/Gradient.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include <climits>
 
 static const char* G2EXP_TEXT = "Exposure Avoidance (2D): LMB Add/Remove Sentinel";
 static constexpr float SOLID_PROBABILITY = 0.1f;
@@ -17,6 +20,8 @@ static constexpr float SPECIAL_VALUE_POS = 999999.f;
 static constexpr float SPECIAL_VALUE_NEG = -1.f; // this is the reverse spread lower bound, useful
 static constexpr float EXPOSED_VALUE = 10000.f;
 static constexpr float UNEXPOSED_VALUE = 0.f;
+static constexpr float LABEL_CELL_HEIGHT = 14.f;
+static constexpr int NO_LABEL_VALUE = INT_MIN;
 
 //-----------------------------------------------------------------------------------------------
 Game2DExposureAvoidance::Game2DExposureAvoidance()
@@ -36,6 +41,7 @@ void Game2DExposureAvoidance::Update()
 
 	HandleInput();
 	UpdateExposureMap();
+	UpdateExposureLabels();
 	UpdateCameras();
 }
 
@@ -47,6 +53,7 @@ void Game2DExposureAvoidance::Render() const
 	DrawTileGrid();
 	DrawSentinels();
 	DrawUsage();
+	g_drawQueue.Flush();
 
 	g_theRenderer->EndCamera(m_camera);
 }
@@ -68,6 +75,15 @@ void Game2DExposureAvoidance::RandomizeSceneObjects()
 
 	// Update exposure map size here
 	m_exposureMap = TileHeatMap(m_gridDimensions);
+
+	// Distances never exceed the tile count, so the dense label range covers every reachable value
+	int numTileLabels = m_exposureMap.GetNumTiles();
+	m_labelGlyphCacheMinValue = -numTileLabels;
+	m_labelGlyphCache.clear();
+	m_labelGlyphCache.resize(2 * numTileLabels + 1);
+	m_tileLabelValues.assign(numTileLabels, NO_LABEL_VALUE);
+	m_tileLabelFirstVertIndex.assign(numTileLabels, 0);
+	m_labelVerts.clear();
 }
 
 void Game2DExposureAvoidance::UpdateCameras()
@@ -77,24 +93,14 @@ void Game2DExposureAvoidance::UpdateCameras()
 
 void Game2DExposureAvoidance::DrawUsage() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	AABB2 usageBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.93f, SCREEN_SIZE_X * 0.9995f, SCREEN_SIZE_Y * 0.99f);
 	Vec2 alignment(0.f, 1.f);
 	float cellAspect = 0.6f;
-	BitmapFont* testFont = nullptr;
-	testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 
 	std::string usageText = Stringf(G2EXP_TEXT);
-	testFont->AddVertsForTextInBox2D(verts, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&testFont->GetTexture());
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-
-	g_theRenderer->DrawVertexArray(verts);
+	g_textLayoutCache.AddVertsForTextInBox2D(verts, *m_font, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
+	g_drawQueue.Submit(RenderStateKey(&m_font->GetTexture()), verts);
 }
 
 void Game2DExposureAvoidance::HandleInput()
@@ -127,6 +133,7 @@ void Game2DExposureAvoidance::HandleInput()
 
 void Game2DExposureAvoidance::UpdateExposureMap()
 {
+	PROFILE_FUNCTION();
 
 
 	GUARANTEE_OR_DIE(m_exposureMap.m_dimensions == m_gridDimensions, "TileHeatMap and Map did not match!");
@@ -176,85 +183,125 @@ void Game2DExposureAvoidance::UpdateExposureMap()
 	
 }
 
-void Game2DExposureAvoidance::DrawExposureMap() const
+void Game2DExposureAvoidance::UpdateExposureLabels()
 {
-	std::vector<Vertex_PCU> verts;
+	PROFILE_FUNCTION();
+	// Only tiles whose value changed are rebuilt; if a label changes its glyph count, the whole array is restamped from the cache
+	int numTiles = m_exposureMap.GetNumTiles();
+	bool isRepackNeeded = false;
+	for (int tileIndex = 0; tileIndex < numTiles; ++tileIndex)
+	{
+		int labelValue = static_cast<int>(roundf(m_exposureMap.GetValueAtIndex(tileIndex)));
+		int prevLabelValue = m_tileLabelValues[tileIndex];
+		if (labelValue == prevLabelValue)
+		{
+			continue;
+		}
+		m_tileLabelValues[tileIndex] = labelValue;
 
-	Vec2 dimensions = Vec2(static_cast<float>(m_gridDimensions.x) * m_cellSize.x, static_cast<float>(m_gridDimensions.y) * m_cellSize.y);
+		if (isRepackNeeded || prevLabelValue == NO_LABEL_VALUE)
+		{
+			isRepackNeeded = true;
+			continue;
+		}
 
-	//m_exposureMap.AddVertsForDebugDraw(verts, AABB2(m_gridOrigin, m_gridOrigin + dimensions), Gradient::MakeHeatGradient(), m_exposureMap.GetRangeOffValuesExcludingSpecial(SPECIAL_VALUE_POS), SPECIAL_VALUE_POS, Rgba8::OPAQUE_WHITE);
-	m_exposureMap.AddVertsForDebugDraw(verts, AABB2(m_gridOrigin, m_gridOrigin + dimensions), m_exposureMap.GetRangeOffValuesExcludingSpecial(SPECIAL_VALUE_POS), UNEXPOSED_VALUE,
-		Rgba8(0,233,233), Rgba8(0,0,255), Rgba8(70,0,0), Rgba8(255,0,0), SPECIAL_VALUE_POS, Rgba8::YELLOW);
+		std::vector<Vertex_PCU> const& glyphVerts = GetOrCreateLabelGlyphs(labelValue);
+		if (glyphVerts.size() != GetOrCreateLabelGlyphs(prevLabelValue).size())
+		{
+			isRepackNeeded = true;
+			continue;
+		}
+		StampLabelGlyphs(glyphVerts, tileIndex, m_labelVerts.data() + m_tileLabelFirstVertIndex[tileIndex]);
+	}
 
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
+	if (!isRepackNeeded)
+	{
+		return;
+	}
 
-	g_theRenderer->DrawVertexArray(verts);
+	m_labelVerts.clear();
+	for (int tileIndex = 0; tileIndex < numTiles; ++tileIndex)
+	{
+		std::vector<Vertex_PCU> const& glyphVerts = GetOrCreateLabelGlyphs(m_tileLabelValues[tileIndex]);
+		int firstVertIndex = static_cast<int>(m_labelVerts.size());
+		m_tileLabelFirstVertIndex[tileIndex] = firstVertIndex;
+		m_labelVerts.resize(m_labelVerts.size() + glyphVerts.size());
+		StampLabelGlyphs(glyphVerts, tileIndex, m_labelVerts.data() + firstVertIndex);
+	}
+}
 
+std::vector<Vertex_PCU> const& Game2DExposureAvoidance::GetOrCreateLabelGlyphs(int labelValue)
+{
+	int cacheIndex = labelValue - m_labelGlyphCacheMinValue;
+	bool isInDenseRange = cacheIndex >= 0 && cacheIndex < static_cast<int>(m_labelGlyphCache.size());
+	if (isInDenseRange && !m_labelGlyphCache[cacheIndex].empty())
+	{
+		return m_labelGlyphCache[cacheIndex];
+	}
+	if (!isInDenseRange)
+	{
+		auto found = m_specialLabelGlyphCache.find(labelValue);
+		if (found != m_specialLabelGlyphCache.end())
+		{
+			return found->second;
+		}
+	}
 
-	// Draw Text
-	std::vector<Vertex_PCU> textVerts;
-	BitmapFont* testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
+	// Lay the text out once in a tile-sized box at the origin
+	std::vector<Vertex_PCU>& glyphVerts = isInDenseRange ? m_labelGlyphCache[cacheIndex] : m_specialLabelGlyphCache[labelValue];
+	m_font->AddVertsForTextInBox2D(glyphVerts, Stringf("%d", labelValue), AABB2(Vec2::ZERO, m_cellSize), LABEL_CELL_HEIGHT);
+	return glyphVerts;
+}
 
-	AABB2 totalBounds = AABB2(m_gridOrigin, m_gridOrigin + dimensions);
+void Game2DExposureAvoidance::StampLabelGlyphs(std::vector<Vertex_PCU> const& glyphVerts, int tileIndex, Vertex_PCU* out_verts) const
+{
+	int tileX = tileIndex % m_gridDimensions.x;
+	int tileY = tileIndex / m_gridDimensions.x;
+	Vec2 tileMins = Vec2(static_cast<float>(tileX) * m_cellSize.x, static_cast<float>(tileY) * m_cellSize.y) + m_gridOrigin;
+	Vec3 offset = Vec3(tileMins.x, tileMins.y, 0.f);
 
-	for (int tileY = 0; tileY < m_gridDimensions.y; ++tileY)
+	int numVerts = static_cast<int>(glyphVerts.size());
+	for (int vertIndex = 0; vertIndex < numVerts; ++vertIndex)
 	{
-		for (int tileX = 0; tileX < m_gridDimensions.x; ++tileX)
-		{
-			int tileIndex = tileX + m_gridDimensions.x * tileY;
-			float value = m_exposureMap.GetValueAtIndex(tileIndex);
+		out_verts[vertIndex] = glyphVerts[vertIndex];
+		out_verts[vertIndex].m_position += offset;
+	}
+}
 
-			float outMinX = RangeMap(static_cast<float>(tileX), 0.f, static_cast<float>(m_gridDimensions.x), totalBounds.m_mins.x, totalBounds.m_maxs.x);
-			float outMaxX = RangeMap(static_cast<float>(tileX + 1), 0.f, static_cast<float>(m_gridDimensions.x), totalBounds.m_mins.x, totalBounds.m_maxs.x);
-			float outMinY = RangeMap(static_cast<float>(tileY), 0.f, static_cast<float>(m_gridDimensions.y), totalBounds.m_mins.y, totalBounds.m_maxs.y);
-			float outMaxY = RangeMap(static_cast<float>(tileY + 1), 0.f, static_cast<float>(m_gridDimensions.y), totalBounds.m_mins.y, totalBounds.m_maxs.y);
+void Game2DExposureAvoidance::DrawExposureMap() const
+{
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
+
+	Vec2 dimensions = Vec2(static_cast<float>(m_gridDimensions.x) * m_cellSize.x, static_cast<float>(m_gridDimensions.y) * m_cellSize.y);
 
-			AABB2 tileBounds = AABB2(outMinX, outMinY, outMaxX, outMaxY);
+	//m_exposureMap.AddVertsForDebugDraw(verts, AABB2(m_gridOrigin, m_gridOrigin + dimensions), Gradient::MakeHeatGradient(), m_exposureMap.GetRangeOffValuesExcludingSpecial(SPECIAL_VALUE_POS), SPECIAL_VALUE_POS, Rgba8::OPAQUE_WHITE);
+	m_exposureMap.AddVertsForDebugDraw(verts, AABB2(m_gridOrigin, m_gridOrigin + dimensions), m_exposureMap.GetRangeOffValuesExcludingSpecial(SPECIAL_VALUE_POS), UNEXPOSED_VALUE,
+		Rgba8(0,233,233), Rgba8(0,0,255), Rgba8(70,0,0), Rgba8(255,0,0), SPECIAL_VALUE_POS, Rgba8::YELLOW);
 
-			std::string valueText = Stringf("%.0f", value);
-			testFont->AddVertsForTextInBox2D(textVerts, valueText, tileBounds, 14.f);
+	g_drawQueue.Submit(RenderStateKey(), verts);
 
-		}
-	}
 
-	g_theRenderer->BindTexture(&testFont->GetTexture());
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
+	// Draw Text, labels are stamped in UpdateExposureLabels
 
-	g_theRenderer->DrawVertexArray(textVerts);
+	g_drawQueue.Submit(RenderStateKey(&m_font->GetTexture()), m_labelVerts);
 
 }
 
 void Game2DExposureAvoidance::DrawSolidMap() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 	Vec2 dimensions = Vec2(static_cast<float>(m_gridDimensions.x) * m_cellSize.x, static_cast<float>(m_gridDimensions.y) * m_cellSize.y);
 
 	m_solidMap->AddVertsForDebugDraw(verts, AABB2(m_gridOrigin, m_gridOrigin + dimensions), FloatRange(0.f, SOLID_VALUE), Rgba8::TRANSPARENT_BLACK, DARK_BLUE);
 
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-
-	g_theRenderer->DrawVertexArray(verts);
+	g_drawQueue.Submit(RenderStateKey(), verts);
 }
 
 
 void Game2DExposureAvoidance::DrawTileGrid() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 	float thickness = m_cellSize.x * 0.05f;
 	for (int i = 0; i <= m_gridDimensions.x; ++i)
@@ -272,19 +319,12 @@ void Game2DExposureAvoidance::DrawTileGrid() const
 
 
 
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-
-	g_theRenderer->DrawVertexArray(verts);
+	g_drawQueue.Submit(RenderStateKey(), verts);
 }
 
 void Game2DExposureAvoidance::DrawSentinels() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 	for (Vec2 const& sentinel : m_sentinels)
 	{
@@ -293,14 +333,7 @@ void Game2DExposureAvoidance::DrawSentinels() const
 
 	
 
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-
-	g_theRenderer->DrawVertexArray(verts);
+	g_drawQueue.Submit(RenderStateKey(), verts);
 }
 
 RaycastResult2D Game2DExposureAvoidance::FastVoxelRaycast(Vec2 rayStart, Vec2 rayForwardNormal, float rayLength) const
@@ -5,6 +5,8 @@
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Math/IntVec2.hpp"
 #include "Engine/Math/RaycastUtils.hpp"
+#include <map>
+#include <vector>
 
 class TileHeatMap;
 
@@ -27,7 +29,9 @@ private:
 	void HandleInput();
 
 	void UpdateExposureMap();
-
+	void UpdateExposureLabels();
+	std::vector<Vertex_PCU> const& GetOrCreateLabelGlyphs(int labelValue);
+	void StampLabelGlyphs(std::vector<Vertex_PCU> const& glyphVerts, int tileIndex, Vertex_PCU* out_verts) const;
 
 	void DrawExposureMap() const;
 	void DrawSolidMap() const;
@@ -48,6 +52,14 @@ private:
 	TileHeatMap* m_solidMap = nullptr;
 	TileHeatMap m_exposureMap = TileHeatMap(IntVec2(), 0.f);
 
+	// Exposure value labels: each value is laid out once at the tile origin, then stamped at tile offsets
+	std::vector<std::vector<Vertex_PCU>> m_labelGlyphCache; // dense, indexed by (value - m_labelGlyphCacheMinValue)
+	std::map<int, std::vector<Vertex_PCU>> m_specialLabelGlyphCache; // values outside the dense range, e.g. solid tiles
+	int m_labelGlyphCacheMinValue = 0;
+	std::vector<int> m_tileLabelValues;
+	std::vector<int> m_tileLabelFirstVertIndex;
+	std::vector<Vertex_PCU> m_labelVerts;
+
 	IntVec2		m_gridDimensions	= IntVec2(50, 25);
 	Vec2		m_cellSize			= Vec2(28.f, 28.f);
 	Vec2		m_gridOrigin		= Vec2(100.f, 50.f);
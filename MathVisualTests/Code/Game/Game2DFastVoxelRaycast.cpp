@@ -1,6 +1,9 @@
 #include "Game/Game2DFastVoxelRaycast.hpp"
 
 #include "Game/Game2DFastVoxelRaycast.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/HeatMaps.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/VertexUtils.hpp"
@@ -68,16 +71,14 @@ void Game2DFastVoxelRaycast::UpdateCameras()
 
 void Game2DFastVoxelRaycast::DrawUsage() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	AABB2 usageBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.93f, SCREEN_SIZE_X * 0.9995f, SCREEN_SIZE_Y * 0.99f);
 	Vec2 alignment(0.f, 1.f);
 	float cellAspect = 0.6f;
-	BitmapFont* testFont = nullptr;
-	testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 
 	std::string usageText = Stringf(G2VOXEL_TEXT);
-	testFont->AddVertsForTextInBox2D(verts, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&testFont->GetTexture());
+	g_textLayoutCache.AddVertsForTextInBox2D(verts, *m_font, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
+	g_theRenderer->BindTexture(&m_font->GetTexture());
 
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -169,7 +170,8 @@ void Game2DFastVoxelRaycast::HandleInput()
 
 void Game2DFastVoxelRaycast::DrawSolidMap() const
 {
-	std::vector<Vertex_PCU> verts;
+	PROFILE_FUNCTION();
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 	Vec2 dimensions = Vec2(static_cast<float>(m_gridDimensions.x) * m_cellSize.x, static_cast<float>(m_gridDimensions.y) * m_cellSize.y);
 
@@ -204,10 +206,11 @@ void Game2DFastVoxelRaycast::DrawSolidMap() const
 
 void Game2DFastVoxelRaycast::DrawRaycastResult() const
 {
+	PROFILE_FUNCTION();
 	Vec2 disp = m_rayEndPos - m_rayStartPos;
 	RaycastResult2D raycastResult = FastVoxelRaycast(m_rayStartPos, disp.GetNormalized(), disp.GetLength());
 	
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 
 
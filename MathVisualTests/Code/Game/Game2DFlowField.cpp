@@ -1,6 +1,11 @@
 #include "Game/Game2DFlowField.hpp"
 
 #include "Game/Game2DFlowField.hpp"
+#include "Game/DrawQueue.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/PrimitiveMeshes.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Input/InputSystem.hpp"
@@ -51,6 +56,7 @@ void Game2DFlowField::Render() const
 	DrawStartsAndEnds();
 	DrawActors();
 	DrawUsage();
+	g_drawQueue.Flush();
 
 	g_theRenderer->EndCamera(m_camera);
 }
@@ -77,24 +83,14 @@ void Game2DFlowField::UpdateCameras()
 
 void Game2DFlowField::DrawUsage() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	AABB2 usageBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.93f, SCREEN_SIZE_X * 0.9995f, SCREEN_SIZE_Y * 0.99f);
 	Vec2 alignment(0.f, 1.f);
 	float cellAspect = 0.6f;
-	BitmapFont* testFont = nullptr;
-	testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 
 	std::string usageText = Stringf(G2EXP_TEXT);
-	testFont->AddVertsForTextInBox2D(verts, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&testFont->GetTexture());
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-
-	g_theRenderer->DrawVertexArray(verts);
+	g_textLayoutCache.AddVertsForTextInBox2D(verts, *m_font, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
+	g_drawQueue.Submit(RenderStateKey(&m_font->GetTexture()), verts);
 }
 
 void Game2DFlowField::HandleInput()
@@ -179,6 +175,7 @@ void Game2DFlowField::RecreateSolidMap()
 
 void Game2DFlowField::RecreateDistanceMapAndFlowField()
 {
+	PROFILE_FUNCTION();
 	// Create Distance Map from m_ends and solid Map
 	delete m_distanceMap;
 	m_distanceMap = new TileHeatMap(m_gridDimensions, SPECIAL_VALUE);
@@ -266,6 +263,7 @@ void Game2DFlowField::SpawnActor()
 
 void Game2DFlowField::UpdateActors()
 {
+	PROFILE_FUNCTION();
 	float deltaSeconds = (float)m_clock->GetDeltaSeconds();
 	for (FlowFieldActor2D& actor : m_actors)
 	{
@@ -299,7 +297,7 @@ void Game2DFlowField::TeleportActors()
 
 void Game2DFlowField::DrawDistanceMap() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 	Vec2 dimensions = Vec2(static_cast<float>(m_gridDimensions.x) * m_cellSize.x, static_cast<float>(m_gridDimensions.y) * m_cellSize.y);
 
@@ -307,56 +305,35 @@ void Game2DFlowField::DrawDistanceMap() const
 		m_distanceMap->GetRangeOffValuesExcludingSpecial(SPECIAL_VALUE), Rgba8(0, 0, 0), Rgba8(255, 255, 255),
 		SPECIAL_VALUE);
 
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-
-	g_theRenderer->DrawVertexArray(verts);
+	g_drawQueue.Submit(RenderStateKey(), verts);
 }
 
 void Game2DFlowField::DrawFlowField() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 	Vec2 dimensions = Vec2(static_cast<float>(m_gridDimensions.x) * m_cellSize.x, static_cast<float>(m_gridDimensions.y) * m_cellSize.y);
 
 	m_flowField->AddVertsForDebugDraw(verts, AABB2(m_gridOrigin, m_gridOrigin + dimensions));
 
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-
-	g_theRenderer->DrawVertexArray(verts);
+	g_drawQueue.Submit(RenderStateKey(), verts);
 }
 
 void Game2DFlowField::DrawSolidMap() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 	Vec2 dimensions = Vec2(static_cast<float>(m_gridDimensions.x) * m_cellSize.x, static_cast<float>(m_gridDimensions.y) * m_cellSize.y);
 
 	m_solidMap->AddVertsForDebugDraw(verts, AABB2(m_gridOrigin, m_gridOrigin + dimensions), FloatRange(0.f, SOLID_VALUE), Rgba8::TRANSPARENT_BLACK, DARK_BLUE);
 
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-
-	g_theRenderer->DrawVertexArray(verts);
+	g_drawQueue.Submit(RenderStateKey(), verts);
 }
 
 
 void Game2DFlowField::DrawTileGrid() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 	float thickness = m_cellSize.x * 0.05f;
 	for (int i = 0; i <= m_gridDimensions.x; ++i)
@@ -372,19 +349,12 @@ void Game2DFlowField::DrawTileGrid() const
 		AddVertsForLineSegment2D(verts, start, end, thickness, DARK_GREY);
 	}
 
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-
-	g_theRenderer->DrawVertexArray(verts);
+	g_drawQueue.Submit(RenderStateKey(), verts);
 }
 
 void Game2DFlowField::DrawStartsAndEnds() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 	for (IntVec2 const& coords : m_starts)
 	{
@@ -396,39 +366,34 @@ void Game2DFlowField::DrawStartsAndEnds() const
 		AddVertsForDisc2D(verts, GetTileCenter(coords.x, coords.y), m_endRadius, Rgba8(181, 230, 29), 16);
 	}
 
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-
-	g_theRenderer->DrawVertexArray(verts);
+	g_drawQueue.Submit(RenderStateKey(), verts);
 }
 
 void Game2DFlowField::DrawActors() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 	float actorRadius = m_cellSize.x * 0.5f;
 	float actorArrowSize = m_cellSize.x * 0.3f;
 	float actorArrowWidth = m_cellSize.x * 0.1f;
+	int numActors = static_cast<int>(m_actors.size());
+	PrimitiveInstance* actorDiscs = g_frameArena.AllocateArray<PrimitiveInstance>(numActors);
+	for (int actorIndex = 0; actorIndex < numActors; ++actorIndex)
+	{
+		actorDiscs[actorIndex].m_start = Vec3(m_actors[actorIndex].m_position.x, m_actors[actorIndex].m_position.y, 0.f);
+		actorDiscs[actorIndex].m_radius = actorRadius;
+		actorDiscs[actorIndex].m_color = Rgba8::CYAN;
+	}
+	AddVertsForPrimitiveInstances(verts, PRIMITIVE_MESH_DISC_2D, PRIMITIVE_MESH_LOD_MEDIUM, numActors, actorDiscs);
+
 	for (FlowFieldActor2D const& actor : m_actors)
 	{
-		AddVertsForDisc2D(verts, actor.m_position, actorRadius, Rgba8::CYAN, 16);
 		Vec2 halfArrow = Vec2::MakeFromPolarDegrees(actor.m_orientationDegrees, actorRadius * 0.8f);
 		AddVertsForArrow2D(verts, actor.m_position - halfArrow, actor.m_position + halfArrow, actorArrowSize, actorArrowWidth, Rgba8(34, 126, 255));
 	}
 
 
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-
-	g_theRenderer->DrawVertexArray(verts);
+	g_drawQueue.Submit(RenderStateKey(), verts);
 }
 
 bool Game2DFlowField::IsTileSolid(int tileX, int tileY) const
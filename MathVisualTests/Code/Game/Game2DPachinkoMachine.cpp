@@ -1,4 +1,7 @@
 #include "Game/Game2DPachinkoMachine.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Input/InputSystem.hpp"
@@ -257,13 +260,11 @@ void Game2DPachinkoMachine::UpdateCameras()
 
 void Game2DPachinkoMachine::DrawUsage() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	verts.reserve(500);
 	AABB2 usageBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.91f, SCREEN_SIZE_X * 0.9995f, SCREEN_SIZE_Y * 0.99f);
 	Vec2 alignment(0.f, 1.f);
 	float cellAspect = 0.6f;
-	BitmapFont* testFont = nullptr;
-	testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 
 	std::string usageText = Stringf(PachinkoMachine::README_TEXT, (int)m_balls.size(), m_ballElasticity, (m_isBottomWallPresent? "on" : "off"));
 	std::string usageText2;
@@ -279,8 +280,8 @@ void Game2DPachinkoMachine::DrawUsage() const
 
 	std::string usageText3 = "\nR/U rotate, W/O zoom";
 
-	testFont->AddVertsForTextInBox2D(verts, GAME_TEXT + '\n' + usageText + usageText2 + usageText3, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&testFont->GetTexture());
+	g_textLayoutCache.AddVertsForTextInBox2D(verts, *m_font, GAME_TEXT + '\n' + usageText + usageText2 + usageText3, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
+	g_theRenderer->BindTexture(&m_font->GetTexture());
 
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -441,6 +442,7 @@ void Game2DPachinkoMachine::HandleInputCameraAndGravityDirection()
 
 void Game2DPachinkoMachine::UpdatePhysics(float deltaSeconds)
 {
+	PROFILE_FUNCTION();
 	ApplyGravityAndMoveBalls(deltaSeconds);
 	BounceBalls();
 	BounceBallsWithBumpers();
@@ -570,6 +572,7 @@ void Game2DPachinkoMachine::SpawnBall()
 
 void Game2DPachinkoMachine::DrawObjects() const
 {
+	PROFILE_FUNCTION();
 	g_theRenderer->BindTexture(nullptr);
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -580,7 +583,7 @@ void Game2DPachinkoMachine::DrawObjects() const
 
 	g_theRenderer->DrawVertexArray(m_bumperVerts);
 
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	verts.reserve(m_balls.size() * 96 + 32 * 12 + 12);
 	AddVertsForWalls(verts);
 	AddVertsForBalls(verts);
@@ -615,7 +618,7 @@ void Game2DPachinkoMachine::DrawPachinkoMachine() const
 {
 	if (m_isBottomWallPresent)
 	{
-		std::vector<Vertex_PCU> verts;
+		std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 		AddVertsForAABB2D(verts, AABB2(m_leftWallX, m_bottomWallY - SCREEN_SIZE_X * 0.125f, m_rightWallX, m_bottomWallY), Rgba8::OPAQUE_WHITE);
 
@@ -1,4 +1,11 @@
 #include "Game/Game3DCurves.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/PrimitiveMeshes.hpp"
+#include "Game/SplineBuilder.hpp"
+#include "Game/SplineTessellation.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/DebugRender.hpp"
 
 #include "Engine/Core/Clock.hpp"
@@ -9,7 +16,10 @@
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 
-static const char* G3C_TEXT = "Splines (3D):";
+static const char* G3C_TEXT = "Splines (3D): C = constant speed (%s), F = followers (%d)";
+static constexpr float G3C_TUBE_THICKNESS = 0.1f;
+static constexpr float G3C_FLATNESS_TOLERANCE = G3C_TUBE_THICKNESS * 0.25f; // half the tube radius, chords never leave the tube
+static constexpr int G3C_MANY_FOLLOWERS = 32;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -50,6 +60,8 @@ void Game3DCurves::Update()
 
 	HandleInput();
 	UpdatePlayer();
+	UpdateSplineVerts();
+	UpdateFollowers();
 
 	UpdateCameras();
 }
@@ -78,10 +90,7 @@ void Game3DCurves::RandomizeSceneObjects()
 	{
 		spline1Points.push_back(GetRandomPosInsideBox(m_splineBoxs[0]));
 	}
-	BubbleSort(spline1Points);
-
-	m_spline1.ClearAllSplinePoints();
-	m_spline1.SetFromCatmullRomAlgorithm(spline1Points, true);
+	BuildCatmullRomSplineFromUnsortedPoints(m_spline1, spline1Points, true);
 
 	for (int i = 0; i < numPoints; ++i)
 	{
@@ -91,6 +100,9 @@ void Game3DCurves::RandomizeSceneObjects()
 
 
 	m_spline1.UpdateSpline();
+	m_spline1ArcLengths.Build(m_spline1);
+	m_spline1Evaluator.Build(m_spline1);
+	++m_splineVersion;
 }
 
 void Game3DCurves::UpdateCameras()
@@ -101,16 +113,14 @@ void Game3DCurves::UpdateCameras()
 
 void Game3DCurves::DrawUsage() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	AABB2 usageBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.93f, SCREEN_SIZE_X * 0.9995f, SCREEN_SIZE_Y * 0.99f);
 	Vec2 alignment(0.f, 1.f);
 	float cellAspect = 0.6f;
-	BitmapFont* testFont = nullptr;
-	testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 
-	std::string usageText = Stringf(G3C_TEXT);
-	testFont->AddVertsForTextInBox2D(verts, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&testFont->GetTexture());
+	std::string usageText = Stringf(G3C_TEXT, m_isConstantSpeed ? "on" : "off", m_numFollowers);
+	g_textLayoutCache.AddVertsForTextInBox2D(verts, *m_font, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
+	g_theRenderer->BindTexture(&m_font->GetTexture());
 
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -197,7 +207,14 @@ void Game3DCurves::UpdatePlayerCameraCenterAxis()
 
 void Game3DCurves::HandleInput()
 {
-
+	if (g_theInput->WasKeyJustPressed(KEYCODE_C))
+	{
+		m_isConstantSpeed = !m_isConstantSpeed;
+	}
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F))
+	{
+		m_numFollowers = (m_numFollowers == 1) ? G3C_MANY_FOLLOWERS : 1;
+	}
 }
 
 void Game3DCurves::InitializeModel()
@@ -235,43 +252,32 @@ Vec3 Game3DCurves::GetRandomVec3FromZeroToOne() const
 	return Vec3(g_rng.RollRandomFloatZeroToOne(), g_rng.RollRandomFloatZeroToOne(), g_rng.RollRandomFloatZeroToOne());
 }
 
-void Game3DCurves::BubbleSort(std::vector<Vec3>& points)
+void Game3DCurves::UpdateSplineVerts()
 {
-	int n = (int)points.size();
-	bool swapped;
-
-	for (int i = 0; i < n - 1; ++i)
+	PROFILE_FUNCTION();
+	if (m_splineVertsVersion == m_splineVersion)
 	{
-		swapped = false;
-		for (int j = 0; j < n - i - 1; ++j) {
-			if (points[j].x > points[j + 1].x) {
-				Vec3 temp = points[j];
-				points[j] = points[j + 1];
-				points[j + 1] = temp;
-
-				swapped = true;
-			}
-		}
-
-		if (!swapped) {
-			break;
-		}
+		return;
 	}
-}
-
-void Game3DCurves::DrawSplines() const
-{
-	std::vector<Vertex_PCU> splineVerts;
+	m_splineVertsVersion = m_splineVersion;
 
+	m_splineVerts.clear();
 	std::vector<Vec3> splinePoints;
-	m_spline1.GetPositionListWithSubdivisions(splinePoints, 10);
-	AddVertsForScratchyLines(splineVerts, splinePoints, 0.1f, DARK_BLUE);
+	GetAdaptivePositionListForSpline(m_spline1, splinePoints, G3C_FLATNESS_TOLERANCE);
+	AddVertsForScratchyLines(m_splineVerts, splinePoints, G3C_TUBE_THICKNESS, DARK_BLUE);
 	m_spline1.GetPositionListWithSubdivisions(splinePoints, 1);
+	std::vector<PrimitiveInstance> pointSpheres(splinePoints.size());
 	for (int i = 0; i < (int)splinePoints.size(); ++i)
 	{
-		AddVertsForSphere3D(splineVerts, splinePoints[i], 0.15f, ORANGE, AABB2::ZERO_TO_ONE, 8, 4);
+		pointSpheres[i].m_start = splinePoints[i];
+		pointSpheres[i].m_radius = 0.15f;
+		pointSpheres[i].m_color = ORANGE;
 	}
+	AddVertsForPrimitiveInstances(m_splineVerts, PRIMITIVE_MESH_SPHERE_3D, PRIMITIVE_MESH_LOD_LOW, (int)pointSpheres.size(), pointSpheres.data());
+}
 
+void Game3DCurves::DrawSplines() const
+{
 	g_theRenderer->SetModelConstants();
 	g_theRenderer->BindTexture(nullptr);
 	g_theRenderer->BindShader(nullptr);
@@ -279,7 +285,7 @@ void Game3DCurves::DrawSplines() const
 	g_theRenderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
 	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
 	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-	g_theRenderer->DrawVertexArray(splineVerts);
+	g_theRenderer->DrawVertexArray(m_splineVerts);
 }
 
 void Game3DCurves::DrawObjects() const
@@ -291,20 +297,99 @@ void Game3DCurves::DrawObjects() const
 	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
 	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
 
-	Mat44 modelTransform;
-
-	float inputKey1 = GetCurrentFraction(m_spline1.GetNumberOfSplineSegments());
-	Game3DCurvesTransform transform1;
-	transform1.m_position = m_spline1.GetPositionAtInputKey(inputKey1);
-	transform1.m_rotation = m_spline1.GetQuaternionAtInputKey(inputKey1);
-	transform1.m_scale = m_spline1.GetScaleAtInputKey(inputKey1);
+	for (int followerIndex = 0; followerIndex < m_followerSamples.m_numSamples; ++followerIndex)
+	{
+		Game3DCurvesTransform transform;
+		transform.m_position = m_followerSamples.GetPosition(followerIndex);
+		transform.m_rotation = m_followerSamples.GetRotation(followerIndex);
+		transform.m_scale = m_followerSamples.GetScale(followerIndex);
+
+		// Translation Rotation Scale
+		Mat44 modelTransform = Mat44::MakeFromUnitQuat(transform.m_rotation);
+		modelTransform.AppendScaleNonUniform3D(transform.m_scale);
+		modelTransform.SetTranslation3D(transform.m_position);
+
+		g_theRenderer->SetModelConstants(modelTransform);
+		g_theRenderer->DrawVertexArray(m_modelVerts);
+	}
+}
 
-	// Translation Rotation Scale
-	modelTransform = Mat44::MakeFromUnitQuat(transform1.m_rotation);
-	modelTransform.AppendScaleNonUniform3D(transform1.m_scale);
-	modelTransform.SetTranslation3D(transform1.m_position);
+void Game3DCurves::UpdateFollowers()
+{
+	PROFILE_FUNCTION();
+	// Followers are spread evenly along the spline, all evaluated in one batch
+	int numSegments = m_spline1.GetNumberOfSplineSegments();
+	float duration = static_cast<float>(numSegments);
+	float leadKey = GetCurrentFraction(numSegments);
+	float followerSpacing = duration / static_cast<float>(m_numFollowers);
+	m_followerKeys.resize(m_numFollowers);
+	for (int followerIndex = 0; followerIndex < m_numFollowers; ++followerIndex)
+	{
+		float inputKey = fmodf(leadKey + static_cast<float>(followerIndex) * followerSpacing, duration);
+		if (m_isConstantSpeed)
+		{
+			float distance = inputKey / duration * m_spline1ArcLengths.GetSplineLength();
+			inputKey = m_spline1ArcLengths.GetInputKeyAtDistance(m_spline1, distance);
+		}
+		m_followerKeys[followerIndex] = inputKey;
+	}
+	m_spline1Evaluator.Evaluate(m_numFollowers, m_followerKeys.data(), m_followerSamples);
+}
 
-	g_theRenderer->SetModelConstants(modelTransform);
-	g_theRenderer->DrawVertexArray(m_modelVerts);
+void Game3DCurves::RunBenchmarks(BenchmarkReport& report)
+{
+	RunFollowerBenchmark(report);
 }
 
+void Game3DCurves::RunFollowerBenchmark(BenchmarkReport& report) const
+{
+	// Random keys, one Get*AtInputKey call per channel per key against one batched Evaluate
+	constexpr int NUM_KEYS = 50000;
+	constexpr int NUM_ROUNDS = 20;
+	float duration = static_cast<float>(m_spline1.GetNumberOfSplineSegments());
+	std::vector<float> inputKeys(NUM_KEYS);
+	for (int keyIndex = 0; keyIndex < NUM_KEYS; ++keyIndex)
+	{
+		inputKeys[keyIndex] = g_rng.RollRandomFloatInRange(0.f, duration);
+	}
+
+	std::vector<Game3DCurvesTransform> transforms(NUM_KEYS);
+	BenchmarkTimer perCallTimer;
+	for (int roundIndex = 0; roundIndex < NUM_ROUNDS; ++roundIndex)
+	{
+		for (int keyIndex = 0; keyIndex < NUM_KEYS; ++keyIndex)
+		{
+			transforms[keyIndex].m_position = m_spline1.GetPositionAtInputKey(inputKeys[keyIndex]);
+			transforms[keyIndex].m_rotation = m_spline1.GetQuaternionAtInputKey(inputKeys[keyIndex]);
+			transforms[keyIndex].m_scale = m_spline1.GetScaleAtInputKey(inputKeys[keyIndex]);
+		}
+	}
+	double perCallMilliseconds = perCallTimer.GetElapsedMilliseconds() / NUM_ROUNDS;
+
+	SplineSamples3D samples;
+	BenchmarkTimer batchedTimer;
+	for (int roundIndex = 0; roundIndex < NUM_ROUNDS; ++roundIndex)
+	{
+		m_spline1Evaluator.Evaluate(NUM_KEYS, inputKeys.data(), samples);
+	}
+	double batchedMilliseconds = batchedTimer.GetElapsedMilliseconds() / NUM_ROUNDS;
+
+	float maxPositionError = 0.f;
+	float maxScaleError = 0.f;
+	float maxAngleErrorDegrees = 0.f;
+	for (int keyIndex = 0; keyIndex < NUM_KEYS; ++keyIndex)
+	{
+		Game3DCurvesTransform const& transform = transforms[keyIndex];
+		maxPositionError = fmaxf(maxPositionError, (transform.m_position - samples.GetPosition(keyIndex)).GetLength());
+		maxScaleError = fmaxf(maxScaleError, (transform.m_scale - samples.GetScale(keyIndex)).GetLength());
+		Quat rotation = samples.GetRotation(keyIndex);
+		float dot = transform.m_rotation.x * rotation.x + transform.m_rotation.y * rotation.y + transform.m_rotation.z * rotation.z + transform.m_rotation.w * rotation.w;
+		float angleDegrees = 2.f * ConvertRadiansToDegrees(acosf(GetClamped(fabsf(dot), 0.f, 1.f)));
+		maxAngleErrorDegrees = fmaxf(maxAngleErrorDegrees, angleDegrees);
+	}
+
+	report.AddSection(Stringf("Spline followers, %d random keys per frame", NUM_KEYS));
+	report.AddLine(Stringf("Per-call Get*AtInputKey %7.3f ms", perCallMilliseconds));
+	report.AddLine(Stringf("Batched Evaluate        %7.3f ms (x%.2f)", batchedMilliseconds, perCallMilliseconds / batchedMilliseconds));
+	report.AddLine(Stringf("Max error: position %.5f, scale %.5f, rotation %.3f degrees", maxPositionError, maxScaleError, maxAngleErrorDegrees));
+}
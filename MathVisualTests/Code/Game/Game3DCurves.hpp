@@ -1,5 +1,7 @@
 #pragma once
 #include "Game/Game.hpp"
+#include "Game/SplineArcLengthTable.hpp"
+#include "Game/SplineEvaluator3D.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/Spline.hpp"
@@ -21,6 +23,7 @@ public:
 	virtual void Update() override;
 	virtual void Render() const override;
 	virtual void RandomizeSceneObjects() override;
+	virtual void RunBenchmarks(BenchmarkReport& report) override;
 
 protected:
 	virtual void UpdateCameras() override;
@@ -41,8 +44,10 @@ private:
 	Vec3 GetRandomPosInsideBox(AABB3 const& box) const;
 	Vec3 GetPositionInBoxCoords(AABB3 const& box, Vec3 const& point) const;
 	Vec3 GetRandomVec3FromZeroToOne() const;
-	void BubbleSort(std::vector<Vec3>& points);
 
+	void UpdateSplineVerts();
+	void UpdateFollowers();
+	void RunFollowerBenchmark(BenchmarkReport& report) const;
 	void DrawSplines() const;
 	void DrawObjects() const;
 
@@ -55,6 +60,17 @@ private:
 
 	AABB3 m_splineBoxs[3];
 	Spline3D m_spline1;
+	SplineArcLengthTable3D m_spline1ArcLengths; // rebuilt with the spline points
+	SplineEvaluator3D m_spline1Evaluator; // rebuilt with the spline points
+	bool m_isConstantSpeed = false;
+	int m_numFollowers = 1;
+	std::vector<float> m_followerKeys;
+	SplineSamples3D m_followerSamples;
+	int m_splineVersion = 0; // bumped whenever m_spline1 points change
+
+	// Tube and control point spheres, rebuilt by UpdateSplineVerts when the spline version changes
+	std::vector<Vertex_PCU> m_splineVerts;
+	int m_splineVertsVersion = -1;
 
 	std::vector<Vertex_PCU> m_modelVerts;
 	Texture* m_modelTexture = nullptr;
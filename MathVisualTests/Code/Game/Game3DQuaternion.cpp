@@ -1,4 +1,9 @@
 #include "Game/Game3DQuaternion.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/QuatArray.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/DebugRender.hpp"
 
 #include "Engine/Core/Clock.hpp"
@@ -13,6 +18,25 @@
 static const char* G2PACHINKO_TEXT = "Quaternion (3D):";
 
 
+//-----------------------------------------------------------------------------------------------
+// Angle between the rotations two quats represent, either may be non unit (Lerp)
+static float GetAngleBetweenQuatsDegrees(Quat a, Quat b)
+{
+	a.Normalize();
+	b.Normalize();
+	float dot = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	float sign = (dot < 0.f) ? -1.f : 1.f;
+
+	// Chord length keeps its precision for tiny angles where acos(dot) does not
+	float dx = a.x - sign * b.x;
+	float dy = a.y - sign * b.y;
+	float dz = a.z - sign * b.z;
+	float dw = a.w - sign * b.w;
+	float halfChord = 0.5f * sqrtf(dx * dx + dy * dy + dz * dz + dw * dw);
+	return 4.f * ConvertRadiansToDegrees(asinf(GetClamped(halfChord, 0.f, 1.f)));
+}
+
+
 //-----------------------------------------------------------------------------------------------
 Game3DQuaternion::Game3DQuaternion()
 {
@@ -66,6 +90,7 @@ void Game3DQuaternion::RandomizeSceneObjects()
 		m_quatList[i] = Quat(g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f));
 		m_quatList[i].Normalize();
 	}
+	m_squadTrack.SetUniformKeys(std::vector<Quat>(m_quatList, m_quatList + size), 1.f);
 }
 
 void Game3DQuaternion::UpdateCameras()
@@ -76,16 +101,14 @@ void Game3DQuaternion::UpdateCameras()
 
 void Game3DQuaternion::DrawUsage() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	AABB2 usageBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.93f, SCREEN_SIZE_X * 0.9995f, SCREEN_SIZE_Y * 0.99f);
 	Vec2 alignment(0.f, 1.f);
 	float cellAspect = 0.6f;
-	BitmapFont* testFont = nullptr;
-	testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 
 	std::string usageText = Stringf(G2PACHINKO_TEXT);
-	testFont->AddVertsForTextInBox2D(verts, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&testFont->GetTexture());
+	g_textLayoutCache.AddVertsForTextInBox2D(verts, *m_font, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
+	g_theRenderer->BindTexture(&m_font->GetTexture());
 
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -206,10 +229,15 @@ void Game3DQuaternion::InitializeTransforms()
 	m_slerpFullPath.m_position = Vec3::FORWARD * (static_cast<float>(index) * MODEL_SPACING);
 	DebugAddWorldBillboardText("Slerp Full Path", m_slerpFullPath.m_position + LABEL_OFFSET, 0.125f, -1.f, 0.7f, Vec2(0.5f, 0.5f));
 	index++;
+
+	m_squad.m_position = Vec3::FORWARD * (static_cast<float>(index) * MODEL_SPACING);
+	DebugAddWorldBillboardText("Squad", m_squad.m_position + LABEL_OFFSET, 0.125f, -1.f, 0.7f, Vec2(0.5f, 0.5f));
+	index++;
 }
 
 void Game3DQuaternion::UpdateObjects()
 {
+	PROFILE_FUNCTION();
 	constexpr float FREQUENCY = 0.4f;
 	int size = (int)(sizeof(m_quatList) / sizeof(m_quatList[0]));
 	float currentSeconds = (float)m_clock->GetTotalSeconds();
@@ -224,6 +252,7 @@ void Game3DQuaternion::UpdateObjects()
 	m_slerp.m_rotation			= Quat::Slerp(q0, q1, t);
 	m_nlerpFullPath.m_rotation	= Quat::Nlerp(q0, q1, t, false);
 	m_slerpFullPath.m_rotation	= Quat::SlerpFullPath(q0, q1, t);
+	m_squad.m_rotation			= m_squadTrack.Sample(currentKey);
 
 
 	// Debug Axis
@@ -254,6 +283,10 @@ void Game3DQuaternion::UpdateObjects()
 	DebugAddWorldArrow(m_slerpFullPath.m_position, startAxis + m_slerpFullPath.m_position, AXIS_RADIUS, 0.f, START_COLOR, START_COLOR, DebugRenderMode::X_RAY);
 	DebugAddWorldArrow(m_slerpFullPath.m_position, endAxis + m_slerpFullPath.m_position, AXIS_RADIUS, 0.f, END_COLOR, END_COLOR, DebugRenderMode::X_RAY);
 	DebugAddWorldArrow(m_slerpFullPath.m_position, m_slerpFullPath.m_rotation.GetRotationAxis() + m_slerpFullPath.m_position, AXIS_RADIUS, 0.f, LERP_COLOR, LERP_COLOR, DebugRenderMode::X_RAY);
+
+	DebugAddWorldArrow(m_squad.m_position, startAxis + m_squad.m_position, AXIS_RADIUS, 0.f, START_COLOR, START_COLOR, DebugRenderMode::X_RAY);
+	DebugAddWorldArrow(m_squad.m_position, endAxis + m_squad.m_position, AXIS_RADIUS, 0.f, END_COLOR, END_COLOR, DebugRenderMode::X_RAY);
+	DebugAddWorldArrow(m_squad.m_position, m_squad.m_rotation.GetRotationAxis() + m_squad.m_position, AXIS_RADIUS, 0.f, LERP_COLOR, LERP_COLOR, DebugRenderMode::X_RAY);
 }
 
 void Game3DQuaternion::DrawObjects() const
@@ -292,6 +325,11 @@ void Game3DQuaternion::DrawObjects() const
 	modelTransform.SetTranslation3D(m_slerpFullPath.m_position);
 	g_theRenderer->SetModelConstants(modelTransform);
 	g_theRenderer->DrawVertexArray(m_modelVerts);
+
+	modelTransform = Mat44::MakeFromUnitQuat(m_squad.m_rotation);
+	modelTransform.SetTranslation3D(m_squad.m_position);
+	g_theRenderer->SetModelConstants(modelTransform);
+	g_theRenderer->DrawVertexArray(m_modelVerts);
 }
 
 void Game3DQuaternion::HandleInput()
@@ -299,3 +337,162 @@ void Game3DQuaternion::HandleInput()
 
 }
 
+void Game3DQuaternion::RunBenchmarks(BenchmarkReport& report)
+{
+	RunInterpolationBenchmark(report);
+	RunTrackBenchmark(report);
+}
+
+void Game3DQuaternion::RunTrackBenchmark(BenchmarkReport& report) const
+{
+	// Many random tracks, each sampled once per round, as an animation system would per frame
+	constexpr int NUM_TRACKS = 20000;
+	constexpr int NUM_KEYS = 10;
+	constexpr int NUM_ROUNDS = 10;
+	std::vector<QuatTrack> uniformTracks(NUM_TRACKS);
+	std::vector<QuatTrack> nonUniformTracks(NUM_TRACKS);
+	std::vector<Quat> keyRotations(NUM_KEYS);
+	std::vector<float> keyTimes(NUM_KEYS);
+	for (int trackIndex = 0; trackIndex < NUM_TRACKS; ++trackIndex)
+	{
+		float keyTime = 0.f;
+		for (int keyIndex = 0; keyIndex < NUM_KEYS; ++keyIndex)
+		{
+			keyRotations[keyIndex] = Quat(g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f));
+			keyRotations[keyIndex].Normalize();
+			keyTimes[keyIndex] = keyTime;
+			keyTime += g_rng.RollRandomFloatInRange(0.5f, 1.5f);
+		}
+		uniformTracks[trackIndex].SetUniformKeys(keyRotations, 1.f);
+		nonUniformTracks[trackIndex].SetKeys(keyTimes, keyRotations);
+	}
+	std::vector<float> times(NUM_TRACKS);
+	for (int trackIndex = 0; trackIndex < NUM_TRACKS; ++trackIndex)
+	{
+		times[trackIndex] = g_rng.RollRandomFloatInRange(0.f, static_cast<float>(NUM_KEYS - 1));
+	}
+
+	report.AddSection(Stringf("Squad tracks, %d tracks x %d keys, Msamples/s", NUM_TRACKS, NUM_KEYS));
+	report.AddLine("                 Scalar  Batched  Max error (degrees)");
+	std::vector<Quat> scalarResults(NUM_TRACKS);
+	QuatArray batchedResults;
+	QuatTrackBatchSampler batchSampler;
+	for (int trackSetIndex = 0; trackSetIndex < 2; ++trackSetIndex)
+	{
+		std::vector<QuatTrack> const& tracks = (trackSetIndex == 0) ? uniformTracks : nonUniformTracks;
+		BenchmarkTimer scalarTimer;
+		for (int roundIndex = 0; roundIndex < NUM_ROUNDS; ++roundIndex)
+		{
+			for (int trackIndex = 0; trackIndex < NUM_TRACKS; ++trackIndex)
+			{
+				scalarResults[trackIndex] = tracks[trackIndex].Sample(times[trackIndex]);
+			}
+		}
+		double scalarSeconds = scalarTimer.GetElapsedSeconds();
+
+		BenchmarkTimer batchedTimer;
+		for (int roundIndex = 0; roundIndex < NUM_ROUNDS; ++roundIndex)
+		{
+			batchSampler.Sample(NUM_TRACKS, tracks.data(), times.data(), batchedResults);
+		}
+		double batchedSeconds = batchedTimer.GetElapsedSeconds();
+
+		float maxErrorDegrees = 0.f;
+		for (int trackIndex = 0; trackIndex < NUM_TRACKS; ++trackIndex)
+		{
+			maxErrorDegrees = fmaxf(maxErrorDegrees, GetAngleBetweenQuatsDegrees(scalarResults[trackIndex], batchedResults.GetQuat(trackIndex)));
+		}
+
+		double numSamples = static_cast<double>(NUM_TRACKS) * static_cast<double>(NUM_ROUNDS);
+		double scalarMillionsPerSecond = 1e-6 * numSamples / scalarSeconds;
+		double batchedMillionsPerSecond = 1e-6 * numSamples / batchedSeconds;
+		report.AddLine(Stringf("%-16s %7.1f  %7.1f  %.5f", (trackSetIndex == 0) ? "Uniform keys" : "Non-uniform keys", scalarMillionsPerSecond, batchedMillionsPerSecond, maxErrorDegrees));
+	}
+}
+
+void Game3DQuaternion::RunInterpolationBenchmark(BenchmarkReport& report) const
+{
+	// Random unit quat pairs and fractions, each scalar Quat function against its batched version
+	constexpr int NUM_QUATS = 200000;
+	QuatArray startQuats;
+	QuatArray endQuats;
+	startQuats.Resize(NUM_QUATS);
+	endQuats.Resize(NUM_QUATS);
+	std::vector<float> fractions(NUM_QUATS);
+	for (int quatIndex = 0; quatIndex < NUM_QUATS; ++quatIndex)
+	{
+		Quat startQuat(g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f));
+		Quat endQuat(g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f), g_rng.RollRandomFloatInRange(-1.f, 1.f));
+		startQuat.Normalize();
+		endQuat.Normalize();
+		startQuats.SetQuat(quatIndex, startQuat);
+		endQuats.SetQuat(quatIndex, endQuat);
+		fractions[quatIndex] = g_rng.RollRandomFloatZeroToOne();
+	}
+
+	enum InterpolationType
+	{
+		INTERPOLATION_LERP,
+		INTERPOLATION_NLERP,
+		INTERPOLATION_SLERP,
+		INTERPOLATION_SLERP_FULL_PATH,
+	};
+	struct BenchmarkCase
+	{
+		char const* m_name;
+		InterpolationType m_type;
+		SlerpAccuracy m_accuracy;
+	};
+	BenchmarkCase const benchmarkCases[] = {
+		{ "Lerp",                   INTERPOLATION_LERP,				SLERP_ACCURACY_PRECISE },
+		{ "Nlerp",                  INTERPOLATION_NLERP,			SLERP_ACCURACY_PRECISE },
+		{ "Slerp fast",             INTERPOLATION_SLERP,			SLERP_ACCURACY_FAST },
+		{ "Slerp precise",          INTERPOLATION_SLERP,			SLERP_ACCURACY_PRECISE },
+		{ "SlerpFullPath fast",     INTERPOLATION_SLERP_FULL_PATH,	SLERP_ACCURACY_FAST },
+		{ "SlerpFullPath precise",  INTERPOLATION_SLERP_FULL_PATH,	SLERP_ACCURACY_PRECISE },
+	};
+
+	std::vector<Quat> scalarResults(NUM_QUATS);
+	QuatArray batchedResults;
+	report.AddSection(Stringf("Quaternion interpolation, %d pairs, Mquats/s", NUM_QUATS));
+	report.AddLine("                       Scalar  Batched  Max error (degrees)");
+	for (BenchmarkCase const& benchmarkCase : benchmarkCases)
+	{
+		BenchmarkTimer scalarTimer;
+		for (int quatIndex = 0; quatIndex < NUM_QUATS; ++quatIndex)
+		{
+			Quat startQuat = startQuats.GetQuat(quatIndex);
+			Quat endQuat = endQuats.GetQuat(quatIndex);
+			float fraction = fractions[quatIndex];
+			switch (benchmarkCase.m_type)
+			{
+			case INTERPOLATION_LERP:			scalarResults[quatIndex] = Quat::Lerp(startQuat, endQuat, fraction); break;
+			case INTERPOLATION_NLERP:			scalarResults[quatIndex] = Quat::Nlerp(startQuat, endQuat, fraction); break;
+			case INTERPOLATION_SLERP:			scalarResults[quatIndex] = Quat::Slerp(startQuat, endQuat, fraction); break;
+			case INTERPOLATION_SLERP_FULL_PATH:	scalarResults[quatIndex] = Quat::SlerpFullPath(startQuat, endQuat, fraction); break;
+			}
+		}
+		double scalarSeconds = scalarTimer.GetElapsedSeconds();
+
+		BenchmarkTimer batchedTimer;
+		switch (benchmarkCase.m_type)
+		{
+		case INTERPOLATION_LERP:			LerpQuatArrays(startQuats, endQuats, fractions.data(), batchedResults); break;
+		case INTERPOLATION_NLERP:			NlerpQuatArrays(startQuats, endQuats, fractions.data(), batchedResults); break;
+		case INTERPOLATION_SLERP:			SlerpQuatArrays(startQuats, endQuats, fractions.data(), batchedResults, benchmarkCase.m_accuracy); break;
+		case INTERPOLATION_SLERP_FULL_PATH:	SlerpFullPathQuatArrays(startQuats, endQuats, fractions.data(), batchedResults, benchmarkCase.m_accuracy); break;
+		}
+		double batchedSeconds = batchedTimer.GetElapsedSeconds();
+
+		float maxErrorDegrees = 0.f;
+		for (int quatIndex = 0; quatIndex < NUM_QUATS; ++quatIndex)
+		{
+			maxErrorDegrees = fmaxf(maxErrorDegrees, GetAngleBetweenQuatsDegrees(scalarResults[quatIndex], batchedResults.GetQuat(quatIndex)));
+		}
+
+		double scalarMillionsPerSecond = 1e-6 * static_cast<double>(NUM_QUATS) / scalarSeconds;
+		double batchedMillionsPerSecond = 1e-6 * static_cast<double>(NUM_QUATS) / batchedSeconds;
+		report.AddLine(Stringf("%-22s %7.1f  %7.1f  %.5f", benchmarkCase.m_name, scalarMillionsPerSecond, batchedMillionsPerSecond, maxErrorDegrees));
+	}
+}
+
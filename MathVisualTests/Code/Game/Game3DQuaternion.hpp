@@ -1,5 +1,6 @@
 #pragma once
 #include "Game/Game.hpp"
+#include "Game/QuatTrack.hpp"
 #include "Engine/Math/Quat.hpp"
 #include "Engine/Renderer/Camera.hpp"
 
@@ -21,6 +22,7 @@ public:
 	virtual void Update() override;
 	virtual void Render() const override;
 	virtual void RandomizeSceneObjects() override;
+	virtual void RunBenchmarks(BenchmarkReport& report) override;
 
 protected:
 	virtual void UpdateCameras() override;
@@ -40,6 +42,8 @@ protected:
 
 private:
 	void HandleInput();
+	void RunInterpolationBenchmark(BenchmarkReport& report) const;
+	void RunTrackBenchmark(BenchmarkReport& report) const;
 
 private:
 	Camera m_screenCamera;
@@ -53,6 +57,7 @@ private:
 
 	// Quaternion List (random initialization play 0,1,2,3,0,1,2,3)
 	Quat m_quatList[10];
+	QuatTrack m_squadTrack; // the same keys one second apart, rebuilt with m_quatList
 
 	// CurrentQuaternion for each type
 	// Position for each type
@@ -62,6 +67,7 @@ private:
 	Game3DQuatTransform m_slerp;
 	Game3DQuatTransform m_nlerpFullPath;
 	Game3DQuatTransform m_slerpFullPath;
+	Game3DQuatTransform m_squad;
 
 
 };
\ No newline at end of file
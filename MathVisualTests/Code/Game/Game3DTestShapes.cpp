@@ -1,5 +1,10 @@
 #include "Game/Game3DTestShapes.hpp"
 #include "Game/App.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/PrimitiveMeshes.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/DebugRender.hpp"
 #include "Engine/Core/VertexUtils.hpp"
@@ -16,8 +21,10 @@ static constexpr int	LINE_SEGMENT_NUM = 20;
 static constexpr float LINE_SEGMENT_THICKNESS = 5.f;
 
 //const std::string G3D_TEXT = "Game3DTestShapes: WASD(fly horizontal), QE(fly vertical), space(lock/unlock raycast), LMB(grab/release object)";
-static const char* G3D_TEXT = "Game3DTestShapes: WASD(fly horizontal), QE(fly vertical), space(%s raycast)";
+static const char* G3D_TEXT = "Game3DTestShapes: WASD(fly horizontal), QE(fly vertical), space(%s raycast), G(%s shapes), B(%s broadphase)";
 static const float NEAREST_POINT_SPHERE_RADIUS = 0.05f;
+static constexpr int	NUM_STRESS_SHAPES = 10000;
+static constexpr float	STRESS_SCENE_HALF_SIZE = 60.f;
 
 //-----------------------------------------------------------------------------------------------
 Game3DTestShapes::Game3DTestShapes()
@@ -33,10 +40,6 @@ Game3DTestShapes::Game3DTestShapes()
 
 Game3DTestShapes::~Game3DTestShapes()
 {
-	for (TestShape* ptr : m_shapeList) {
-		delete ptr;
-	}
-	m_shapeList.clear();
 	DebugRenderClear();
 }
 
@@ -44,11 +47,20 @@ void Game3DTestShapes::Update()
 {
 	UpdateDeveloperCheats();
 
+	if (g_theInput->WasKeyJustPressed(KEYCODE_G))
+	{
+		m_isStressScene = !m_isStressScene;
+		RandomizeSceneObjects();
+	}
+	if (g_theInput->WasKeyJustPressed(KEYCODE_B))
+	{
+		m_isUsingSweepAndPrune = !m_isUsingSweepAndPrune;
+	}
 
-	for (TestShape* shape : m_shapeList)
+	for (TestShape& shape : m_shapeList)
 	{
-		shape->m_isSelected = false;
-		shape->m_isOverlapping = false;
+		shape.m_isSelected = false;
+		shape.m_isOverlapping = false;
 	}
 
 	UpdatePlayer();
@@ -84,16 +96,17 @@ void Game3DTestShapes::UpdateCameras()
 
 void Game3DTestShapes::DrawUsage() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	AABB2 usageBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.93f, SCREEN_SIZE_X * 0.9995f, SCREEN_SIZE_Y * 0.99f);
 	Vec2 alignment(0.f, 1.f);
 	float cellAspect = 0.6f;
-	BitmapFont* testFont = nullptr;
-	testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
 
 	const char* raycastText = (m_isRaycastLocked) ? "unlock" : "lock";
 
-	std::string usageText = Stringf(G3D_TEXT, raycastText);
+	const char* sceneText = (m_isStressScene) ? "few" : "10k";
+	const char* broadphaseText = (m_isUsingSweepAndPrune) ? "sweep and prune" : "AABB tree";
+
+	std::string usageText = Stringf(G3D_TEXT, raycastText, sceneText, broadphaseText);
 	if (m_grabbedObject != nullptr)
 	{
 		usageText += ", LMB(release object)";
@@ -103,8 +116,8 @@ void Game3DTestShapes::DrawUsage() const
 		usageText += ", LMB(grab object)";
 	}
 
-	testFont->AddVertsForTextInBox2D(verts, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&testFont->GetTexture());
+	g_textLayoutCache.AddVertsForTextInBox2D(verts, *m_font, GAME_TEXT + '\n' + usageText, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
+	g_theRenderer->BindTexture(&m_font->GetTexture());
 
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -205,11 +218,14 @@ void Game3DTestShapes::UpdateGrabAndLock()
 		{
 			m_grabbedObject->m_position = m_camera.GetCameraToWorldTransform().TransformPosition3D(m_grabbedObjectCameraSpacePosition);
 			UpdateGrabbedOBB();
+			m_grabbedObject->UpdateWorldShape();
+			UpdateBroadphaseProxies(m_grabbedObject);
 		}
 		else
 		{
 			Vec3 newPosOnPlane = m_camera.GetCameraToWorldTransform().TransformPosition3D(m_grabbedObjectCameraSpacePosition);
 			m_grabbedObject->m_plane.MoveToPoint(newPosOnPlane);
+			UpdateBroadphaseProxies(m_grabbedObject);
 		}
 
 
@@ -286,21 +302,341 @@ void Game3DTestShapes::UpdateGrabbedOBB()
 	// Debug Draw?
 }
 
+void Game3DTestShapes::RebuildBroadphases()
+{
+	m_shapeTree.Clear();
+	m_sweepAndPrune.Clear();
+	m_infiniteShapeIndexes.clear();
+
+	int numShapes = (int)m_shapeList.size();
+	for (int shapeIndex = 0; shapeIndex < numShapes; ++shapeIndex)
+	{
+		TestShape* shape = &m_shapeList[shapeIndex];
+		if (shape->IsInfinite())
+		{
+			shape->m_proxyId = -1;
+			shape->m_sweepAndPruneProxyId = m_sweepAndPrune.CreateInfiniteProxy(shape->m_plane, shapeIndex);
+			m_infiniteShapeIndexes.push_back(shapeIndex);
+		}
+		else
+		{
+			AABB3 const& bounds = shape->GetWorldBounds();
+			shape->m_proxyId = m_shapeTree.CreateProxy(bounds, shapeIndex);
+			shape->m_sweepAndPruneProxyId = m_sweepAndPrune.CreateProxy(bounds, shapeIndex);
+		}
+	}
+}
+
+void Game3DTestShapes::UpdateBroadphaseProxies(TestShape* shape)
+{
+	if (shape->IsInfinite())
+	{
+		m_sweepAndPrune.MoveInfiniteProxy(shape->m_sweepAndPruneProxyId, shape->m_plane);
+		return;
+	}
+
+	AABB3 const& bounds = shape->GetWorldBounds();
+	m_shapeTree.MoveProxy(shape->m_proxyId, bounds);
+	m_sweepAndPrune.MoveProxy(shape->m_sweepAndPruneProxyId, bounds);
+}
+
 void Game3DTestShapes::CheckIfOverlapping()
 {
+	PROFILE_FUNCTION();
+	// Both broadphases are kept up to date, so switching between them needs no rebuild
+	m_sweepAndPrune.UpdatePairs();
+	if (m_isUsingSweepAndPrune)
+	{
+		CheckIfOverlappingWithSweepAndPrune();
+	}
+	else
+	{
+		CheckIfOverlappingWithTree();
+	}
+}
+
+void Game3DTestShapes::CheckIfOverlappingWithSweepAndPrune()
+{
+	// The narrowphase result of a pair is cached until one of its shapes moves
+	auto isOverlapping = [this](int shapeIndexA, int shapeIndexB) -> bool
+	{
+		return m_shapeList[shapeIndexA].IsOverlappingWithOtherShape(m_shapeList[shapeIndexB]);
+	};
 
-	for (int i = 0; i < m_shapeList.size(); ++i) 
+	m_overlapCandidatePairs.clear();
+	m_sweepAndPrune.QueryTouchingPairs(isOverlapping, m_overlapCandidatePairs);
+	for (std::pair<int, int> const& touchingPair : m_overlapCandidatePairs)
 	{
-		TestShape* shapeA = m_shapeList[i];
-		for (int j = i + 1; j < m_shapeList.size(); ++j)
+		m_shapeList[touchingPair.first].m_isOverlapping = true;
+		m_shapeList[touchingPair.second].m_isOverlapping = true;
+	}
+}
+
+void Game3DTestShapes::CheckIfOverlappingWithTree()
+{
+	// Broadphase candidates from the tree against itself, then the exact test
+	m_overlapCandidatePairs.clear();
+	m_shapeTree.QueryOverlappingPairs(m_overlapCandidatePairs);
+
+	for (std::pair<int, int> const& candidatePair : m_overlapCandidatePairs)
+	{
+		TestShape* shapeA = &m_shapeList[candidatePair.first];
+		TestShape* shapeB = &m_shapeList[candidatePair.second];
+		if (shapeA->IsOverlappingWithOtherShape(*shapeB))
+		{
+			shapeA->m_isOverlapping = true;
+			shapeB->m_isOverlapping = true;
+		}
+	}
+
+	// Planes are infinite, so they query the tree instead of living in it
+	for (int infiniteIndex = 0; infiniteIndex < (int)m_infiniteShapeIndexes.size(); ++infiniteIndex)
+	{
+		TestShape* plane = &m_shapeList[m_infiniteShapeIndexes[infiniteIndex]];
+
+		m_planeOverlapCandidates.clear();
+		m_shapeTree.QueryPlane(plane->m_plane, m_planeOverlapCandidates);
+		for (int shapeIndex : m_planeOverlapCandidates)
+		{
+			TestShape* shape = &m_shapeList[shapeIndex];
+			if (plane->IsOverlappingWithOtherShape(*shape))
+			{
+				plane->m_isOverlapping = true;
+				shape->m_isOverlapping = true;
+			}
+		}
+
+		for (int otherIndex = infiniteIndex + 1; otherIndex < (int)m_infiniteShapeIndexes.size(); ++otherIndex)
+		{
+			TestShape* otherPlane = &m_shapeList[m_infiniteShapeIndexes[otherIndex]];
+			if (plane->IsOverlappingWithOtherShape(*otherPlane))
+			{
+				plane->m_isOverlapping = true;
+				otherPlane->m_isOverlapping = true;
+			}
+		}
+	}
+}
+
+void Game3DTestShapes::RunBenchmarks(BenchmarkReport& report)
+{
+	RunOverlapBenchmark(report);
+	RunRaycastBenchmark(report);
+	RunPrimitiveMeshBenchmark(report);
+}
+
+void Game3DTestShapes::RunOverlapBenchmark(BenchmarkReport& report) const
+{
+	// Time the narrowphase alone, through the same dispatch CheckIfOverlapping uses
+	constexpr int NUM_SHAPES_PER_TYPE = 1024; // power of two, indexes are masked
+	constexpr int NUM_TESTS_PER_PAIR = 1000000;
+	Vec3 sceneDimensions = Vec3(5.f, 5.f, 5.f);
+
+	std::vector<TestShape> shapesByType[TestShape::eType_Plane3];
+	for (int typeIndex = 0; typeIndex < TestShape::eType_Plane3; ++typeIndex)
+	{
+		shapesByType[typeIndex].reserve(NUM_SHAPES_PER_TYPE);
+		for (int shapeIndex = 0; shapeIndex < NUM_SHAPES_PER_TYPE; ++shapeIndex)
 		{
-			TestShape* shapeB = m_shapeList[j];
-			if (shapeA->IsOverlappingWithOtherShape(*shapeB))
+			shapesByType[typeIndex].emplace_back(sceneDimensions, static_cast<TestShape::Type>(typeIndex), false);
+		}
+	}
+
+	struct BenchmarkPair
+	{
+		TestShape::Type m_typeA;
+		TestShape::Type m_typeB;
+		const char* m_name;
+	};
+	BenchmarkPair benchmarkPairs[] =
+	{
+		{ TestShape::eType_Sphere,		TestShape::eType_Sphere,	"Sphere vs Sphere" },
+		{ TestShape::eType_Sphere,		TestShape::eType_AABB3,		"Sphere vs AABB3" },
+		{ TestShape::eType_AABB3,		TestShape::eType_AABB3,		"AABB3 vs AABB3" },
+		{ TestShape::eType_Sphere,		TestShape::eType_OBB3,		"Sphere vs OBB3" },
+		{ TestShape::eType_OBB3,		TestShape::eType_OBB3,		"OBB3 vs OBB3 (SAT)" },
+		{ TestShape::eType_AABB3,		TestShape::eType_OBB3,		"AABB3 vs OBB3 (SAT)" },
+		{ TestShape::eType_ZCylinder,	TestShape::eType_OBB3,		"ZCylinder vs OBB3" },
+	};
+
+	report.AddSection(Stringf("Overlap tests, %d tests per pair", NUM_TESTS_PER_PAIR));
+	for (BenchmarkPair const& benchmarkPair : benchmarkPairs)
+	{
+		std::vector<TestShape> const& shapesA = shapesByType[benchmarkPair.m_typeA];
+		std::vector<TestShape> const& shapesB = shapesByType[benchmarkPair.m_typeB];
+
+		int numOverlaps = 0;
+		BenchmarkTimer timer;
+		for (int testIndex = 0; testIndex < NUM_TESTS_PER_PAIR; ++testIndex)
+		{
+			TestShape const& shapeA = shapesA[testIndex & (NUM_SHAPES_PER_TYPE - 1)];
+			TestShape const& shapeB = shapesB[(testIndex * 7 + testIndex / NUM_SHAPES_PER_TYPE) & (NUM_SHAPES_PER_TYPE - 1)];
+			if (shapeA.IsOverlappingWithOtherShape(shapeB))
 			{
-				shapeA->m_isOverlapping = true;
-				shapeB->m_isOverlapping = true;
+				++numOverlaps;
 			}
 		}
+		double nanosecondsPerTest = timer.GetElapsedNanoseconds() / static_cast<double>(NUM_TESTS_PER_PAIR);
+		float overlapPercent = 100.f * static_cast<float>(numOverlaps) / static_cast<float>(NUM_TESTS_PER_PAIR);
+		report.AddLine(Stringf("%-22s %7.2f ns/test (%4.1f%% overlapping)", benchmarkPair.m_name, nanosecondsPerTest, overlapPercent));
+	}
+}
+
+void Game3DTestShapes::BuildRaycastShapeSet(RaycastShapeSet3D& out_shapeSet) const
+{
+	out_shapeSet.Clear();
+	for (int shapeIndex = 0; shapeIndex < (int)m_shapeList.size(); ++shapeIndex)
+	{
+		TestShape const* shape = &m_shapeList[shapeIndex];
+		switch (shape->m_type)
+		{
+		case TestShape::eType_Sphere:		out_shapeSet.AddSphere(shape->m_position, shape->m_sphereRadius, shapeIndex); break;
+		case TestShape::eType_AABB3:		out_shapeSet.AddAABB3(shape->m_worldBox, shapeIndex); break;
+		case TestShape::eType_ZCylinder:	out_shapeSet.AddZCylinder(shape->m_worldCylinderCenterXY, shape->m_worldCylinderMinMaxZ, shape->m_cylinderRadius, shapeIndex); break;
+		case TestShape::eType_OBB3:			out_shapeSet.AddOBB3(shape->m_worldOBB, shapeIndex); break;
+		case TestShape::eType_Plane3:		out_shapeSet.AddPlane3(shape->m_plane, shapeIndex); break;
+		default:							break;
+		}
+	}
+}
+
+void Game3DTestShapes::RunRaycastBenchmark(BenchmarkReport& report) const
+{
+	// Same random rays through the current scene, every ray tested against every shape in both loops
+	constexpr int NUM_SHAPE_TESTS = 20000000;
+	int numShapes = (int)m_shapeList.size();
+	int numPackets = NUM_SHAPE_TESTS / (numShapes * RAY_PACKET_SIZE);
+	numPackets = (numPackets < 16) ? 16 : numPackets;
+	int numRays = numPackets * RAY_PACKET_SIZE;
+
+	float sceneHalfSize = m_isStressScene ? STRESS_SCENE_HALF_SIZE : 5.f;
+	std::vector<RayPacket3D> rayPackets(numPackets);
+	for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+	{
+		Vec3 rayStart;
+		rayStart.x = g_rng.RollRandomFloatInRange(-sceneHalfSize, sceneHalfSize);
+		rayStart.y = g_rng.RollRandomFloatInRange(-sceneHalfSize, sceneHalfSize);
+		rayStart.z = g_rng.RollRandomFloatInRange(-sceneHalfSize, sceneHalfSize);
+		Vec3 rayForwardNormal = Vec3::MakeFromPolarDegrees(g_rng.RollRandomFloatInRange(-90.f, 90.f), g_rng.RollRandomFloatInRange(-180.f, 180.f));
+		rayPackets[rayIndex / RAY_PACKET_SIZE].SetRay(rayIndex % RAY_PACKET_SIZE, rayStart, rayForwardNormal, m_rayLength);
+	}
+
+	// Scalar: the per-shape loop DoRaycast used before the tree
+	std::vector<RaycastResult3D> scalarResults(numRays);
+	BenchmarkTimer scalarTimer;
+	for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+	{
+		RayPacket3D const& packet = rayPackets[rayIndex / RAY_PACKET_SIZE];
+		int laneIndex = rayIndex % RAY_PACKET_SIZE;
+		Vec3 rayStart(packet.m_startX[laneIndex], packet.m_startY[laneIndex], packet.m_startZ[laneIndex]);
+		Vec3 rayForwardNormal(packet.m_fwdX[laneIndex], packet.m_fwdY[laneIndex], packet.m_fwdZ[laneIndex]);
+
+		RaycastResult3D& closestResult = scalarResults[rayIndex];
+		for (TestShape const& shape : m_shapeList)
+		{
+			RaycastResult3D result = shape.GetRaycastResult(rayStart, rayForwardNormal, m_rayLength);
+			if (result.m_didImpact && (!closestResult.m_didImpact || result.m_impactDist < closestResult.m_impactDist))
+			{
+				closestResult = result;
+			}
+		}
+	}
+	double scalarSeconds = scalarTimer.GetElapsedSeconds();
+
+	RaycastShapeSet3D shapeSet;
+	BuildRaycastShapeSet(shapeSet);
+	std::vector<RayPacketHits3D> packetHits(numPackets);
+	BenchmarkTimer packetTimer;
+	for (int packetIndex = 0; packetIndex < numPackets; ++packetIndex)
+	{
+		shapeSet.RaycastClosest(rayPackets[packetIndex], packetHits[packetIndex]);
+	}
+	double packetSeconds = packetTimer.GetElapsedSeconds();
+
+	int numImpacts = 0;
+	int numMismatches = 0;
+	for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+	{
+		RaycastResult3D const& scalarResult = scalarResults[rayIndex];
+		RaycastResult3D packetResult = packetHits[rayIndex / RAY_PACKET_SIZE].GetRaycastResult(rayPackets[rayIndex / RAY_PACKET_SIZE], rayIndex % RAY_PACKET_SIZE);
+		numImpacts += scalarResult.m_didImpact ? 1 : 0;
+		if (scalarResult.m_didImpact != packetResult.m_didImpact
+			|| (scalarResult.m_didImpact && fabsf(scalarResult.m_impactDist - packetResult.m_impactDist) > 0.001f))
+		{
+			++numMismatches;
+		}
+	}
+
+	double scalarRaysPerSecond = static_cast<double>(numRays) / scalarSeconds;
+	double packetRaysPerSecond = static_cast<double>(numRays) / packetSeconds;
+	report.AddSection(Stringf("Raycasts, %d rays vs %d shapes (%d hit)", numRays, numShapes, numImpacts));
+	report.AddLine(Stringf("Scalar per-shape loop  %10.0f rays/s", scalarRaysPerSecond));
+	report.AddLine(Stringf("%d-ray SoA packets      %10.0f rays/s (x%.2f)", RAY_PACKET_SIZE, packetRaysPerSecond, packetRaysPerSecond / scalarRaysPerSecond));
+	report.AddLine(Stringf("Mismatched closest hits %d", numMismatches));
+}
+
+void Game3DTestShapes::RunPrimitiveMeshBenchmark(BenchmarkReport& report) const
+{
+	// Random shapes through the engine tessellation, then the unit meshes with the scalar and SIMD transforms
+	constexpr int NUM_INSTANCES = 2000;
+	constexpr int NUM_REPEATS = 20;
+	constexpr PrimitiveMeshLOD BENCHMARK_LOD = PRIMITIVE_MESH_LOD_MEDIUM;
+
+	std::vector<PrimitiveInstance> instances(NUM_INSTANCES);
+	for (PrimitiveInstance& instance : instances)
+	{
+		instance.m_start = Vec3(g_rng.RollRandomFloatInRange(-5.f, 5.f), g_rng.RollRandomFloatInRange(-5.f, 5.f), g_rng.RollRandomFloatInRange(-5.f, 5.f));
+		instance.m_end = instance.m_start + Vec3::MakeFromPolarDegrees(g_rng.RollRandomFloatInRange(-90.f, 90.f), g_rng.RollRandomFloatInRange(-180.f, 180.f), g_rng.RollRandomFloatInRange(0.5f, 2.f));
+		instance.m_radius = g_rng.RollRandomFloatInRange(0.05f, 0.3f);
+		instance.m_color = Rgba8(static_cast<unsigned char>(g_rng.RollRandomIntInRange(0, 255)), 127, 255);
+	}
+
+	std::vector<Vertex_PCU> verts;
+	report.AddSection(Stringf("Primitive meshes, %d instances x %d, %d slices (Mverts/s)", NUM_INSTANCES, NUM_REPEATS, GetNumSlicesForPrimitiveMeshLOD(BENCHMARK_LOD)));
+	report.AddLine(Stringf("%-12s %10s %10s %10s", "", "Tessellate", "Scalar", "SIMD"));
+	for (int typeIndex = 0; typeIndex < NUM_PRIMITIVE_MESH_TYPES; ++typeIndex)
+	{
+		PrimitiveMeshType type = static_cast<PrimitiveMeshType>(typeIndex);
+
+		// The vertex list keeps its capacity, so every pass times vertex generation and not reallocation
+		size_t numTessellatedVerts = 0;
+		BenchmarkTimer tessellateTimer;
+		for (int repeatIndex = 0; repeatIndex < NUM_REPEATS; ++repeatIndex)
+		{
+			verts.clear();
+			for (PrimitiveInstance const& instance : instances)
+			{
+				AddVertsForPrimitiveTessellated(verts, type, BENCHMARK_LOD, instance);
+			}
+			numTessellatedVerts += verts.size();
+		}
+		double tessellateSeconds = tessellateTimer.GetElapsedSeconds();
+
+		size_t numScalarVerts = 0;
+		BenchmarkTimer scalarTimer;
+		for (int repeatIndex = 0; repeatIndex < NUM_REPEATS; ++repeatIndex)
+		{
+			verts.clear();
+			AddVertsForPrimitiveInstancesScalar(verts, type, BENCHMARK_LOD, NUM_INSTANCES, instances.data());
+			numScalarVerts += verts.size();
+		}
+		double scalarSeconds = scalarTimer.GetElapsedSeconds();
+
+		size_t numSimdVerts = 0;
+		BenchmarkTimer simdTimer;
+		for (int repeatIndex = 0; repeatIndex < NUM_REPEATS; ++repeatIndex)
+		{
+			verts.clear();
+			AddVertsForPrimitiveInstances(verts, type, BENCHMARK_LOD, NUM_INSTANCES, instances.data());
+			numSimdVerts += verts.size();
+		}
+		double simdSeconds = simdTimer.GetElapsedSeconds();
+
+		double tessellateVertsPerSecond = static_cast<double>(numTessellatedVerts) / tessellateSeconds;
+		double scalarVertsPerSecond = static_cast<double>(numScalarVerts) / scalarSeconds;
+		double simdVertsPerSecond = static_cast<double>(numSimdVerts) / simdSeconds;
+		report.AddLine(Stringf("%-12s %10.1f %10.1f %10.1f (x%.2f)", GetNameForPrimitiveMeshType(type),
+			tessellateVertsPerSecond * 1e-6, scalarVertsPerSecond * 1e-6, simdVertsPerSecond * 1e-6, simdVertsPerSecond / tessellateVertsPerSecond));
 	}
 }
 
@@ -315,30 +651,47 @@ void Game3DTestShapes::UpdateRay()
 
 void Game3DTestShapes::RandomizeSceneObjects()
 {
-	for (TestShape* ptr : m_shapeList) {
-		delete ptr;
-	}
 	m_shapeList.clear();
-	m_shapeList.reserve(20);
 	Vec3 sceneDimensions = Vec3(5.f, 5.f, 5.f);
-	for (int i = 0; i < 2; ++i)
-	{
-		m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_Sphere, false));
-		m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_Sphere, true));
-		m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_AABB3, false));
-		m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_AABB3, true));
-		m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_ZCylinder, false));
-		m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_ZCylinder, true));
-		m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_OBB3, false));
-		m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_OBB3, true));
-	}
-	//m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_Sphere, false));
-	//m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_AABB3, false));
-	//m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_ZCylinder, false));
-	//m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_OBB3, false));
-	m_shapeList.push_back(new TestShape(sceneDimensions, TestShape::Type::eType_Plane3, false));
+	if (m_isStressScene)
+	{
+		// Shapes keep their usual size, but are spread over a much larger volume
+		m_shapeList.reserve(NUM_STRESS_SHAPES + 1);
+		for (int i = 0; i < NUM_STRESS_SHAPES; ++i)
+		{
+			TestShape::Type shapeType = static_cast<TestShape::Type>(i % TestShape::Type::eType_Plane3);
+			TestShape& shape = m_shapeList.emplace_back(sceneDimensions, shapeType, (i / TestShape::Type::eType_Plane3) % 2 == 1);
+			shape.m_position.x = g_rng.RollRandomFloatInRange(-STRESS_SCENE_HALF_SIZE, STRESS_SCENE_HALF_SIZE);
+			shape.m_position.y = g_rng.RollRandomFloatInRange(-STRESS_SCENE_HALF_SIZE, STRESS_SCENE_HALF_SIZE);
+			shape.m_position.z = g_rng.RollRandomFloatInRange(-STRESS_SCENE_HALF_SIZE, STRESS_SCENE_HALF_SIZE);
+			shape.UpdateWorldShape();
+		}
+	}
+	else
+	{
+		m_shapeList.reserve(20);
+		for (int i = 0; i < 2; ++i)
+		{
+			m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_Sphere, false);
+			m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_Sphere, true);
+			m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_AABB3, false);
+			m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_AABB3, true);
+			m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_ZCylinder, false);
+			m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_ZCylinder, true);
+			m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_OBB3, false);
+			m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_OBB3, true);
+		}
+		//m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_Sphere, false);
+		//m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_AABB3, false);
+		//m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_ZCylinder, false);
+		//m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_OBB3, false);
+	}
+	m_shapeList.emplace_back(sceneDimensions, TestShape::Type::eType_Plane3, false);
+
+	RebuildBroadphases();
 
 	m_grabbedObject = nullptr;
+	m_hitObject = nullptr;
 	m_isRaycastLocked = false;
 }
 
@@ -354,28 +707,42 @@ void Game3DTestShapes::UpdatePlayer()
 
 void Game3DTestShapes::DoRaycast()
 {
+	PROFILE_FUNCTION();
 	m_hitObject = nullptr;
 	m_raycastResult = RaycastResult3D();
 
-	for (TestShape* shape : m_shapeList)
+	// Front to back through the tree, subtrees beyond the closest impact are never visited.
+	// A leaf whose fat bounds passed can still have tight bounds entered beyond the closest impact, skip it before the exact test.
+	Vec3 inverseDirection = AABBTree3D::GetSafeInverseDirection(m_rayFwdNormal);
+	auto raycastShape = [this, &inverseDirection](int shapeIndex, float closestDist) -> float
 	{
-		RaycastResult3D result = shape->GetRaycastResult(m_rayStart, m_rayFwdNormal, m_rayLength);
-		if (result.m_didImpact)
+		TestShape* shape = &m_shapeList[shapeIndex];
+		if (!shape->IsInfinite())
 		{
-			if (!m_raycastResult.m_didImpact)
-			{
-				m_raycastResult = result;
-				m_hitObject = shape;
-			}
-			else
+			float entryDist = AABBTree3D::GetRayEntryDistance(shape->GetWorldBounds(), m_rayStart, inverseDirection, closestDist);
+			if (entryDist < 0.f || entryDist >= closestDist)
 			{
-				if (result.m_impactDist < m_raycastResult.m_impactDist)
-				{
-					m_raycastResult = result;
-					m_hitObject = shape;
-				}
+				return -1.f;
 			}
 		}
+		RaycastResult3D result = shape->GetRaycastResult(m_rayStart, m_rayFwdNormal, closestDist);
+		if (!result.m_didImpact)
+		{
+			return -1.f;
+		}
+		if (!m_raycastResult.m_didImpact || result.m_impactDist < m_raycastResult.m_impactDist)
+		{
+			m_raycastResult = result;
+			m_hitObject = shape;
+		}
+		return result.m_impactDist;
+	};
+	m_shapeTree.RaycastClosest(m_rayStart, m_rayFwdNormal, m_rayLength, raycastShape);
+
+	for (int shapeIndex : m_infiniteShapeIndexes)
+	{
+		float closestDist = m_raycastResult.m_didImpact ? m_raycastResult.m_impactDist : m_rayLength;
+		raycastShape(shapeIndex, closestDist);
 	}
 
 	// Color the hit object
@@ -390,36 +757,55 @@ void Game3DTestShapes::DoRaycast()
 void Game3DTestShapes::DrawObjects() const
 {
 	// Draw Shapes
-	for (TestShape* shape : m_shapeList)
+	for (TestShape const& shape : m_shapeList)
 	{
-		shape->Render();
+		shape.Render();
 	}
 
 	// Draw Nearest Point
-	std::vector<Vec3> nearestPoints;
-	nearestPoints.reserve(m_shapeList.size());
+	// Planes are checked directly first, their distance then prunes the best first search of the tree
 	float minDistanceSquared = 10000000000.f;
-	TestShape* nearestShape = nullptr;
+	TestShape const* nearestShape = nullptr;
+	Vec3 nearestShapePoint;
 
-	for (TestShape* shape : m_shapeList)
+	for (int shapeIndex : m_infiniteShapeIndexes)
 	{
+		TestShape const* shape = &m_shapeList[shapeIndex];
 		Vec3 nearestPoint = shape->GetNearestPoint(m_rayStart);
 		float distanceSquared = GetDistanceSquared3D(m_rayStart, nearestPoint);
 		if (distanceSquared < minDistanceSquared)
 		{
 			minDistanceSquared = distanceSquared;
 			nearestShape = shape;
+			nearestShapePoint = nearestPoint;
 		}
 	}
 
+	auto distanceSquaredToShape = [&](int shapeIndex)
+		{
+			Vec3 nearestPoint = m_shapeList[shapeIndex].GetNearestPoint(m_rayStart);
+			float distanceSquared = GetDistanceSquared3D(m_rayStart, nearestPoint);
+			if (distanceSquared < minDistanceSquared)
+			{
+				nearestShapePoint = nearestPoint;
+			}
+			return distanceSquared;
+		};
+	int nearestShapeIndex = m_shapeTree.FindNearest(m_rayStart, distanceSquaredToShape, minDistanceSquared);
+	if (nearestShapeIndex != -1)
+	{
+		nearestShape = &m_shapeList[nearestShapeIndex];
+	}
+
 	if (nearestShape != nullptr)
 	{
-		Vec3 nearestPoint = nearestShape->GetNearestPoint(m_rayStart);
-		DebugAddWorldSphere(nearestPoint, NEAREST_POINT_SPHERE_RADIUS, 0.f, Rgba8::GREEN);
+		DebugAddWorldSphere(nearestShapePoint, NEAREST_POINT_SPHERE_RADIUS, 0.f, Rgba8::GREEN);
 	}
 
-	for (TestShape* shape : m_shapeList)
+	// Every shape's nearest point is only readable in the small scene
+	for (int shapeIndex = 0; shapeIndex < (int)m_shapeList.size() && !m_isStressScene; ++shapeIndex)
 	{
+		TestShape const* shape = &m_shapeList[shapeIndex];
 		if (nearestShape != shape)
 		{
 			Vec3 nearestPoint = shape->GetNearestPoint(m_rayStart);
@@ -517,6 +903,8 @@ void TestShape::SetSphereType(float radius)
 	m_vertexes.clear();
 	m_vertexes.reserve(768);
 	AddVertsForSphere3D(m_vertexes, Vec3(), radius, Rgba8::OPAQUE_WHITE, AABB2::ZERO_TO_ONE, 16, 8);
+
+	UpdateWorldShape();
 }
 
 void TestShape::SetAABB3Type(Vec3 halfDimensions)
@@ -527,6 +915,8 @@ void TestShape::SetAABB3Type(Vec3 halfDimensions)
 	m_vertexes.clear();
 	m_vertexes.reserve(36);
 	AddVertsForAABB3D(m_vertexes, AABB3(-halfDimensions, halfDimensions));
+
+	UpdateWorldShape();
 }
 
 void TestShape::SetZCylinderType(float radius, float halfHeight)
@@ -538,6 +928,8 @@ void TestShape::SetZCylinderType(float radius, float halfHeight)
 	m_vertexes.clear();
 	m_vertexes.reserve(384);
 	AddVertsForCylinderZ3D(m_vertexes, Vec2::ZERO, FloatRange(-halfHeight, halfHeight), radius, 8);
+
+	UpdateWorldShape();
 }
 
 void TestShape::SetOBB3Type(Vec3 halfDimensions, EulerAngles orientation)
@@ -549,6 +941,8 @@ void TestShape::SetOBB3Type(Vec3 halfDimensions, EulerAngles orientation)
 	m_vertexes.clear();
 	m_vertexes.reserve(36);
 	AddVertsForAABB3D(m_vertexes, AABB3(-halfDimensions, halfDimensions));
+
+	UpdateWorldShape();
 }
 
 void TestShape::SetPlane3Type(Vec3 normal, float d)
@@ -569,12 +963,57 @@ Mat44 TestShape::GetModelToWorldTransform() const
 	return result;
 }
 
+AABB3 const& TestShape::GetWorldBounds() const
+{
+	GUARANTEE_OR_DIE(!IsInfinite(), "Infinite Test Shape has no bounds!");
+	return m_worldBounds;
+}
+
+void TestShape::UpdateWorldShape()
+{
+	Vec3 halfExtents;
+	if (m_type == eType_Sphere)
+	{
+		halfExtents = Vec3(m_sphereRadius, m_sphereRadius, m_sphereRadius);
+	}
+	else if (m_type == eType_AABB3)
+	{
+		halfExtents = m_boxHalfDimensions;
+		m_worldBox = AABB3(m_position - m_boxHalfDimensions, m_position + m_boxHalfDimensions);
+	}
+	else if (m_type == eType_ZCylinder)
+	{
+		halfExtents = Vec3(m_cylinderRadius, m_cylinderRadius, m_cylinderHalfHeight);
+		m_worldCylinderCenterXY = Vec2(m_position.x, m_position.y);
+		m_worldCylinderMinMaxZ = FloatRange(m_position.z - m_cylinderHalfHeight, m_position.z + m_cylinderHalfHeight);
+	}
+	else if (m_type == eType_OBB3)
+	{
+		m_obbOrientation.GetAsVectors_IFwd_JLeft_KUp(m_worldIBasis, m_worldJBasis, m_worldKBasis);
+		m_worldOBB = OBB3(m_position, m_worldIBasis, m_worldJBasis, m_worldKBasis, m_boxHalfDimensions);
+
+		halfExtents.x = fabsf(m_worldIBasis.x) * m_boxHalfDimensions.x + fabsf(m_worldJBasis.x) * m_boxHalfDimensions.y + fabsf(m_worldKBasis.x) * m_boxHalfDimensions.z;
+		halfExtents.y = fabsf(m_worldIBasis.y) * m_boxHalfDimensions.x + fabsf(m_worldJBasis.y) * m_boxHalfDimensions.y + fabsf(m_worldKBasis.y) * m_boxHalfDimensions.z;
+		halfExtents.z = fabsf(m_worldIBasis.z) * m_boxHalfDimensions.x + fabsf(m_worldJBasis.z) * m_boxHalfDimensions.y + fabsf(m_worldKBasis.z) * m_boxHalfDimensions.z;
+	}
+	else
+	{
+		return;
+	}
+	m_worldBounds = AABB3(m_position - halfExtents, m_position + halfExtents);
+}
+
+bool TestShape::IsInfinite() const
+{
+	return m_type == eType_Plane3;
+}
+
 void TestShape::Render() const
 {
 
 	if (m_type == eType_Plane3)
 	{
-		std::vector<Vertex_PCU> verts;
+		std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
 		AddVertsForGridPlane3D(verts, m_plane);
 		Vec3 gridCenter = m_plane.GetNearestPoint(Vec3::ZERO);
@@ -634,202 +1073,261 @@ void TestShape::Render() const
 	g_theRenderer->DrawVertexArray(m_vertexes);
 }
 
-Vec3 TestShape::GetNearestPoint(Vec3 const& point)
+Vec3 TestShape::GetNearestPoint(Vec3 const& point) const
 {
-	if (m_type == eType_Sphere)
-	{
-		Vec3 sphereCenter = m_position;
-		return GetNearestPointOnSphere3D(point, sphereCenter, m_sphereRadius);
-	}
-	else if (m_type == eType_AABB3)
-	{
-		AABB3 box(-m_boxHalfDimensions + m_position, m_boxHalfDimensions + m_position);
-		return GetNearestPointOnAABB3D(point, box);
-	}
-	else if (m_type == eType_ZCylinder)
-	{
-		Vec2 cylinderCenterXY = Vec2(m_position.x, m_position.y);
-		float cylinderRadius = m_cylinderRadius;
-		FloatRange cylinderMinMaxZ = FloatRange(m_position.z - m_cylinderHalfHeight, m_position.z + m_cylinderHalfHeight);
-		return GetNearestPointOnCylinderZ3D(point, cylinderCenterXY, cylinderRadius, cylinderMinMaxZ);
-	}
-	else if (m_type == eType_OBB3)
+	switch (m_type)
 	{
-		Vec3 iBasisNormal, jBasisNormal, kBasisNormal;
-		m_obbOrientation.GetAsVectors_IFwd_JLeft_KUp(iBasisNormal, jBasisNormal, kBasisNormal);
-		OBB3 orientedBox(m_position, iBasisNormal, jBasisNormal, kBasisNormal, m_boxHalfDimensions);
-		return GetNearestPointOnOBB3D(point, orientedBox);
-	}
-	else if (m_type == eType_Plane3)
-	{
-		return m_plane.GetNearestPoint(point);
+	case eType_Sphere:		return GetNearestPointOnSphere3D(point, m_position, m_sphereRadius);
+	case eType_AABB3:		return GetNearestPointOnAABB3D(point, m_worldBox);
+	case eType_ZCylinder:	return GetNearestPointOnCylinderZ3D(point, m_worldCylinderCenterXY, m_cylinderRadius, m_worldCylinderMinMaxZ);
+	case eType_OBB3:		return GetNearestPointOnOBB3D(point, m_worldOBB);
+	case eType_Plane3:		return m_plane.GetNearestPoint(point);
+	default:				break;
 	}
 	ERROR_AND_DIE("Test Shape Type not assigned!");
 }
 
-bool TestShape::IsOverlappingWithOtherShape(TestShape const& other)
+//-----------------------------------------------------------------------------------------------
+// Overlap tests by type pair, every function takes the shapes in the order of its name
+typedef bool (*TestShapeOverlapFunc)(TestShape const& shapeA, TestShape const& shapeB);
+
+static bool DoSpheresOverlap(TestShape const& sphereA, TestShape const& sphereB)
 {
-	if (m_type == eType_Sphere)
-	{
-		Vec3 sphereCenterA = m_position;
-		float sphereRadiusA = m_sphereRadius;
+	return DoSpheresOverlap3D(sphereA.m_position, sphereA.m_sphereRadius, sphereB.m_position, sphereB.m_sphereRadius);
+}
 
-		if (other.m_type == eType_Sphere)
-		{
-			Vec3 sphereCenterB = other.m_position;
-			float sphereRadiusB = other.m_sphereRadius;
-			return DoSpheresOverlap3D(sphereCenterA, sphereRadiusA, sphereCenterB, sphereRadiusB);
-		}
-		else if (other.m_type == eType_AABB3)
-		{
-			AABB3 boxB(-other.m_boxHalfDimensions + other.m_position, other.m_boxHalfDimensions + other.m_position);
-			return DoSphereAndAABBOverlap3D(sphereCenterA, sphereRadiusA, boxB);
-		}
-		else if (other.m_type == eType_ZCylinder)
-		{
-			Vec2 cylinderCenterXYB = Vec2(other.m_position.x, other.m_position.y);
-			float cylinderRadiusB = other.m_cylinderRadius;
-			FloatRange cylinderMinMaxZB = FloatRange(other.m_position.z - other.m_cylinderHalfHeight, other.m_position.z + other.m_cylinderHalfHeight);
-			return DoZCylinderAndSphereOverlap3D(cylinderCenterXYB, cylinderRadiusB, cylinderMinMaxZB, sphereCenterA, sphereRadiusA);
-		}
-		else if (other.m_type == eType_OBB3)
-		{
-			Vec3 iBasisNormal, jBasisNormal, kBasisNormal;
-			other.m_obbOrientation.GetAsVectors_IFwd_JLeft_KUp(iBasisNormal, jBasisNormal, kBasisNormal);
-			OBB3 orientedBoxB(other.m_position, iBasisNormal, jBasisNormal, kBasisNormal, other.m_boxHalfDimensions);
-			return DoSphereAndOBBOverlap3D(sphereCenterA, sphereRadiusA, orientedBoxB);
-		}
-		else if (other.m_type == eType_Plane3)
+static bool DoSphereAndAABBOverlap(TestShape const& sphere, TestShape const& box)
+{
+	return DoSphereAndAABBOverlap3D(sphere.m_position, sphere.m_sphereRadius, box.m_worldBox);
+}
+
+static bool DoSphereAndZCylinderOverlap(TestShape const& sphere, TestShape const& cylinder)
+{
+	return DoZCylinderAndSphereOverlap3D(cylinder.m_worldCylinderCenterXY, cylinder.m_cylinderRadius, cylinder.m_worldCylinderMinMaxZ, sphere.m_position, sphere.m_sphereRadius);
+}
+
+static bool DoSphereAndOBBOverlap(TestShape const& sphere, TestShape const& orientedBox)
+{
+	return DoSphereAndOBBOverlap3D(sphere.m_position, sphere.m_sphereRadius, orientedBox.m_worldOBB);
+}
+
+static bool DoSphereAndPlaneOverlap(TestShape const& sphere, TestShape const& plane)
+{
+	return DoSphereAndPlaneOverlap3D(sphere.m_position, sphere.m_sphereRadius, plane.m_plane);
+}
+
+static bool DoAABBsOverlap(TestShape const& boxA, TestShape const& boxB)
+{
+	return DoAABBsOverlap3D(boxA.m_worldBox, boxB.m_worldBox);
+}
+
+static bool DoAABBAndZCylinderOverlap(TestShape const& box, TestShape const& cylinder)
+{
+	return DoZCylinderAndAABBOverlap3D(cylinder.m_worldCylinderCenterXY, cylinder.m_cylinderRadius, cylinder.m_worldCylinderMinMaxZ, box.m_worldBox);
+}
+
+static bool DoAABBAndPlaneOverlap(TestShape const& box, TestShape const& plane)
+{
+	return DoAABBAndPlaneOverlap3D(box.m_worldBox, plane.m_plane);
+}
+
+static bool DoZCylindersOverlap(TestShape const& cylinderA, TestShape const& cylinderB)
+{
+	return DoZCylindersOverlap3D(cylinderA.m_worldCylinderCenterXY, cylinderA.m_cylinderRadius, cylinderA.m_worldCylinderMinMaxZ,
+		cylinderB.m_worldCylinderCenterXY, cylinderB.m_cylinderRadius, cylinderB.m_worldCylinderMinMaxZ);
+}
+
+static bool DoOBBAndPlaneOverlap(TestShape const& orientedBox, TestShape const& plane)
+{
+	return DoOBBAndPlaneOverlap3D(orientedBox.m_worldOBB, plane.m_plane);
+}
+
+static bool DoZCylinderAndPlaneOverlap(TestShape const& cylinder, TestShape const& plane)
+{
+	// Project the cylinder onto the plane normal: disc radius * sin + half height * cos
+	Vec3 normal = plane.m_plane.m_normal;
+	float projectedRadius = cylinder.m_cylinderRadius * sqrtf(normal.x * normal.x + normal.y * normal.y) + cylinder.m_cylinderHalfHeight * fabsf(normal.z);
+	Vec3 nearestPointOnPlane = plane.m_plane.GetNearestPoint(cylinder.m_position);
+	return GetDistanceSquared3D(cylinder.m_position, nearestPointOnPlane) <= projectedRadius * projectedRadius;
+}
+
+//-----------------------------------------------------------------------------------------------
+// 15 axis separating axis test: 3 face axes of each box, then the 9 edge cross products
+// The absolute rotation terms are computed once and padded so near parallel edges cannot
+// produce a zero cross product axis that wrongly reports a separation
+static bool DoOrientedBoxesOverlap(Vec3 const& centerA, Vec3 const axesA[3], Vec3 const& halfDimensionsA, Vec3 const& centerB, Vec3 const axesB[3], Vec3 const& halfDimensionsB)
+{
+	constexpr float PARALLEL_EPSILON = 1e-6f;
+	float halfA[3] = { halfDimensionsA.x, halfDimensionsA.y, halfDimensionsA.z };
+	float halfB[3] = { halfDimensionsB.x, halfDimensionsB.y, halfDimensionsB.z };
+
+	// B's axes expressed in A's frame
+	float rotation[3][3];
+	float absRotation[3][3];
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
 		{
-			return DoSphereAndPlaneOverlap3D(m_position, sphereRadiusA, other.m_plane);
+			rotation[i][j] = DotProduct3D(axesA[i], axesB[j]);
+			absRotation[i][j] = fabsf(rotation[i][j]) + PARALLEL_EPSILON;
 		}
 	}
-	else if (m_type == eType_AABB3)
-	{
-		AABB3 boxA(-m_boxHalfDimensions + m_position, m_boxHalfDimensions + m_position);
 
-		if (other.m_type == eType_Sphere)
-		{
-			Vec3 sphereCenterB = other.m_position;
-			float sphereRadiusB = other.m_sphereRadius;
-			return DoSphereAndAABBOverlap3D(sphereCenterB, sphereRadiusB, boxA);
-		}
-		else if (other.m_type == eType_AABB3)
-		{
-			AABB3 boxB(-other.m_boxHalfDimensions + other.m_position, other.m_boxHalfDimensions + other.m_position);
-			return DoAABBsOverlap3D(boxA, boxB);
-		}
-		else if (other.m_type == eType_ZCylinder)
-		{
-			Vec2 cylinderCenterXYB = Vec2(other.m_position.x, other.m_position.y);
-			float cylinderRadiusB = other.m_cylinderRadius;
-			FloatRange cylinderMinMaxZB = FloatRange(other.m_position.z - other.m_cylinderHalfHeight, other.m_position.z + other.m_cylinderHalfHeight);
-			return DoZCylinderAndAABBOverlap3D(cylinderCenterXYB, cylinderRadiusB, cylinderMinMaxZB, boxA);
-		}
-		else if (other.m_type == eType_Plane3)
+	Vec3 displacement = centerB - centerA;
+	float translation[3] = { DotProduct3D(displacement, axesA[0]), DotProduct3D(displacement, axesA[1]), DotProduct3D(displacement, axesA[2]) };
+
+	// A's face axes
+	for (int i = 0; i < 3; ++i)
+	{
+		float radiusB = halfB[0] * absRotation[i][0] + halfB[1] * absRotation[i][1] + halfB[2] * absRotation[i][2];
+		if (fabsf(translation[i]) > halfA[i] + radiusB)
 		{
-			return DoAABBAndPlaneOverlap3D(boxA, other.m_plane);
+			return false;
 		}
 	}
-	else if (m_type == eType_ZCylinder)
-	{
-		Vec2 cylinderCenterXYA = Vec2(m_position.x, m_position.y);
-		float cylinderRadiusA = m_cylinderRadius;
-		FloatRange cylinderMinMaxZA = FloatRange(m_position.z - m_cylinderHalfHeight, m_position.z + m_cylinderHalfHeight);
 
-		if (other.m_type == eType_Sphere)
-		{
-			Vec3 sphereCenterB = other.m_position;
-			float sphereRadiusB = other.m_sphereRadius;
-			return DoZCylinderAndSphereOverlap3D(cylinderCenterXYA, cylinderRadiusA, cylinderMinMaxZA, sphereCenterB, sphereRadiusB);
-		}
-		else if (other.m_type == eType_AABB3)
+	// B's face axes
+	for (int j = 0; j < 3; ++j)
+	{
+		float radiusA = halfA[0] * absRotation[0][j] + halfA[1] * absRotation[1][j] + halfA[2] * absRotation[2][j];
+		float distance = translation[0] * rotation[0][j] + translation[1] * rotation[1][j] + translation[2] * rotation[2][j];
+		if (fabsf(distance) > radiusA + halfB[j])
 		{
-			AABB3 boxB(-other.m_boxHalfDimensions + other.m_position, other.m_boxHalfDimensions + other.m_position);
-			return DoZCylinderAndAABBOverlap3D(cylinderCenterXYA, cylinderRadiusA, cylinderMinMaxZA, boxB);
+			return false;
 		}
-		else if (other.m_type == eType_ZCylinder)
+	}
+
+	// A[i] x B[j]
+	for (int i = 0; i < 3; ++i)
+	{
+		int i1 = (i + 1) % 3;
+		int i2 = (i + 2) % 3;
+		for (int j = 0; j < 3; ++j)
 		{
-			Vec2 cylinderCenterXYB = Vec2(other.m_position.x, other.m_position.y);
-			float cylinderRadiusB = other.m_cylinderRadius;
-			FloatRange cylinderMinMaxZB = FloatRange(other.m_position.z - other.m_cylinderHalfHeight, other.m_position.z + other.m_cylinderHalfHeight);
-			return DoZCylindersOverlap3D(cylinderCenterXYA, cylinderRadiusA, cylinderMinMaxZA, cylinderCenterXYB, cylinderRadiusB, cylinderMinMaxZB);
+			int j1 = (j + 1) % 3;
+			int j2 = (j + 2) % 3;
+			float radiusA = halfA[i1] * absRotation[i2][j] + halfA[i2] * absRotation[i1][j];
+			float radiusB = halfB[j1] * absRotation[i][j2] + halfB[j2] * absRotation[i][j1];
+			float distance = translation[i2] * rotation[i1][j] - translation[i1] * rotation[i2][j];
+			if (fabsf(distance) > radiusA + radiusB)
+			{
+				return false;
+			}
 		}
+	}
+
+	return true;
+}
+
+static bool DoOBBsOverlap(TestShape const& orientedBoxA, TestShape const& orientedBoxB)
+{
+	Vec3 axesA[3] = { orientedBoxA.m_worldIBasis, orientedBoxA.m_worldJBasis, orientedBoxA.m_worldKBasis };
+	Vec3 axesB[3] = { orientedBoxB.m_worldIBasis, orientedBoxB.m_worldJBasis, orientedBoxB.m_worldKBasis };
+	return DoOrientedBoxesOverlap(orientedBoxA.m_position, axesA, orientedBoxA.m_boxHalfDimensions, orientedBoxB.m_position, axesB, orientedBoxB.m_boxHalfDimensions);
+}
+
+static bool DoAABBAndOBBOverlap(TestShape const& box, TestShape const& orientedBox)
+{
+	Vec3 worldAxes[3] = { Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f), Vec3(0.f, 0.f, 1.f) };
+	Vec3 orientedAxes[3] = { orientedBox.m_worldIBasis, orientedBox.m_worldJBasis, orientedBox.m_worldKBasis };
+	return DoOrientedBoxesOverlap(box.m_position, worldAxes, box.m_boxHalfDimensions, orientedBox.m_position, orientedAxes, orientedBox.m_boxHalfDimensions);
+}
+
+static bool IsZCylinderAndOBBSeparatedOnAxis(TestShape const& cylinder, TestShape const& orientedBox, Vec3 const& axis)
+{
+	float radiusCylinder = cylinder.m_cylinderRadius * sqrtf(axis.x * axis.x + axis.y * axis.y) + cylinder.m_cylinderHalfHeight * fabsf(axis.z);
+	float radiusBox = orientedBox.m_boxHalfDimensions.x * fabsf(DotProduct3D(axis, orientedBox.m_worldIBasis))
+		+ orientedBox.m_boxHalfDimensions.y * fabsf(DotProduct3D(axis, orientedBox.m_worldJBasis))
+		+ orientedBox.m_boxHalfDimensions.z * fabsf(DotProduct3D(axis, orientedBox.m_worldKBasis));
+	float distance = fabsf(DotProduct3D(orientedBox.m_position - cylinder.m_position, axis));
+	return distance > radiusCylinder + radiusBox;
+}
 
+static bool DoZCylinderAndOBBOverlap(TestShape const& cylinder, TestShape const& orientedBox)
+{
+	// Separating axis test with the cylinder axis, the box faces, the cylinder axis crossed with the box edges,
+	// and the horizontal direction from the cylinder axis to the box. The round side has infinitely many
+	// axes, so contacts right at the rim can be reported as overlapping a little early
+	if (IsZCylinderAndOBBSeparatedOnAxis(cylinder, orientedBox, Vec3(0.f, 0.f, 1.f)))
+	{
+		return false;
 	}
-	else if (m_type == eType_OBB3)
+
+	Vec3 boxAxes[3] = { orientedBox.m_worldIBasis, orientedBox.m_worldJBasis, orientedBox.m_worldKBasis };
+	for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
 	{
-		Vec3 iBasisNormal, jBasisNormal, kBasisNormal;
-		m_obbOrientation.GetAsVectors_IFwd_JLeft_KUp(iBasisNormal, jBasisNormal, kBasisNormal);
-		OBB3 orientedBoxA(m_position, iBasisNormal, jBasisNormal, kBasisNormal, m_boxHalfDimensions);
-		if (other.m_type == eType_Sphere)
+		if (IsZCylinderAndOBBSeparatedOnAxis(cylinder, orientedBox, boxAxes[axisIndex]))
 		{
-			Vec3 sphereCenterB = other.m_position;
-			float sphereRadiusB = other.m_sphereRadius;
-			return DoSphereAndOBBOverlap3D(sphereCenterB, sphereRadiusB, orientedBoxA);
+			return false;
 		}
-		else if (other.m_type == eType_Plane3)
+
+		Vec3 crossAxis = Vec3(-boxAxes[axisIndex].y, boxAxes[axisIndex].x, 0.f);
+		float crossAxisLengthSquared = crossAxis.GetLengthSquared();
+		if (crossAxisLengthSquared > 1e-8f && IsZCylinderAndOBBSeparatedOnAxis(cylinder, orientedBox, crossAxis / sqrtf(crossAxisLengthSquared)))
 		{
-			return DoOBBAndPlaneOverlap3D(orientedBoxA, other.m_plane);
+			return false;
 		}
 	}
-	else if (m_type == eType_Plane3)
+
+	float clampedZ = GetClamped(orientedBox.m_position.z, cylinder.m_worldCylinderMinMaxZ.m_min, cylinder.m_worldCylinderMinMaxZ.m_max);
+	Vec3 nearestPointOnBox = GetNearestPointOnOBB3D(Vec3(cylinder.m_position.x, cylinder.m_position.y, clampedZ), orientedBox.m_worldOBB);
+	Vec3 radialAxis = Vec3(nearestPointOnBox.x - cylinder.m_position.x, nearestPointOnBox.y - cylinder.m_position.y, 0.f);
+	float radialAxisLengthSquared = radialAxis.GetLengthSquared();
+	if (radialAxisLengthSquared > 1e-8f && IsZCylinderAndOBBSeparatedOnAxis(cylinder, orientedBox, radialAxis / sqrtf(radialAxisLengthSquared)))
 	{
-		if (other.m_type == eType_Sphere)
-		{
-			Vec3 sphereCenterB = other.m_position;
-			float sphereRadiusB = other.m_sphereRadius;
-			return DoSphereAndPlaneOverlap3D(sphereCenterB, sphereRadiusB, m_plane);
-		}
-		else if (other.m_type == eType_AABB3)
-		{
-			AABB3 boxB(-other.m_boxHalfDimensions + other.m_position, other.m_boxHalfDimensions + other.m_position);
-			return DoAABBAndPlaneOverlap3D(boxB, m_plane);
-		}
-		else if (other.m_type == eType_OBB3)
-		{
-			Vec3 iBasisNormal, jBasisNormal, kBasisNormal;
-			other.m_obbOrientation.GetAsVectors_IFwd_JLeft_KUp(iBasisNormal, jBasisNormal, kBasisNormal);
-			OBB3 orientedBoxB(other.m_position, iBasisNormal, jBasisNormal, kBasisNormal, other.m_boxHalfDimensions);
-			return DoOBBAndPlaneOverlap3D(orientedBoxB, m_plane);
-		}
+		return false;
 	}
 
+	return true;
+}
+
+static bool IsOverlapTestMissing(TestShape const& shapeA, TestShape const& shapeB)
+{
+	UNUSED(shapeA);
+	UNUSED(shapeB);
 	return false;
-	//ERROR_AND_DIE("Test Shape Type not assigned!");
 }
 
-RaycastResult3D TestShape::GetRaycastResult(Vec3 rayStart, Vec3 rayForwardNormal, float rayLength)
+// The lower triangle calls the same functions with the shapes swapped
+template<TestShapeOverlapFunc overlapFunc>
+static bool DoSwappedShapesOverlap(TestShape const& shapeA, TestShape const& shapeB)
 {
-	if (m_type == eType_Sphere)
-	{
-		Vec3 sphereCenter = m_position;
-		float sphereRadius = m_sphereRadius;
+	return overlapFunc(shapeB, shapeA);
+}
 
-		return RaycastVsSphere3D(rayStart, rayForwardNormal, rayLength, sphereCenter, sphereRadius);
-	}
-	else if (m_type == eType_AABB3)
-	{
-		AABB3 box(-m_boxHalfDimensions + m_position, m_boxHalfDimensions + m_position);
-		return RaycastVsAABB3D(rayStart, rayForwardNormal, rayLength, box);
-	}
-	else if (m_type == eType_ZCylinder)
-	{
-		Vec2 cylinderCenterXY = Vec2(m_position.x, m_position.y);
-		float cylinderRadius = m_cylinderRadius;
-		FloatRange cylinderMinMaxZ = FloatRange(m_position.z - m_cylinderHalfHeight, m_position.z + m_cylinderHalfHeight);
-		return RaycastVsCylinderZ3D(rayStart, rayForwardNormal, rayLength, cylinderCenterXY, cylinderMinMaxZ, cylinderRadius);
-	}
-	else if (m_type == eType_OBB3)
+static const TestShapeOverlapFunc s_overlapFuncs[TestShape::eType_Count][TestShape::eType_Count] =
+{
+	// Sphere
+	{ DoSpheresOverlap, DoSphereAndAABBOverlap, DoSphereAndZCylinderOverlap, DoSphereAndOBBOverlap, DoSphereAndPlaneOverlap },
+	// AABB3
+	{ DoSwappedShapesOverlap<DoSphereAndAABBOverlap>, DoAABBsOverlap, DoAABBAndZCylinderOverlap, DoAABBAndOBBOverlap, DoAABBAndPlaneOverlap },
+	// ZCylinder
+	{ DoSwappedShapesOverlap<DoSphereAndZCylinderOverlap>, DoSwappedShapesOverlap<DoAABBAndZCylinderOverlap>, DoZCylindersOverlap, DoZCylinderAndOBBOverlap, DoZCylinderAndPlaneOverlap },
+	// OBB3
+	{ DoSwappedShapesOverlap<DoSphereAndOBBOverlap>, DoSwappedShapesOverlap<DoAABBAndOBBOverlap>, DoSwappedShapesOverlap<DoZCylinderAndOBBOverlap>, DoOBBsOverlap, DoOBBAndPlaneOverlap },
+	// Plane3
+	{ DoSwappedShapesOverlap<DoSphereAndPlaneOverlap>, DoSwappedShapesOverlap<DoAABBAndPlaneOverlap>, DoSwappedShapesOverlap<DoZCylinderAndPlaneOverlap>, DoSwappedShapesOverlap<DoOBBAndPlaneOverlap>, IsOverlapTestMissing },
+};
+
+bool TestShape::IsOverlappingWithOtherShape(TestShape const& other) const
+{
+	if (m_type == eType_Count || other.m_type == eType_Count)
 	{
-		Vec3 iBasisNormal, jBasisNormal, kBasisNormal;
-		m_obbOrientation.GetAsVectors_IFwd_JLeft_KUp(iBasisNormal, jBasisNormal, kBasisNormal);
-		OBB3 orientedBox(m_position, iBasisNormal, jBasisNormal, kBasisNormal, m_boxHalfDimensions);
-		return RaycastVsOBB3D(rayStart, rayForwardNormal, rayLength, orientedBox);
+		return false;
 	}
-	else if (m_type == eType_Plane3)
+	return s_overlapFuncs[m_type][other.m_type](*this, other);
+}
+
+RaycastResult3D TestShape::GetRaycastResult(Vec3 rayStart, Vec3 rayForwardNormal, float rayLength) const
+{
+	switch (m_type)
 	{
-		return RaycastVsPlane3D(rayStart, rayForwardNormal, rayLength, m_plane);
+	case eType_Sphere:		return RaycastVsSphere3D(rayStart, rayForwardNormal, rayLength, m_position, m_sphereRadius);
+	case eType_AABB3:		return RaycastVsAABB3D(rayStart, rayForwardNormal, rayLength, m_worldBox);
+	case eType_ZCylinder:	return RaycastVsCylinderZ3D(rayStart, rayForwardNormal, rayLength, m_worldCylinderCenterXY, m_worldCylinderMinMaxZ, m_cylinderRadius);
+	case eType_OBB3:		return RaycastVsOBB3D(rayStart, rayForwardNormal, rayLength, m_worldOBB);
+	case eType_Plane3:		return RaycastVsPlane3D(rayStart, rayForwardNormal, rayLength, m_plane);
+	default:				break;
 	}
 
 	return RaycastResult3D();
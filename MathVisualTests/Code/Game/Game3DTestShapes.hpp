@@ -1,9 +1,14 @@
 #pragma once
 #include "Game/Game.hpp"
+#include "Game/AABBTree3D.hpp"
+#include "Game/RaycastPacket3D.hpp"
+#include "Game/SweepAndPrune3D.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Math/RaycastUtils.hpp"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/FloatRange.hpp"
+#include "Engine/Math/OBB3.hpp"
 #include "Engine/Math/Plane3.hpp"
 #include <vector>
 
@@ -38,13 +43,18 @@ public:
 	void SetPlane3Type(Vec3 normal, float d);
 
 	Mat44 GetModelToWorldTransform() const;
+	AABB3 const& GetWorldBounds() const;
+	bool IsInfinite() const;
+
+	// Call after changing m_position, m_obbOrientation or the shape dimensions
+	void UpdateWorldShape();
 
 	void Render() const;
 
 	//-----------------------------------------------------------------------------------------------
-	Vec3 GetNearestPoint(Vec3 const& point);
-	bool IsOverlappingWithOtherShape(TestShape const& other);
-	RaycastResult3D GetRaycastResult(Vec3 rayStart, Vec3 rayForwardNormal, float rayLength);
+	Vec3 GetNearestPoint(Vec3 const& point) const;
+	bool IsOverlappingWithOtherShape(TestShape const& other) const;
+	RaycastResult3D GetRaycastResult(Vec3 rayStart, Vec3 rayForwardNormal, float rayLength) const;
 
 public:
 	Type m_type = eType_Count;
@@ -61,10 +71,22 @@ public:
 	EulerAngles m_obbOrientation; // OBB
 	Plane3 m_plane;
 
+	// World space primitives, cached by UpdateWorldShape
+	AABB3 m_worldBounds; // Sphere AABB Cylinder OBB
+	AABB3 m_worldBox; // AABB
+	Vec2 m_worldCylinderCenterXY; // Cylinder
+	FloatRange m_worldCylinderMinMaxZ; // Cylinder
+	OBB3 m_worldOBB; // OBB
+	Vec3 m_worldIBasis; // OBB
+	Vec3 m_worldJBasis; // OBB
+	Vec3 m_worldKBasis; // OBB
+
 public:
 	bool m_isGrabbed = false;
 	bool m_isSelected = false;
 	bool m_isOverlapping = false;
+	int m_proxyId = -1; // in Game3DTestShapes::m_shapeTree, -1 for infinite shapes
+	int m_sweepAndPruneProxyId = -1;
 };
 
 
@@ -79,6 +101,7 @@ public:
 	virtual void Update() override;
 	virtual void Render() const override;
 	virtual void RandomizeSceneObjects() override;
+	virtual void RunBenchmarks(BenchmarkReport& report) override;
 
 
 private:
@@ -98,7 +121,15 @@ private:
 	void ReleaseGrabbedObject();
 	void UpdateGrabbedOBB();
 
+	void RebuildBroadphases();
+	void UpdateBroadphaseProxies(TestShape* shape);
 	void CheckIfOverlapping();
+	void CheckIfOverlappingWithTree();
+	void CheckIfOverlappingWithSweepAndPrune();
+	void RunOverlapBenchmark(BenchmarkReport& report) const;
+	void BuildRaycastShapeSet(RaycastShapeSet3D& out_shapeSet) const;
+	void RunRaycastBenchmark(BenchmarkReport& report) const;
+	void RunPrimitiveMeshBenchmark(BenchmarkReport& report) const;
 
 	void DrawObjects() const;
 	void DrawRaycastResult() const;
@@ -109,7 +140,14 @@ private:
 	Vec3 m_playerPosition = Vec3(2.f, 2.f, 2.f);
 	EulerAngles m_playerOrientation = EulerAngles(-135.f, 0.f, 0.f);
 
-	std::vector<TestShape*> m_shapeList;
+	std::vector<TestShape> m_shapeList; // by value, only reallocated by RandomizeSceneObjects
+	AABBTree3D m_shapeTree;
+	std::vector<int> m_infiniteShapeIndexes; // planes are kept out of the tree
+	std::vector<std::pair<int, int>> m_overlapCandidatePairs;
+	std::vector<int> m_planeOverlapCandidates;
+	SweepAndPrune3D m_sweepAndPrune;
+	bool m_isUsingSweepAndPrune = false;
+	bool m_isStressScene = false;
 	TestShape* m_grabbedObject = nullptr; // Grabbed or Released
 	Vec3 m_grabbedObjectCameraSpacePosition;
 	bool m_isRaycastLocked = false;
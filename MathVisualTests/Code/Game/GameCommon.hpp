@@ -12,6 +12,9 @@ class App;
 class RandomNumberGenerator;
 class Clock;
 class Texture;
+class FrameArena;
+class DrawQueue;
+class TextLayoutCache;
 
 struct Mat44;
 struct Vec2;
@@ -26,6 +29,9 @@ extern Renderer*		g_theRenderer;
 extern Window*			g_theWindow;
 extern App*				g_theApp;
 extern RandomNumberGenerator g_rng;
+extern FrameArena		g_frameArena;	// per-frame scratch memory, reset in App::EndFrame
+extern DrawQueue		g_drawQueue;	// state-merging draw submission, flushed by each mode before EndCamera
+extern TextLayoutCache	g_textLayoutCache;	// glyph verts of recently drawn text boxes
 
 //-----------------------------------------------------------------------------------------------
 extern bool g_isDebugDraw;
@@ -49,7 +55,7 @@ enum GameMode
 	GAME_MODE_NUM
 };
 
-const std::string GAME_TEXT = "F6 - previous, F7 - next, F8 - re-randomize, T - Slow motion";
+const std::string GAME_TEXT = "F6 - previous, F7 - next, F8 - re-randomize, T - Slow motion, F2 - profiler, F9 - benchmarks";
 
 constexpr float WINDOW_ASPECT = 2.f;
 //-----------------------------------------------------------------------------------------------
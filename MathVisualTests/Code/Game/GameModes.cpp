@@ -0,0 +1,82 @@
+#include "Game/GameModes.hpp"
+#include "Game/Game2DCurves.hpp"
+#include "Game/Game2DExposureAvoidance.hpp"
+#include "Game/Game2DFastVoxelRaycast.hpp"
+#include "Game/Game2DFlowField.hpp"
+#include "Game/Game2DPachinkoMachine.hpp"
+#include "Game/Game3DCurves.hpp"
+#include "Game/Game3DQuaternion.hpp"
+#include "Game/Game3DTestShapes.hpp"
+#include "Game/GameNearestPoint.hpp"
+#include "Game/GameRaycastVsAABBs.hpp"
+#include "Game/GameRaycastVsDiscs.hpp"
+#include "Game/GameRaycastVsLineSegments.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+static char const* const GAME_MODE_NAMES[GAME_MODE_NUM] =
+{
+	"NearestPoint",
+	"RaycastVsDiscs",
+	"RaycastVsLineSegments",
+	"RaycastVsAABBs",
+	"2DCurves",
+	"2DPachinkoMachine",
+	"2DFastVoxel",
+	"2DExposureAvoidance",
+	"2DFlowField",
+	"3DTestShapes",
+	"3DQuaternion",
+	"3DCurves",
+};
+
+
+//-----------------------------------------------------------------------------------------------
+Game* CreateNewGameForMode(GameMode mode)
+{
+	switch (mode)
+	{
+	case GAME_MODE_NEAREST_POINT:
+		return new GameNearestPoint();
+		break;
+	case GAME_MODE_RAYCAST_VS_DISCS:
+		return new GameRaycastVsDiscs();
+		break;
+	case GAME_MODE_RAYCAST_VS_LINE_SEGMENTS:
+		return new GameRaycastVsLineSegments();
+		break;
+	case GAME_MODE_RAYCAST_VS_AABBS:
+		return new GameRaycastVsAABBs();
+		break;
+	case GAME_MODE_3D_TEST_SHAPES:
+		return new Game3DTestShapes();
+		break;
+	case GAME_MODE_2D_CURVES:
+		return new Game2DCurves();
+		break;
+	case GAME_MODE_2D_PACHIKO_MACHINE:
+		return new Game2DPachinkoMachine();
+		break;
+	case GAME_MODE_2D_FAST_VOXEL:
+		return new Game2DFastVoxelRaycast();
+		break;
+	case GAME_MODE_2D_EXPOSURE_AVOIDANCE:
+		return new Game2DExposureAvoidance();
+		break;
+	case GAME_MODE_2D_FLOW_FIELD:
+		return new Game2DFlowField();
+		break;
+	case GAME_MODE_3D_QUATERNION:
+		return new Game3DQuaternion();
+		break;
+	case GAME_MODE_3D_CURVES:
+		return new Game3DCurves();
+		break;
+	}
+	ERROR_AND_DIE("Invalid Game Mode");
+}
+
+char const* GetNameForGameMode(GameMode mode)
+{
+	return (mode >= 0 && mode < GAME_MODE_NUM) ? GAME_MODE_NAMES[mode] : "Unknown";
+}
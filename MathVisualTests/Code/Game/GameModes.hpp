@@ -0,0 +1,11 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+//-----------------------------------------------------------------------------------------------
+class Game;
+
+
+//-----------------------------------------------------------------------------------------------
+// Shared by App and the headless runner, so neither build needs the other's translation units
+Game* CreateNewGameForMode(GameMode mode);
+char const* GetNameForGameMode(GameMode mode); // short name without spaces, also parsed by --mode
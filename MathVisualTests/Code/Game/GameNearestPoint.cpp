@@ -1,5 +1,9 @@
 #include "Game/GameNearestPoint.hpp"
 #include "Game/App.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Input/InputSystem.hpp"
@@ -7,6 +11,7 @@
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include <cmath>
 
 //-----------------------------------------------------------------------------------------------
 static constexpr float GNP_MOVESPEED = 200.f;
@@ -21,23 +26,12 @@ GameNearestPoint::GameNearestPoint()
 {
 	m_whiteDotPos = Vec2(SCREEN_SIZE_X * 0.5f, SCREEN_SIZE_Y * 0.5f);
 
-	m_shapeList.reserve(7);
-	Vec2 sceneDimensions = Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y);
-	m_shapeList.push_back(new GNPO_Disc(sceneDimensions));
-	m_shapeList.push_back(new GNPO_Triangle(sceneDimensions));
-	m_shapeList.push_back(new GNPO_AABB2(sceneDimensions));
-	m_shapeList.push_back(new GNPO_OBB2(sceneDimensions));
-	m_shapeList.push_back(new GNPO_Capsule2(sceneDimensions));
-	m_shapeList.push_back(new GNPO_LineSegment2(sceneDimensions));
-	m_shapeList.push_back(new GNPO_InfiniteLine(sceneDimensions));
+	m_shapes.AddOneOfEachType(Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y));
+	RebuildNearestPointQuery();
 }
 
 GameNearestPoint::~GameNearestPoint()
 {
-	for (GNPObject* ptr : m_shapeList) {
-		delete ptr;
-	}
-	m_shapeList.clear();
 }
 
 void GameNearestPoint::Update()
@@ -71,6 +65,7 @@ void GameNearestPoint::Update()
 		m_whiteDotPos = MapMouseCursorToWorldCoords2D(AABB2(m_camera.GetOrthoBottomLeft(), m_camera.GetOrthoTopRight()));
 	}
 
+	m_nearestPointQuery.Query(1, &m_whiteDotPos, m_nearestPointResults);
 
 	UpdateCameras();
 }
@@ -92,14 +87,12 @@ void GameNearestPoint::UpdateCameras()
 
 void GameNearestPoint::DrawUsage() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	AABB2 usageBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.93f, SCREEN_SIZE_X * 0.9995f, SCREEN_SIZE_Y * 0.99f);
 	Vec2 alignment(0.f, 1.f);
 	float cellAspect = 0.6f;
-	BitmapFont* testFont = nullptr;
-	testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
-	testFont->AddVertsForTextInBox2D(verts, GAME_TEXT + '\n' + GNP_TEXT, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&testFont->GetTexture());
+	g_textLayoutCache.AddVertsForTextInBox2D(verts, *m_font, GAME_TEXT + '\n' + GNP_TEXT, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
+	g_theRenderer->BindTexture(&m_font->GetTexture());
 
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -112,23 +105,26 @@ void GameNearestPoint::DrawUsage() const
 
 void GameNearestPoint::DrawObjects() const
 {
-	std::vector<Vertex_PCU> verts;
+	PROFILE_FUNCTION();
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 
-	for (GNPObject* shape : m_shapeList) {
-		shape->AddVerts(verts, (shape->IsPointInside(m_whiteDotPos)) ? LIGHT_BLUE : DARK_BLUE);
-	}
+	// Nearest points and inside flags come from the query made in Update, nothing is recomputed here
+	int shapeIndex = 0;
+	m_shapes.ForEachShape([&](auto const& shape)
+		{
+			shape.AddVerts(verts, (m_nearestPointResults.IsPointInside(shapeIndex, 0)) ? LIGHT_BLUE : DARK_BLUE);
+			++shapeIndex;
+		});
 
-	for (GNPObject* shape : m_shapeList) {
-		Vec2 nearestPoint = shape->GetNearestPoint(m_whiteDotPos);
-		AddVertsForDisc2D(verts, nearestPoint, GNP_ORANGE_DOT_RADIUS, ORANGE);
+	for (int resultIndex = 0; resultIndex < m_nearestPointResults.m_numShapes; ++resultIndex) {
+		AddVertsForDisc2D(verts, m_nearestPointResults.GetNearestPoint(resultIndex, 0), GNP_ORANGE_DOT_RADIUS, ORANGE);
 	}
 
 	// White dot
 	AddVertsForDisc2D(verts, m_whiteDotPos, GNP_WHITE_DOT_RADIUS, Rgba8::OPAQUE_WHITE);
 
-	for (GNPObject* shape : m_shapeList) {
-		Vec2 nearestPoint = shape->GetNearestPoint(m_whiteDotPos);
-		AddVertsForLineSegment2D(verts, nearestPoint, m_whiteDotPos, GNP_LINE_THICKNESS, TRANSLUCENT_WHITE);
+	for (int resultIndex = 0; resultIndex < m_nearestPointResults.m_numShapes; ++resultIndex) {
+		AddVertsForLineSegment2D(verts, m_nearestPointResults.GetNearestPoint(resultIndex, 0), m_whiteDotPos, GNP_LINE_THICKNESS, TRANSLUCENT_WHITE);
 	}
 
 	g_theRenderer->BindTexture(nullptr);
@@ -144,20 +140,130 @@ void GameNearestPoint::DrawObjects() const
 
 void GameNearestPoint::RandomizeSceneObjects()
 {
-	for (GNPObject* ptr : m_shapeList) {
-		delete ptr;
-	}
-	m_shapeList.clear();
+	m_shapes.Clear();
+
+	m_shapes.AddOneOfEachType(Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y));
+	RebuildNearestPointQuery();
+}
+
+void GameNearestPoint::RebuildNearestPointQuery()
+{
+	PROFILE_FUNCTION();
+	m_nearestPointQuery.Clear();
+	m_shapes.BuildNearestPointQuery(m_nearestPointQuery);
+	m_nearestPointQuery.Query(1, &m_whiteDotPos, m_nearestPointResults);
+}
 
-	m_shapeList.reserve(7);
+void GameNearestPoint::RunBenchmarks(BenchmarkReport& report)
+{
+	RunNearestPointBenchmark(report);
+}
+
+void GameNearestPoint::RunNearestPointBenchmark(BenchmarkReport& report) const
+{
+	// Per shape scalar calls (inside test plus nearest point, as DrawObjects used to do) against one batched query
+	constexpr int NUM_SHAPES_PER_TYPE = 100;
+	constexpr int NUM_REFERENCE_POINTS = 10000;
 	Vec2 sceneDimensions = Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y);
-	m_shapeList.push_back(new GNPO_Disc(sceneDimensions));
-	m_shapeList.push_back(new GNPO_Triangle(sceneDimensions));
-	m_shapeList.push_back(new GNPO_AABB2(sceneDimensions));
-	m_shapeList.push_back(new GNPO_OBB2(sceneDimensions));
-	m_shapeList.push_back(new GNPO_Capsule2(sceneDimensions));
-	m_shapeList.push_back(new GNPO_LineSegment2(sceneDimensions));
-	m_shapeList.push_back(new GNPO_InfiniteLine(sceneDimensions));
+
+	GNPShapePools shapes;
+	for (int i = 0; i < NUM_SHAPES_PER_TYPE; ++i)
+	{
+		shapes.AddOneOfEachType(sceneDimensions);
+	}
+	NearestPointQuery2D query;
+	shapes.BuildNearestPointQuery(query);
+	int numShapes = query.GetNumShapes();
+
+	std::vector<Vec2> referencePoints(NUM_REFERENCE_POINTS);
+	for (Vec2& point : referencePoints)
+	{
+		point = Vec2(g_rng.RollRandomFloatInRange(0.f, SCREEN_SIZE_X), g_rng.RollRandomFloatInRange(0.f, SCREEN_SIZE_Y));
+	}
+
+	std::vector<Vec2> scalarNearestPoints((size_t)numShapes * NUM_REFERENCE_POINTS);
+	std::vector<bool> scalarIsInside((size_t)numShapes * NUM_REFERENCE_POINTS);
+	BenchmarkTimer scalarTimer;
+	int shapeIndex = 0;
+	shapes.ForEachShape([&](auto const& shape)
+		{
+			size_t rowIndex = (size_t)shapeIndex * NUM_REFERENCE_POINTS;
+			for (int pointIndex = 0; pointIndex < NUM_REFERENCE_POINTS; ++pointIndex)
+			{
+				scalarIsInside[rowIndex + pointIndex] = shape.IsPointInside(referencePoints[pointIndex]);
+				scalarNearestPoints[rowIndex + pointIndex] = shape.GetNearestPoint(referencePoints[pointIndex]);
+			}
+			++shapeIndex;
+		});
+	double scalarSeconds = scalarTimer.GetElapsedSeconds();
+
+	NearestPointResults2D results;
+	BenchmarkTimer batchTimer;
+	query.Query(NUM_REFERENCE_POINTS, referencePoints.data(), results);
+	double batchSeconds = batchTimer.GetElapsedSeconds();
+
+	int numMismatches = 0;
+	for (shapeIndex = 0; shapeIndex < numShapes; ++shapeIndex)
+	{
+		for (int pointIndex = 0; pointIndex < NUM_REFERENCE_POINTS; ++pointIndex)
+		{
+			// Distances are compared, a point equally far from two triangle edges may pick either one
+			size_t scalarIndex = (size_t)shapeIndex * NUM_REFERENCE_POINTS + pointIndex;
+			float scalarDistance = (referencePoints[pointIndex] - scalarNearestPoints[scalarIndex]).GetLength();
+			if (results.IsPointInside(shapeIndex, pointIndex) != scalarIsInside[scalarIndex]
+				|| fabsf(results.GetDistance(shapeIndex, pointIndex) - scalarDistance) > 0.01f)
+			{
+				++numMismatches;
+			}
+		}
+	}
+
+	double numQueries = static_cast<double>(numShapes) * NUM_REFERENCE_POINTS;
+	double scalarMegaQueriesPerSecond = numQueries * 1e-6 / scalarSeconds;
+	double batchMegaQueriesPerSecond = numQueries * 1e-6 / batchSeconds;
+	report.AddSection(Stringf("Nearest point, %d shapes x %d points (Mqueries/s)", numShapes, NUM_REFERENCE_POINTS));
+	report.AddLine(Stringf("scalar %9.3f, batched SIMD %9.3f (x%.1f), %d mismatches",
+		scalarMegaQueriesPerSecond, batchMegaQueriesPerSecond, batchMegaQueriesPerSecond / scalarMegaQueriesPerSecond, numMismatches));
+}
+
+//-----------------------------------------------------------------------------------------------
+void GNPShapePools::Clear()
+{
+	m_discs.clear();
+	m_triangles.clear();
+	m_boxes.clear();
+	m_orientedBoxes.clear();
+	m_capsules.clear();
+	m_lineSegments.clear();
+	m_infiniteLines.clear();
+}
+
+void GNPShapePools::AddOneOfEachType(Vec2 const& sceneDimensions)
+{
+	m_discs.emplace_back(sceneDimensions);
+	m_triangles.emplace_back(sceneDimensions);
+	m_boxes.emplace_back(sceneDimensions);
+	m_orientedBoxes.emplace_back(sceneDimensions);
+	m_capsules.emplace_back(sceneDimensions);
+	m_lineSegments.emplace_back(sceneDimensions);
+	m_infiniteLines.emplace_back(sceneDimensions);
+}
+
+int GNPShapePools::GetNumShapes() const
+{
+	return (int)(m_discs.size() + m_triangles.size() + m_boxes.size() + m_orientedBoxes.size()
+		+ m_capsules.size() + m_lineSegments.size() + m_infiniteLines.size());
+}
+
+void GNPShapePools::BuildNearestPointQuery(NearestPointQuery2D& out_query) const
+{
+	for (GNPO_Disc const& shape : m_discs) { out_query.AddDisc(shape.m_discCenter, shape.m_discRadius); }
+	for (GNPO_Triangle const& shape : m_triangles) { out_query.AddTriangle(shape.m_triangle); }
+	for (GNPO_AABB2 const& shape : m_boxes) { out_query.AddAABB2(shape.m_box); }
+	for (GNPO_OBB2 const& shape : m_orientedBoxes) { out_query.AddOBB2(shape.m_obb); }
+	for (GNPO_Capsule2 const& shape : m_capsules) { out_query.AddCapsule2(shape.m_capsule); }
+	for (GNPO_LineSegment2 const& shape : m_lineSegments) { out_query.AddLineSegment2(shape.m_lineSegment); }
+	for (GNPO_InfiniteLine const& shape : m_infiniteLines) { out_query.AddInfiniteLine2(shape.m_infiniteLine); }
 }
 
 //-----------------------------------------------------------------------------------------------
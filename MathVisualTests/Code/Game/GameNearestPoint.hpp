@@ -1,5 +1,6 @@
 #pragma once
 #include "Game/Game.hpp"
+#include "Game/NearestPointQuery2D.hpp"
 #include "Engine/Math/Triangle2.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/OBB2.hpp"
@@ -10,101 +11,132 @@
 
 
 //-----------------------------------------------------------------------------------------------
-class GNPObject
-{
-public:
-	virtual ~GNPObject() {};
-
-	virtual bool IsPointInside(Vec2 const& point) const = 0;
-	virtual Vec2 GetNearestPoint(Vec2 const& ref) const = 0;
-	virtual void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const = 0;
-};
-
-class GNPO_Disc : public GNPObject
+// Plain value shapes without virtuals, each type is stored in its own contiguous pool
+class GNPO_Disc
 {
 public:
 	GNPO_Disc(Vec2 const& sceneDimensions);
 
-	virtual bool IsPointInside(Vec2 const& point) const override;
-	virtual Vec2 GetNearestPoint(Vec2 const& ref) const override;
-	virtual void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const override;
+	bool IsPointInside(Vec2 const& point) const;
+	Vec2 GetNearestPoint(Vec2 const& ref) const;
+	void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const;
 
 	Vec2 m_discCenter;
 	float m_discRadius;
 };
 
-class GNPO_Triangle : public GNPObject
+class GNPO_Triangle
 {
 public:
 	GNPO_Triangle(Vec2 const& sceneDimensions);
 
-	virtual bool IsPointInside(Vec2 const& point) const override;
-	virtual Vec2 GetNearestPoint(Vec2 const& ref) const override;
-	virtual void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const override;
+	bool IsPointInside(Vec2 const& point) const;
+	Vec2 GetNearestPoint(Vec2 const& ref) const;
+	void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const;
 
 	Triangle2 m_triangle;
 };
 
-class GNPO_AABB2 : public GNPObject
+class GNPO_AABB2
 {
 public:
 	GNPO_AABB2(Vec2 const& sceneDimensions);
 
-	virtual bool IsPointInside(Vec2 const& point) const override;
-	virtual Vec2 GetNearestPoint(Vec2 const& ref) const override;
-	virtual void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const override;
+	bool IsPointInside(Vec2 const& point) const;
+	Vec2 GetNearestPoint(Vec2 const& ref) const;
+	void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const;
 
 	AABB2 m_box;
 };
 
-class GNPO_OBB2 : public GNPObject
+class GNPO_OBB2
 {
 public:
 	GNPO_OBB2(Vec2 const& sceneDimensions);
 
-	virtual bool IsPointInside(Vec2 const& point) const override;
-	virtual Vec2 GetNearestPoint(Vec2 const& ref) const override;
-	virtual void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const override;
+	bool IsPointInside(Vec2 const& point) const;
+	Vec2 GetNearestPoint(Vec2 const& ref) const;
+	void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const;
 
 	OBB2 m_obb;
 };
 
-class GNPO_Capsule2 : public GNPObject
+class GNPO_Capsule2
 {
 public:
 	GNPO_Capsule2(Vec2 const& sceneDimensions);
 
-	virtual bool IsPointInside(Vec2 const& point) const override;
-	virtual Vec2 GetNearestPoint(Vec2 const& ref) const override;
-	virtual void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const override;
+	bool IsPointInside(Vec2 const& point) const;
+	Vec2 GetNearestPoint(Vec2 const& ref) const;
+	void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const;
 
 	Capsule2 m_capsule;
 };
 
-class GNPO_LineSegment2 : public GNPObject
+class GNPO_LineSegment2
 {
 public:
 	GNPO_LineSegment2(Vec2 const& sceneDimensions);
 
-	virtual bool IsPointInside(Vec2 const& point) const override;
-	virtual Vec2 GetNearestPoint(Vec2 const& ref) const override;
-	virtual void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const override;
+	bool IsPointInside(Vec2 const& point) const;
+	Vec2 GetNearestPoint(Vec2 const& ref) const;
+	void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const;
 
 	LineSegment2 m_lineSegment;
 };
 
-class GNPO_InfiniteLine : public GNPObject
+class GNPO_InfiniteLine
 {
 public:
 	GNPO_InfiniteLine(Vec2 const& sceneDimensions);
 
-	virtual bool IsPointInside(Vec2 const& point) const override;
-	virtual Vec2 GetNearestPoint(Vec2 const& ref) const override;
-	virtual void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const override;
+	bool IsPointInside(Vec2 const& point) const;
+	Vec2 GetNearestPoint(Vec2 const& ref) const;
+	void AddVerts(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const;
 
 	LineSegment2 m_infiniteLine;
 };
 
+//-----------------------------------------------------------------------------------------------
+// One contiguous array per shape type. Queries run one type at a time, so every loop walks a
+// single array of values and calls the shape functions directly, with no virtual dispatch.
+// Pools keep their capacity across Clear(), re-randomizing does not touch the heap.
+class GNPShapePools
+{
+public:
+	void Clear();
+	void AddOneOfEachType(Vec2 const& sceneDimensions);
+	int GetNumShapes() const;
+
+	// Shape indexes in the query follow the ForEachShape order
+	void BuildNearestPointQuery(NearestPointQuery2D& out_query) const;
+
+	// func(shape) for every shape, grouped by type
+	template<typename ShapeFunc>
+	void ForEachShape(ShapeFunc&& func) const;
+
+public:
+	std::vector<GNPO_Disc>			m_discs;
+	std::vector<GNPO_Triangle>		m_triangles;
+	std::vector<GNPO_AABB2>			m_boxes;
+	std::vector<GNPO_OBB2>			m_orientedBoxes;
+	std::vector<GNPO_Capsule2>		m_capsules;
+	std::vector<GNPO_LineSegment2>	m_lineSegments;
+	std::vector<GNPO_InfiniteLine>	m_infiniteLines;
+};
+
+template<typename ShapeFunc>
+void GNPShapePools::ForEachShape(ShapeFunc&& func) const
+{
+	for (GNPO_Disc const& shape : m_discs) { func(shape); }
+	for (GNPO_Triangle const& shape : m_triangles) { func(shape); }
+	for (GNPO_AABB2 const& shape : m_boxes) { func(shape); }
+	for (GNPO_OBB2 const& shape : m_orientedBoxes) { func(shape); }
+	for (GNPO_Capsule2 const& shape : m_capsules) { func(shape); }
+	for (GNPO_LineSegment2 const& shape : m_lineSegments) { func(shape); }
+	for (GNPO_InfiniteLine const& shape : m_infiniteLines) { func(shape); }
+}
+
 //-----------------------------------------------------------------------------------------------
 
 class GameNearestPoint : public Game
@@ -116,17 +148,23 @@ public:
 	virtual void Update() override;
 	virtual void Render() const override;
 	virtual void RandomizeSceneObjects() override;
+	virtual void RunBenchmarks(BenchmarkReport& report) override;
 
 private:
 	virtual void UpdateCameras() override;
 	virtual void DrawUsage() const override;
 
+	void RebuildNearestPointQuery();
+	void RunNearestPointBenchmark(BenchmarkReport& report) const;
+
 	void DrawObjects() const;
 
 private:
 	Camera m_camera;
 
-	std::vector<GNPObject*> m_shapeList;
+	GNPShapePools m_shapes;
+	NearestPointQuery2D m_nearestPointQuery;
+	NearestPointResults2D m_nearestPointResults; // for m_whiteDotPos, refreshed every Update
 	Vec2 m_whiteDotPos;
 };
 
@@ -1,11 +1,16 @@
 #include "Game/GameRaycastVsDiscs.hpp"
 #include "Game/App.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/RaycastBenchmark2D.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include <cmath>
 
 //-----------------------------------------------------------------------------------------------
 static constexpr float GRD_MOVESPEED = 200.f;
@@ -15,7 +20,7 @@ static constexpr float GRD_ARROW_SIZE = 25.f;
 static constexpr float GRD_NORMAL_ARROW_LENGTH = 100.f;
 static constexpr int	DISC_NUM = 12;
 
-static const std::string GRV_TEXT = "GameRaycastVsDiscs: Ray Start (ESDF/LMB), Ray End(IJKL/RMB), Arrow Key(entire ray)";
+static const std::string GRV_TEXT = "GameRaycastVsDiscs: Ray Start (ESDF/LMB), Ray End(IJKL/RMB), Arrow Key(entire ray), B(toggle BVH)";
 
 
 //-----------------------------------------------------------------------------------------------
@@ -29,22 +34,24 @@ GameRaycastVsDiscs::GameRaycastVsDiscs()
 	m_shapeList.reserve(DISC_NUM);
 	for (int i = 0; i < DISC_NUM; ++i)
 	{
-		m_shapeList.push_back(new GRDO_Disc(sceneDimensions));
+		m_shapeList.emplace_back(sceneDimensions);
 	}
+	RebuildRaycastScene();
 }
 
 GameRaycastVsDiscs::~GameRaycastVsDiscs()
 {
-	for (GRDO_Disc* ptr : m_shapeList) {
-		delete ptr;
-	}
-	m_shapeList.clear();
 }
 
 void GameRaycastVsDiscs::Update()
 {
 	UpdateDeveloperCheats();
 
+	if (g_theInput->WasKeyJustPressed(KEYCODE_B))
+	{
+		m_isUsingBVH = !m_isUsingBVH;
+	}
+
 	HandleInput();
 	DoRaycast();
 
@@ -68,14 +75,12 @@ void GameRaycastVsDiscs::UpdateCameras()
 
 void GameRaycastVsDiscs::DrawUsage() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	AABB2 usageBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.93f, SCREEN_SIZE_X * 0.9995f, SCREEN_SIZE_Y * 0.99f);
 	Vec2 alignment(0.f, 1.f);
 	float cellAspect = 0.6f;
-	BitmapFont* testFont = nullptr;
-	testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
-	testFont->AddVertsForTextInBox2D(verts, GAME_TEXT + '\n' + GRV_TEXT, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&testFont->GetTexture());
+	g_textLayoutCache.AddVertsForTextInBox2D(verts, *m_font, GAME_TEXT + '\n' + GRV_TEXT, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
+	g_theRenderer->BindTexture(&m_font->GetTexture());
 
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -88,17 +93,16 @@ void GameRaycastVsDiscs::DrawUsage() const
 
 void GameRaycastVsDiscs::RandomizeSceneObjects()
 {
-	for (GRDO_Disc* ptr : m_shapeList) {
-		delete ptr;
-	}
 	m_shapeList.clear();
+	m_hitShapeIndex = -1;
 
 	Vec2 sceneDimensions = Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y);
 	m_shapeList.reserve(DISC_NUM);
 	for (int i = 0; i < DISC_NUM; ++i)
 	{
-		m_shapeList.push_back(new GRDO_Disc(sceneDimensions));
+		m_shapeList.emplace_back(sceneDimensions);
 	}
+	RebuildRaycastScene();
 }
 
 void GameRaycastVsDiscs::HandleInput()
@@ -182,42 +186,89 @@ void GameRaycastVsDiscs::HandleInput()
 
 void GameRaycastVsDiscs::DoRaycast()
 {
-	m_hitDisc = nullptr;
+	PROFILE_FUNCTION();
+	m_hitShapeIndex = -1;
 	m_raycastResult = {};
-	for (int i = 0; i < (int)m_shapeList.size(); ++i)
+
+	// The ray is normalized once, the SoA scene finds the closest shape and only that one is raycast in full
+	Vec2 disp = m_endPos - m_startPos;
+	Vec2 rayForwardNormal = disp.GetNormalized();
+	float rayLength = disp.GetLength();
+	if (m_isUsingBVH)
 	{
-		Vec2 disp = m_endPos - m_startPos;
-		RaycastResult2D result = RaycastVsDisc2D(m_startPos, disp.GetNormalized(), disp.GetLength(), m_shapeList[i]->m_center, m_shapeList[i]->m_radius);
-		if (result.m_didImpact)
-		{
-			if (!m_raycastResult.m_didImpact)
+		// Ordered BVH traversal, nodes entered past the closest impact so far are skipped
+		auto leafRaycast = [&](int shapeIndex, float closestDist)
 			{
-				m_raycastResult = result;
-				m_hitDisc = m_shapeList[i];
-			}
-			else
-			{
-				if (m_raycastResult.m_impactDist > result.m_impactDist)
+				RaycastResult2D result = RaycastVsShape(m_shapeList[shapeIndex], m_startPos, rayForwardNormal, rayLength);
+				if (!result.m_didImpact || result.m_impactDist >= closestDist)
 				{
-					m_raycastResult = result;
-					m_hitDisc = m_shapeList[i];
+					return -1.f;
 				}
-			}
-		}
+				m_raycastResult = result;
+				m_hitShapeIndex = shapeIndex;
+				return result.m_impactDist;
+			};
+		m_shapeBVH.RaycastClosest(m_startPos, rayForwardNormal, rayLength, leafRaycast);
+		return;
+	}
+
+	RaycastSceneHit2D hit = m_raycastScene.RaycastClosest(m_startPos, rayForwardNormal, rayLength);
+	if (hit.DidImpact())
+	{
+		m_raycastResult = m_raycastScene.GetRaycastResult(hit, m_startPos, rayForwardNormal, rayLength);
+		m_hitShapeIndex = hit.m_shapeIndex;
+	}
+}
+
+void GameRaycastVsDiscs::RebuildRaycastScene()
+{
+	PROFILE_FUNCTION();
+	m_raycastScene.Clear();
+	m_raycastScene.Reserve((int)m_shapeList.size());
+	for (GRDO_Disc const& shape : m_shapeList)
+	{
+		m_raycastScene.AddDisc(shape.m_center, shape.m_radius);
+	}
+
+	std::vector<AABB2> shapeBounds;
+	shapeBounds.reserve(m_shapeList.size());
+	for (GRDO_Disc const& shape : m_shapeList)
+	{
+		shapeBounds.push_back(GetShapeBounds(shape));
 	}
+	m_shapeBVH.Build(shapeBounds);
+}
 
+//-----------------------------------------------------------------------------------------------
+AABB2 GameRaycastVsDiscs::GetShapeBounds(GRDO_Disc const& shape)
+{
+	return AABB2(shape.m_center - Vec2(shape.m_radius, shape.m_radius), shape.m_center + Vec2(shape.m_radius, shape.m_radius));
+}
+
+RaycastResult2D GameRaycastVsDiscs::RaycastVsShape(GRDO_Disc const& shape, Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength)
+{
+	return RaycastVsDisc2D(rayStart, rayForwardNormal, rayLength, shape.m_center, shape.m_radius);
+}
+
+void GameRaycastVsDiscs::RunBenchmarks(BenchmarkReport& report)
+{
+	RunRaycastBenchmark2D<GRDO_Disc, DiscRaycastScene2D>(report, "discs",
+		[](DiscRaycastScene2D& scene, GRDO_Disc const& shape) { scene.AddDisc(shape.m_center, shape.m_radius); },
+		[](GRDO_Disc const& shape, Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) { return RaycastVsShape(shape, rayStart, rayForwardNormal, rayLength); },
+		[](GRDO_Disc const& shape) { return GetShapeBounds(shape); });
 }
 
 void GameRaycastVsDiscs::DrawObjects() const
 {
-	std::vector<Vertex_PCU> verts;
-	for (GRDO_Disc* shape : m_shapeList) {
-		AddVertsForDisc2D(verts, shape->m_center, shape->m_radius, DARK_BLUE);
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
+	for (GRDO_Disc const& shape : m_shapeList) {
+		AddVertsForDisc2D(verts, shape.m_center, shape.m_radius, DARK_BLUE);
 	}
 
-	if (m_hitDisc)
+	if (m_hitShapeIndex != -1)
 	{
-		AddVertsForDisc2D(verts, m_hitDisc->m_center, m_hitDisc->m_radius, LIGHT_BLUE);
+		GRDO_Disc const& hitDisc = m_shapeList[m_hitShapeIndex];
+		AddVertsForDisc2D(verts, hitDisc.m_center, hitDisc.m_radius, LIGHT_BLUE);
 	}
 
 	if (!m_raycastResult.m_didImpact)
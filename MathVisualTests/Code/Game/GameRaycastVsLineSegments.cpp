@@ -1,17 +1,22 @@
 #include "Game/GameRaycastVsLineSegments.hpp"
 #include "Game/App.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/RaycastBenchmark2D.hpp"
+#include "Game/TextLayoutCache.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include <cmath>
 
 //-----------------------------------------------------------------------------------------------
 static constexpr int	LINE_SEGMENT_NUM = 20;
 static constexpr float LINE_SEGMENT_THICKNESS = 5.f;
 
-static const std::string GRL_TEXT = "GameRaycastVsLineSegments: Ray Start (ESDF/LMB), Ray End(IJKL/RMB), Arrow Key(entire ray)";
+static const std::string GRL_TEXT = "GameRaycastVsLineSegments: Ray Start (ESDF/LMB), Ray End(IJKL/RMB), Arrow Key(entire ray), B(toggle BVH)";
 
 
 //-----------------------------------------------------------------------------------------------
@@ -24,22 +29,24 @@ GameRaycastVsLineSegments::GameRaycastVsLineSegments()
 	m_shapeList.reserve(LINE_SEGMENT_NUM);
 	for (int i = 0; i < LINE_SEGMENT_NUM; ++i)
 	{
-		m_shapeList.push_back(new GRO_LineSegement(sceneDimensions));
+		m_shapeList.emplace_back(sceneDimensions);
 	}
+	RebuildRaycastScene();
 }
 
 GameRaycastVsLineSegments::~GameRaycastVsLineSegments()
 {
-	for (GRO_LineSegement* ptr : m_shapeList) {
-		delete ptr;
-	}
-	m_shapeList.clear();
 }
 
 void GameRaycastVsLineSegments::Update()
 {
 	UpdateDeveloperCheats();
 
+	if (g_theInput->WasKeyJustPressed(KEYCODE_B))
+	{
+		m_isUsingBVH = !m_isUsingBVH;
+	}
+
 	HandleInput();
 	DoRaycast();
 
@@ -63,14 +70,12 @@ void GameRaycastVsLineSegments::UpdateCameras()
 
 void GameRaycastVsLineSegments::DrawUsage() const
 {
-	std::vector<Vertex_PCU> verts;
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
 	AABB2 usageBox(SCREEN_SIZE_X * 0.005f, SCREEN_SIZE_Y * 0.93f, SCREEN_SIZE_X * 0.9995f, SCREEN_SIZE_Y * 0.99f);
 	Vec2 alignment(0.f, 1.f);
 	float cellAspect = 0.6f;
-	BitmapFont* testFont = nullptr;
-	testFont = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
-	testFont->AddVertsForTextInBox2D(verts, GAME_TEXT + '\n' + GRL_TEXT, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
-	g_theRenderer->BindTexture(&testFont->GetTexture());
+	g_textLayoutCache.AddVertsForTextInBox2D(verts, *m_font, GAME_TEXT + '\n' + GRL_TEXT, usageBox, 20.f, Rgba8(255, 150, 50), cellAspect, alignment, TextBoxMode::SHRINK_TO_FIT);
+	g_theRenderer->BindTexture(&m_font->GetTexture());
 
 	g_theRenderer->BindShader(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
@@ -83,17 +88,16 @@ void GameRaycastVsLineSegments::DrawUsage() const
 
 void GameRaycastVsLineSegments::RandomizeSceneObjects()
 {
-	for (GRO_LineSegement* ptr : m_shapeList) {
-		delete ptr;
-	}
 	m_shapeList.clear();
+	m_hitShapeIndex = -1;
 
 	Vec2 sceneDimensions = Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y);
 	m_shapeList.reserve(LINE_SEGMENT_NUM);
 	for (int i = 0; i < LINE_SEGMENT_NUM; ++i)
 	{
-		m_shapeList.push_back(new GRO_LineSegement(sceneDimensions));
+		m_shapeList.emplace_back(sceneDimensions);
 	}
+	RebuildRaycastScene();
 }
 
 void GameRaycastVsLineSegments::HandleInput()
@@ -177,42 +181,89 @@ void GameRaycastVsLineSegments::HandleInput()
 
 void GameRaycastVsLineSegments::DoRaycast()
 {
-	m_hitObject = nullptr;
+	PROFILE_FUNCTION();
+	m_hitShapeIndex = -1;
 	m_raycastResult = {};
-	for (int i = 0; i < (int)m_shapeList.size(); ++i)
+
+	// The ray is normalized once, the SoA scene finds the closest shape and only that one is raycast in full
+	Vec2 disp = m_endPos - m_startPos;
+	Vec2 rayForwardNormal = disp.GetNormalized();
+	float rayLength = disp.GetLength();
+	if (m_isUsingBVH)
 	{
-		Vec2 disp = m_endPos - m_startPos;
-		RaycastResult2D result = RaycastVsLineSegment2D(m_startPos, disp.GetNormalized(), disp.GetLength(), m_shapeList[i]->m_start, m_shapeList[i]->m_end);
-		if (result.m_didImpact)
-		{
-			if (!m_raycastResult.m_didImpact)
+		// Ordered BVH traversal, nodes entered past the closest impact so far are skipped
+		auto leafRaycast = [&](int shapeIndex, float closestDist)
 			{
-				m_raycastResult = result;
-				m_hitObject = m_shapeList[i];
-			}
-			else
-			{
-				if (m_raycastResult.m_impactDist > result.m_impactDist)
+				RaycastResult2D result = RaycastVsShape(m_shapeList[shapeIndex], m_startPos, rayForwardNormal, rayLength);
+				if (!result.m_didImpact || result.m_impactDist >= closestDist)
 				{
-					m_raycastResult = result;
-					m_hitObject = m_shapeList[i];
+					return -1.f;
 				}
-			}
-		}
+				m_raycastResult = result;
+				m_hitShapeIndex = shapeIndex;
+				return result.m_impactDist;
+			};
+		m_shapeBVH.RaycastClosest(m_startPos, rayForwardNormal, rayLength, leafRaycast);
+		return;
+	}
+
+	RaycastSceneHit2D hit = m_raycastScene.RaycastClosest(m_startPos, rayForwardNormal, rayLength);
+	if (hit.DidImpact())
+	{
+		m_raycastResult = m_raycastScene.GetRaycastResult(hit, m_startPos, rayForwardNormal, rayLength);
+		m_hitShapeIndex = hit.m_shapeIndex;
+	}
+}
+
+void GameRaycastVsLineSegments::RebuildRaycastScene()
+{
+	PROFILE_FUNCTION();
+	m_raycastScene.Clear();
+	m_raycastScene.Reserve((int)m_shapeList.size());
+	for (GRO_LineSegement const& shape : m_shapeList)
+	{
+		m_raycastScene.AddLineSegment(shape.m_start, shape.m_end);
+	}
+
+	std::vector<AABB2> shapeBounds;
+	shapeBounds.reserve(m_shapeList.size());
+	for (GRO_LineSegement const& shape : m_shapeList)
+	{
+		shapeBounds.push_back(GetShapeBounds(shape));
 	}
+	m_shapeBVH.Build(shapeBounds);
+}
 
+//-----------------------------------------------------------------------------------------------
+AABB2 GameRaycastVsLineSegments::GetShapeBounds(GRO_LineSegement const& shape)
+{
+	return AABB2(fminf(shape.m_start.x, shape.m_end.x), fminf(shape.m_start.y, shape.m_end.y), fmaxf(shape.m_start.x, shape.m_end.x), fmaxf(shape.m_start.y, shape.m_end.y));
+}
+
+RaycastResult2D GameRaycastVsLineSegments::RaycastVsShape(GRO_LineSegement const& shape, Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength)
+{
+	return RaycastVsLineSegment2D(rayStart, rayForwardNormal, rayLength, shape.m_start, shape.m_end);
+}
+
+void GameRaycastVsLineSegments::RunBenchmarks(BenchmarkReport& report)
+{
+	RunRaycastBenchmark2D<GRO_LineSegement, LineSegmentRaycastScene2D>(report, "line segments",
+		[](LineSegmentRaycastScene2D& scene, GRO_LineSegement const& shape) { scene.AddLineSegment(shape.m_start, shape.m_end); },
+		[](GRO_LineSegement const& shape, Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) { return RaycastVsShape(shape, rayStart, rayForwardNormal, rayLength); },
+		[](GRO_LineSegement const& shape) { return GetShapeBounds(shape); });
 }
 
 void GameRaycastVsLineSegments::DrawObjects() const
 {
-	std::vector<Vertex_PCU> verts;
-	for (GRO_LineSegement* shape : m_shapeList) {
-		AddVertsForLineSegment2D(verts, shape->m_start, shape->m_end, LINE_SEGMENT_THICKNESS, DARK_BLUE);
+	std::vector<Vertex_PCU>& verts = g_frameArena.AcquireVertexBuffer();
+	for (GRO_LineSegement const& shape : m_shapeList) {
+		AddVertsForLineSegment2D(verts, shape.m_start, shape.m_end, LINE_SEGMENT_THICKNESS, DARK_BLUE);
 	}
 
-	if (m_hitObject)
+	if (m_hitShapeIndex != -1)
 	{
-		AddVertsForLineSegment2D(verts, m_hitObject->m_start, m_hitObject->m_end, LINE_SEGMENT_THICKNESS, LIGHT_BLUE);
+		GRO_LineSegement const& hitObject = m_shapeList[m_hitShapeIndex];
+		AddVertsForLineSegment2D(verts, hitObject.m_start, hitObject.m_end, LINE_SEGMENT_THICKNESS, LIGHT_BLUE);
 	}
 
 	if (!m_raycastResult.m_didImpact)
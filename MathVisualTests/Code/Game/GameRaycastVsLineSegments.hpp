@@ -1,5 +1,7 @@
 #pragma once
 #include "Game/Game.hpp"
+#include "Game/BVH2D.hpp"
+#include "Game/RaycastScene2D.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Math/RaycastUtils.hpp"
 #include <vector>
@@ -22,6 +24,7 @@ public:
 	virtual void Update() override;
 	virtual void Render() const override;
 	virtual void RandomizeSceneObjects() override;
+	virtual void RunBenchmarks(BenchmarkReport& report) override;
 
 
 private:
@@ -30,6 +33,10 @@ private:
 	
 	void HandleInput();
 	void DoRaycast();
+	void RebuildRaycastScene();
+
+	static AABB2 GetShapeBounds(GRO_LineSegement const& shape);
+	static RaycastResult2D RaycastVsShape(GRO_LineSegement const& shape, Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength);
 
 	void DrawObjects() const;
 private:
@@ -37,8 +44,11 @@ private:
 	Vec2 m_startPos;
 	Vec2 m_endPos;
 
-	GRO_LineSegement* m_hitObject = nullptr;
+	int m_hitShapeIndex = -1; // in m_shapeList, -1 when nothing is hit
 	RaycastResult2D m_raycastResult;
-	std::vector<GRO_LineSegement*> m_shapeList;
+	std::vector<GRO_LineSegement> m_shapeList; // stored by value, contiguous
+	LineSegmentRaycastScene2D m_raycastScene; // same order as m_shapeList
+	BVH2D m_shapeBVH; // primitive indexes are m_shapeList indexes
+	bool m_isUsingBVH = false;
 };
 
@@ -0,0 +1,414 @@
+#include "Game/HeadlessRunner.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/DrawQueue.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/Game.hpp"
+#include "Game/GameModes.hpp"
+#include "Game/NullRenderer.hpp"
+#include "Game/TextLayoutCache.hpp"
+#include "Engine/Core/Clock.hpp"
+#include "Engine/Core/DebugRender.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Input/InputSystem.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+
+//-----------------------------------------------------------------------------------------------
+// The headless build has no App.cpp, so the globals it would define live here
+App*			g_theApp		= nullptr;		// no App in headless runs
+Window*			g_theWindow		= nullptr;		// no window in headless runs
+Renderer*		g_theRenderer	= nullptr;		// a NullRenderer created and owned by the HeadlessRunner
+bool			g_isDebugDraw	= false;
+RandomNumberGenerator g_rng;
+FrameArena		g_frameArena;
+DrawQueue		g_drawQueue;
+TextLayoutCache	g_textLayoutCache;
+
+
+//-----------------------------------------------------------------------------------------------
+struct ScriptKeyName
+{
+	char const* m_name;
+	unsigned char m_keyCode;
+};
+
+static bool GetKeyCodeForScriptName(std::string const& keyName, unsigned char& out_keyCode)
+{
+	// Letter and digit key codes are their ASCII characters
+	if (keyName.size() == 1 && ((keyName[0] >= 'A' && keyName[0] <= 'Z') || (keyName[0] >= '0' && keyName[0] <= '9')))
+	{
+		out_keyCode = static_cast<unsigned char>(keyName[0]);
+		return true;
+	}
+	// Built on first use, after the engine's KEYCODE_ constants are initialized
+	static ScriptKeyName const SCRIPT_KEY_NAMES[] =
+	{
+		{ "F1", KEYCODE_F1 }, { "F2", KEYCODE_F2 }, { "F3", KEYCODE_F3 }, { "F4", KEYCODE_F4 }, { "F5", KEYCODE_F5 }, { "F6", KEYCODE_F6 },
+		{ "F7", KEYCODE_F7 }, { "F8", KEYCODE_F8 }, { "F9", KEYCODE_F9 }, { "F10", KEYCODE_F10 }, { "F11", KEYCODE_F11 },
+		{ "SPACE", KEYCODE_SPACE }, { "ESCAPE", KEYCODE_ESCAPE }, { "ENTER", KEYCODE_ENTER }, { "SHIFT", KEYCODE_SHIFT },
+		{ "UP", KEYCODE_UP }, { "DOWN", KEYCODE_DOWN }, { "LEFT", KEYCODE_LEFT }, { "RIGHT", KEYCODE_RIGHT },
+		{ "LEFT_MOUSE", KEYCODE_LEFT_MOUSE }, { "RIGHT_MOUSE", KEYCODE_RIGHT_MOUSE },
+	};
+	for (ScriptKeyName const& scriptKeyName : SCRIPT_KEY_NAMES)
+	{
+		if (keyName == scriptKeyName.m_name)
+		{
+			out_keyCode = scriptKeyName.m_keyCode;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+//-----------------------------------------------------------------------------------------------
+static bool ParseGameModes(std::string const& modeText, std::vector<GameMode>& out_modes)
+{
+	if (modeText == "all")
+	{
+		for (int modeIndex = 0; modeIndex < GAME_MODE_NUM; ++modeIndex)
+		{
+			out_modes.push_back(static_cast<GameMode>(modeIndex));
+		}
+		return true;
+	}
+	for (int modeIndex = 0; modeIndex < GAME_MODE_NUM; ++modeIndex)
+	{
+		GameMode mode = static_cast<GameMode>(modeIndex);
+		if (modeText == GetNameForGameMode(mode) || modeText == std::to_string(modeIndex))
+		{
+			out_modes.push_back(mode);
+			return true;
+		}
+	}
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool ScriptedInput::LoadFromFile(std::string const& filePath)
+{
+	std::ifstream scriptFile(filePath);
+	if (!scriptFile.is_open())
+	{
+		printf("ERROR: could not open input script \"%s\"\n", filePath.c_str());
+		return false;
+	}
+
+	m_events.clear();
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(scriptFile, line))
+	{
+		lineNumber++;
+		line = line.substr(0, line.find('#'));
+		std::istringstream lineStream(line);
+		int frameIndex = 0;
+		std::string action;
+		std::string keyName;
+		if (!(lineStream >> frameIndex))
+		{
+			continue; // blank or comment
+		}
+
+		unsigned char keyCode = 0;
+		if (!(lineStream >> action >> keyName) || !GetKeyCodeForScriptName(keyName, keyCode) || (action != "press" && action != "release" && action != "tap"))
+		{
+			printf("ERROR: input script \"%s\" line %d should be \"<frame> <press|release|tap> <key>\"\n", filePath.c_str(), lineNumber);
+			return false;
+		}
+		if (action == "tap")
+		{
+			m_events.push_back({ frameIndex, keyCode, true });
+			m_events.push_back({ frameIndex + 1, keyCode, false });
+		}
+		else
+		{
+			m_events.push_back({ frameIndex, keyCode, action == "press" });
+		}
+	}
+
+	std::stable_sort(m_events.begin(), m_events.end(), [](ScriptedKeyEvent const& a, ScriptedKeyEvent const& b) { return a.m_frameIndex < b.m_frameIndex; });
+	return true;
+}
+
+void ScriptedInput::ApplyEventsForFrame(int frameIndex) const
+{
+	auto firstEvent = std::lower_bound(m_events.begin(), m_events.end(), frameIndex, [](ScriptedKeyEvent const& event, int frame) { return event.m_frameIndex < frame; });
+	for (auto eventIter = firstEvent; eventIter != m_events.end() && eventIter->m_frameIndex == frameIndex; ++eventIter)
+	{
+		if (eventIter->m_isPressed)
+		{
+			g_theInput->HandleKeyPressed(eventIter->m_keyCode);
+		}
+		else
+		{
+			g_theInput->HandleKeyReleased(eventIter->m_keyCode);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+HeadlessRunner::HeadlessRunner(HeadlessRunConfig const& config)
+	: m_config(config)
+{
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+}
+
+int HeadlessRunner::Run()
+{
+	if (!m_config.m_inputScriptPath.empty() && !m_scriptedInput.LoadFromFile(m_config.m_inputScriptPath))
+	{
+		return 1;
+	}
+
+	Startup();
+	printf("Headless run: %d frames per mode, dt %.4f s, %s%s\n", m_config.m_numFrames, m_config.m_fixedDeltaSeconds,
+		m_config.m_isRenderEnabled ? "update + render" : "update only", m_config.m_isBenchmarking ? ", benchmarks" : "");
+	for (GameMode mode : m_config.m_modes)
+	{
+		RunMode(mode);
+	}
+	Shutdown();
+	return 0;
+}
+
+void HeadlessRunner::Startup()
+{
+	ProfilerStartup();
+
+	EventSystemConfig eventSystemConfig;
+	g_theEventSystem = new EventSystem(eventSystemConfig);
+
+	InputConfig inputConfig;
+	g_theInput = new InputSystem(inputConfig);
+
+	// No window, the game modes never reach for g_theWindow
+	RendererConfig rendererConfig;
+	m_nullRenderer = new NullRenderer(rendererConfig);
+	g_theRenderer = m_nullRenderer;
+
+	DebugRenderConfig debugRenderConfig;
+	debugRenderConfig.m_renderer = g_theRenderer;
+
+	g_theEventSystem->Startup();
+	g_theInput->Startup();
+	g_theRenderer->Startup();
+	DebugRenderSystemStartup(debugRenderConfig);
+}
+
+void HeadlessRunner::Shutdown()
+{
+	DebugRenderSystemShutdown();
+	g_theRenderer->Shutdown();
+	g_theInput->Shutdown();
+	g_theEventSystem->Shutdown();
+
+	delete g_theRenderer;
+	g_theRenderer = nullptr;
+	m_nullRenderer = nullptr;
+	delete g_theInput;
+	g_theInput = nullptr;
+	delete g_theEventSystem;
+	g_theEventSystem = nullptr;
+
+	ProfilerShutdown();
+}
+
+//-----------------------------------------------------------------------------------------------
+struct HeadlessTimeStats
+{
+	float m_min = 0.f;
+	float m_avg = 0.f;
+	float m_p50 = 0.f;
+	float m_p99 = 0.f;
+	float m_max = 0.f;
+};
+
+static HeadlessTimeStats GetTimeStats(std::vector<float> samples)
+{
+	HeadlessTimeStats stats;
+	if (samples.empty())
+	{
+		return stats;
+	}
+	std::sort(samples.begin(), samples.end());
+	int numSamples = static_cast<int>(samples.size());
+	float sum = 0.f;
+	for (float sample : samples)
+	{
+		sum += sample;
+	}
+	stats.m_min = samples.front();
+	stats.m_avg = sum / static_cast<float>(numSamples);
+	stats.m_p50 = samples[numSamples / 2];
+	stats.m_p99 = samples[(numSamples * 99 + 99) / 100 - 1];
+	stats.m_max = samples.back();
+	return stats;
+}
+
+void HeadlessRunner::RunMode(GameMode mode)
+{
+	int numFrames = m_config.m_numFrames;
+	std::vector<float> updateMilliseconds;
+	std::vector<float> renderMilliseconds;
+	std::vector<float> frameMilliseconds;
+	updateMilliseconds.reserve(numFrames);
+	renderMilliseconds.reserve(numFrames);
+	frameMilliseconds.reserve(numFrames);
+	long long totalDrawCalls = 0;
+	long long totalVertices = 0;
+	long long totalStateCalls = 0;
+	long long totalQueueSubmits = 0;
+	long long totalQueueDrawCallsSaved = 0;
+	long long totalQueueStateCallsSaved = 0;
+	size_t peakArenaBytes = 0;
+
+	// A fresh game per mode, scripted frames count from 0 in each, and so do the profiler stats
+	Game* game = CreateNewGameForMode(mode);
+	ProfilerResetStats();
+	for (int frameIndex = 0; frameIndex < numFrames; ++frameIndex)
+	{
+		auto frameStartTime = std::chrono::steady_clock::now();
+
+		ProfilerBeginFrame();
+		Clock::AdvanceSystemClock(static_cast<double>(m_config.m_fixedDeltaSeconds)); // fixed dt instead of TickSystemClock's wall clock
+		g_theEventSystem->BeginFrame();
+		g_theInput->BeginFrame();
+		g_theRenderer->BeginFrame();
+		DebugRenderBeginFrame();
+		m_scriptedInput.ApplyEventsForFrame(frameIndex);
+
+		auto updateStartTime = std::chrono::steady_clock::now();
+		game->Update();
+		auto updateEndTime = std::chrono::steady_clock::now();
+		updateMilliseconds.push_back(std::chrono::duration<float, std::milli>(updateEndTime - updateStartTime).count());
+
+		if (m_config.m_isRenderEnabled)
+		{
+			game->Render();
+			renderMilliseconds.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - updateEndTime).count());
+			totalDrawCalls += m_nullRenderer->GetFrameStats().m_numDrawCalls;
+			totalVertices += m_nullRenderer->GetFrameStats().m_numVertices;
+			totalStateCalls += m_nullRenderer->GetFrameStats().m_numStateCalls;
+		}
+
+		DebugRenderEndFrame();
+		g_theRenderer->EndFrame();
+		g_theInput->EndFrame();
+		g_theEventSystem->EndFrame();
+		g_frameArena.Reset();
+		g_drawQueue.EndFrame();
+		totalQueueSubmits += g_drawQueue.GetLastFrameStats().m_numSubmits;
+		totalQueueDrawCallsSaved += g_drawQueue.GetLastFrameStats().GetNumDrawCallsSaved();
+		totalQueueStateCallsSaved += g_drawQueue.GetLastFrameStats().GetNumStateCallsSaved();
+		peakArenaBytes = (g_frameArena.GetLastFrameBytes() > peakArenaBytes) ? g_frameArena.GetLastFrameBytes() : peakArenaBytes;
+		frameMilliseconds.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStartTime).count());
+		ProfilerEndFrame();
+	}
+
+	BenchmarkReport benchmarkReport;
+	if (m_config.m_isBenchmarking)
+	{
+		game->RunBenchmarks(benchmarkReport);
+	}
+	delete game;
+
+	// Release whatever the script left held so the next mode starts clean
+	for (int keyCode = 0; keyCode < 256; ++keyCode)
+	{
+		g_theInput->HandleKeyReleased(static_cast<unsigned char>(keyCode));
+	}
+
+	printf("\n== %s ==\n", GetNameForGameMode(mode));
+	printf("%-10s %8s %8s %8s %8s %8s  (ms)\n", "", "Min", "Avg", "P50", "P99", "Max");
+	HeadlessTimeStats frameStats = GetTimeStats(frameMilliseconds);
+	HeadlessTimeStats updateStats = GetTimeStats(updateMilliseconds);
+	printf("%-10s %8.3f %8.3f %8.3f %8.3f %8.3f\n", "Frame", frameStats.m_min, frameStats.m_avg, frameStats.m_p50, frameStats.m_p99, frameStats.m_max);
+	printf("%-10s %8.3f %8.3f %8.3f %8.3f %8.3f\n", "Update", updateStats.m_min, updateStats.m_avg, updateStats.m_p50, updateStats.m_p99, updateStats.m_max);
+	if (m_config.m_isRenderEnabled)
+	{
+		HeadlessTimeStats renderStats = GetTimeStats(renderMilliseconds);
+		printf("%-10s %8.3f %8.3f %8.3f %8.3f %8.3f\n", "Render", renderStats.m_min, renderStats.m_avg, renderStats.m_p50, renderStats.m_p99, renderStats.m_max);
+		double framesDouble = static_cast<double>(numFrames);
+		printf("Per frame: %.1f draw calls, %.1f state calls, %.0f vertices\n", totalDrawCalls / framesDouble, totalStateCalls / framesDouble, totalVertices / framesDouble);
+		printf("Draw queue per frame: %.1f submits, %.1f draw calls and %.1f state calls saved\n", totalQueueSubmits / framesDouble, totalQueueDrawCallsSaved / framesDouble, totalQueueStateCallsSaved / framesDouble);
+	}
+	printf("Frame arena peak: %.1f KB\n", static_cast<double>(peakArenaBytes) / 1024.0);
+	printf("%s", GetProfilerStatsReport().c_str());
+	if (m_config.m_isBenchmarking)
+	{
+		printf("\n%s", benchmarkReport.IsEmpty() ? "No benchmarks in this mode\n" : benchmarkReport.GetText().c_str());
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int RunHeadlessFromCommandLine(int argc, char** argv)
+{
+	HeadlessRunConfig config;
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		std::string arg = argv[argIndex];
+		bool hasValue = (argIndex + 1 < argc);
+		if (arg == "--mode" && hasValue)
+		{
+			std::string modeText = argv[++argIndex];
+			if (!ParseGameModes(modeText, config.m_modes))
+			{
+				printf("ERROR: unknown game mode \"%s\"\n", modeText.c_str());
+				return 1;
+			}
+		}
+		else if (arg == "--frames" && hasValue)
+		{
+			config.m_numFrames = std::max(1, atoi(argv[++argIndex]));
+		}
+		else if (arg == "--dt" && hasValue)
+		{
+			config.m_fixedDeltaSeconds = static_cast<float>(atof(argv[++argIndex]));
+		}
+		else if (arg == "--script" && hasValue)
+		{
+			config.m_inputScriptPath = argv[++argIndex];
+		}
+		else if (arg == "--benchmark")
+		{
+			config.m_isBenchmarking = true;
+		}
+		else if (arg == "--render")
+		{
+			config.m_isRenderEnabled = true;
+		}
+		else
+		{
+			printf("Usage: %s [--mode <index|name|all>]... [--frames N] [--dt seconds] [--render] [--benchmark] [--script path]\nModes:", argv[0]);
+			for (int modeIndex = 0; modeIndex < GAME_MODE_NUM; ++modeIndex)
+			{
+				printf(" %d=%s", modeIndex, GetNameForGameMode(static_cast<GameMode>(modeIndex)));
+			}
+			printf("\n");
+			return 1;
+		}
+	}
+	if (config.m_modes.empty())
+	{
+		ParseGameModes("all", config.m_modes);
+	}
+
+	HeadlessRunner runner(config);
+	return runner.Run();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+#include <string>
+
+//-----------------------------------------------------------------------------------------------
+class Game;
+class NullRenderer;
+
+
+//-----------------------------------------------------------------------------------------------
+// Key presses and releases played back by frame index, one event per line:
+//	<frame> <press|release|tap> <key>		e.g. "30 tap F8" re-randomizes on frame 30
+// Keys are letters, digits, F1-F11, SPACE, ESCAPE, ENTER, SHIFT, UP, DOWN, LEFT, RIGHT,
+// LEFT_MOUSE and RIGHT_MOUSE. A tap releases on the next frame. '#' starts a comment.
+struct ScriptedKeyEvent
+{
+	int m_frameIndex = 0;
+	unsigned char m_keyCode = 0;
+	bool m_isPressed = true;
+};
+
+class ScriptedInput
+{
+public:
+	bool LoadFromFile(std::string const& filePath);
+	void ApplyEventsForFrame(int frameIndex) const;
+
+private:
+	std::vector<ScriptedKeyEvent> m_events; // sorted by frame
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct HeadlessRunConfig
+{
+	std::vector<GameMode> m_modes;
+	int m_numFrames = 300;
+	float m_fixedDeltaSeconds = 1.f / 60.f;
+	bool m_isRenderEnabled = false; // also run Render() into a NullRenderer, which builds every vertex
+	bool m_isBenchmarking = false; // also run each mode's RunBenchmarks() after its frames
+	std::string m_inputScriptPath;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs game modes with no window or GPU and prints per-frame time stats to stdout (Windows console build)
+// Clock::AdvanceSystemClock steps the system clock by the fixed dt every frame, so runs replay the
+// same simulation regardless of how long each frame took
+class HeadlessRunner
+{
+public:
+	explicit HeadlessRunner(HeadlessRunConfig const& config);
+	~HeadlessRunner();
+
+	int Run();
+
+private:
+	void Startup();
+	void Shutdown();
+	void RunMode(GameMode mode);
+
+private:
+	HeadlessRunConfig m_config;
+	ScriptedInput m_scriptedInput;
+	NullRenderer* m_nullRenderer = nullptr;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// --mode <index|name|all> (repeatable), --frames N, --dt seconds, --render, --benchmark, --script path
+int RunHeadlessFromCommandLine(int argc, char** argv);
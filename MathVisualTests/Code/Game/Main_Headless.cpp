@@ -0,0 +1,12 @@
+#include "Game/HeadlessRunner.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Entry point for headless builds (no window, no GPU), e.g. benchmarking every mode on a build machine:
+//	MathVisualTestsHeadless --mode all --frames 600 --render --benchmark
+// Built by GameHeadless.vcxproj, which leaves out App.cpp and Main_Windows.cpp and with them DX11.
+// Windows only: it links the same Engine project as the game, and there is no other build.
+int main(int argc, char** argv)
+{
+	return RunHeadlessFromCommandLine(argc, argv);
+}
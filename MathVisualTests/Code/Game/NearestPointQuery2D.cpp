@@ -0,0 +1,388 @@
+#include "Game/NearestPointQuery2D.hpp"
+#include "Game/FloatLanes.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+//-----------------------------------------------------------------------------------------------
+static int GetPaddedSize(int numPoints)
+{
+	return ((numPoints + FLOAT_LANE_COUNT - 1) / FLOAT_LANE_COUNT) * FLOAT_LANE_COUNT;
+}
+
+static float GetSafeInverseLengthSquared(float x, float y)
+{
+	// Degenerate segments collapse onto their start point
+	float lengthSquared = x * x + y * y;
+	return (lengthSquared > 0.f) ? 1.f / lengthSquared : 0.f;
+}
+
+// Writes one block of results, the distance is measured from the reference point to the nearest point
+static void StoreResultLanes(NearestPointResults2D& out_results, int resultIndex, FloatLanes pointX, FloatLanes pointY, FloatLanes nearestX, FloatLanes nearestY, FloatLanes isInside)
+{
+	FloatLanes dispX = LanesSub(pointX, nearestX);
+	FloatLanes dispY = LanesSub(pointY, nearestY);
+	FloatLanes distance = LanesSqrt(LanesAdd(LanesMul(dispX, dispX), LanesMul(dispY, dispY)));
+
+	LanesStoreUnaligned(&out_results.m_nearestX[resultIndex], nearestX);
+	LanesStoreUnaligned(&out_results.m_nearestY[resultIndex], nearestY);
+	LanesStoreUnaligned(&out_results.m_distance[resultIndex], distance);
+	LanesStoreUnaligned(&out_results.m_isInside[resultIndex], LanesAnd(isInside, LanesSet(1.f)));
+}
+
+// t is clamped to [0,1] for segments and left free for infinite lines
+static void GetNearestPointOnLineLanes(FloatLanes pointX, FloatLanes pointY, float startX, float startY, float dispX, float dispY, float inverseLengthSquared, bool isClamped,
+	FloatLanes& out_nearestX, FloatLanes& out_nearestY)
+{
+	FloatLanes fromStartX = LanesSub(pointX, LanesSet(startX));
+	FloatLanes fromStartY = LanesSub(pointY, LanesSet(startY));
+	FloatLanes t = LanesMul(LanesAdd(LanesMul(fromStartX, LanesSet(dispX)), LanesMul(fromStartY, LanesSet(dispY))), LanesSet(inverseLengthSquared));
+	if (isClamped)
+	{
+		t = LanesMin(LanesMax(t, LanesSet(0.f)), LanesSet(1.f));
+	}
+	out_nearestX = LanesAdd(LanesSet(startX), LanesMul(t, LanesSet(dispX)));
+	out_nearestY = LanesAdd(LanesSet(startY), LanesMul(t, LanesSet(dispY)));
+}
+
+static FloatLanes GetDistanceSquaredLanes(FloatLanes ax, FloatLanes ay, FloatLanes bx, FloatLanes by)
+{
+	FloatLanes dx = LanesSub(ax, bx);
+	FloatLanes dy = LanesSub(ay, by);
+	return LanesAdd(LanesMul(dx, dx), LanesMul(dy, dy));
+}
+
+// Positive when the point is on the left of the edge, inside for a counter clockwise triangle
+static FloatLanes GetEdgeCrossLanes(FloatLanes pointX, FloatLanes pointY, float startX, float startY, float endX, float endY)
+{
+	FloatLanes fromStartX = LanesSub(pointX, LanesSet(startX));
+	FloatLanes fromStartY = LanesSub(pointY, LanesSet(startY));
+	return LanesSub(LanesMul(LanesSet(endX - startX), fromStartY), LanesMul(LanesSet(endY - startY), fromStartX));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Vec2 NearestPointResults2D::GetNearestPoint(int shapeIndex, int pointIndex) const
+{
+	int resultIndex = shapeIndex * m_pointStride + pointIndex;
+	return Vec2(m_nearestX[resultIndex], m_nearestY[resultIndex]);
+}
+
+float NearestPointResults2D::GetDistance(int shapeIndex, int pointIndex) const
+{
+	return m_distance[shapeIndex * m_pointStride + pointIndex];
+}
+
+bool NearestPointResults2D::IsPointInside(int shapeIndex, int pointIndex) const
+{
+	return m_isInside[shapeIndex * m_pointStride + pointIndex] != 0.f;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NearestPointQuery2D::Clear()
+{
+	m_discs = Discs();
+	m_triangles = Triangles();
+	m_boxes = Boxes();
+	m_orientedBoxes = OrientedBoxes();
+	m_capsules = Capsules();
+	m_lineSegments = Segments();
+	m_infiniteLines = InfiniteLines();
+	m_numShapes = 0;
+}
+
+int NearestPointQuery2D::AddDisc(Vec2 const& center, float radius)
+{
+	m_discs.m_centerX.push_back(center.x);
+	m_discs.m_centerY.push_back(center.y);
+	m_discs.m_radius.push_back(radius);
+	m_discs.m_shapeIndex.push_back(m_numShapes);
+	return m_numShapes++;
+}
+
+int NearestPointQuery2D::AddTriangle(Triangle2 const& triangle)
+{
+	m_triangles.m_aX.push_back(triangle.m_pointsCounterClockwise[0].x);
+	m_triangles.m_aY.push_back(triangle.m_pointsCounterClockwise[0].y);
+	m_triangles.m_bX.push_back(triangle.m_pointsCounterClockwise[1].x);
+	m_triangles.m_bY.push_back(triangle.m_pointsCounterClockwise[1].y);
+	m_triangles.m_cX.push_back(triangle.m_pointsCounterClockwise[2].x);
+	m_triangles.m_cY.push_back(triangle.m_pointsCounterClockwise[2].y);
+	m_triangles.m_shapeIndex.push_back(m_numShapes);
+	return m_numShapes++;
+}
+
+int NearestPointQuery2D::AddAABB2(AABB2 const& box)
+{
+	m_boxes.m_minX.push_back(box.m_mins.x);
+	m_boxes.m_minY.push_back(box.m_mins.y);
+	m_boxes.m_maxX.push_back(box.m_maxs.x);
+	m_boxes.m_maxY.push_back(box.m_maxs.y);
+	m_boxes.m_shapeIndex.push_back(m_numShapes);
+	return m_numShapes++;
+}
+
+int NearestPointQuery2D::AddOBB2(OBB2 const& box)
+{
+	m_orientedBoxes.m_centerX.push_back(box.m_center.x);
+	m_orientedBoxes.m_centerY.push_back(box.m_center.y);
+	m_orientedBoxes.m_iBasisX.push_back(box.m_iBasisNormal.x);
+	m_orientedBoxes.m_iBasisY.push_back(box.m_iBasisNormal.y);
+	m_orientedBoxes.m_halfX.push_back(box.m_halfDimensions.x);
+	m_orientedBoxes.m_halfY.push_back(box.m_halfDimensions.y);
+	m_orientedBoxes.m_shapeIndex.push_back(m_numShapes);
+	return m_numShapes++;
+}
+
+int NearestPointQuery2D::AddCapsule2(Capsule2 const& capsule)
+{
+	m_capsules.m_startX.push_back(capsule.m_bone.m_start.x);
+	m_capsules.m_startY.push_back(capsule.m_bone.m_start.y);
+	m_capsules.m_endX.push_back(capsule.m_bone.m_end.x);
+	m_capsules.m_endY.push_back(capsule.m_bone.m_end.y);
+	m_capsules.m_radius.push_back(capsule.m_radius);
+	m_capsules.m_shapeIndex.push_back(m_numShapes);
+	return m_numShapes++;
+}
+
+int NearestPointQuery2D::AddLineSegment2(LineSegment2 const& lineSegment)
+{
+	m_lineSegments.m_startX.push_back(lineSegment.m_start.x);
+	m_lineSegments.m_startY.push_back(lineSegment.m_start.y);
+	m_lineSegments.m_endX.push_back(lineSegment.m_end.x);
+	m_lineSegments.m_endY.push_back(lineSegment.m_end.y);
+	m_lineSegments.m_shapeIndex.push_back(m_numShapes);
+	return m_numShapes++;
+}
+
+int NearestPointQuery2D::AddInfiniteLine2(LineSegment2 const& lineThroughPoints)
+{
+	Vec2 direction = (lineThroughPoints.m_end - lineThroughPoints.m_start).GetNormalized();
+	m_infiniteLines.m_pointX.push_back(lineThroughPoints.m_start.x);
+	m_infiniteLines.m_pointY.push_back(lineThroughPoints.m_start.y);
+	m_infiniteLines.m_directionX.push_back(direction.x);
+	m_infiniteLines.m_directionY.push_back(direction.y);
+	m_infiniteLines.m_shapeIndex.push_back(m_numShapes);
+	return m_numShapes++;
+}
+
+//-----------------------------------------------------------------------------------------------
+void NearestPointQuery2D::Query(int numPoints, Vec2 const* referencePoints, NearestPointResults2D& out_results) const
+{
+	int pointStride = GetPaddedSize(numPoints);
+	int numResults = m_numShapes * pointStride;
+	out_results.m_numShapes = m_numShapes;
+	out_results.m_numPoints = numPoints;
+	out_results.m_pointStride = pointStride;
+	out_results.m_referenceX.resize(pointStride);
+	out_results.m_referenceY.resize(pointStride);
+	out_results.m_nearestX.resize(numResults);
+	out_results.m_nearestY.resize(numResults);
+	out_results.m_distance.resize(numResults);
+	out_results.m_isInside.resize(numResults);
+
+	// Padding lanes repeat the last point, their results are never read
+	for (int pointIndex = 0; pointIndex < pointStride; ++pointIndex)
+	{
+		Vec2 const& point = referencePoints[(pointIndex < numPoints) ? pointIndex : numPoints - 1];
+		out_results.m_referenceX[pointIndex] = point.x;
+		out_results.m_referenceY[pointIndex] = point.y;
+	}
+	float const* pointsX = out_results.m_referenceX.data();
+	float const* pointsY = out_results.m_referenceY.data();
+
+	// Discs
+	for (int discIndex = 0; discIndex < (int)m_discs.m_shapeIndex.size(); ++discIndex)
+	{
+		FloatLanes centerX = LanesSet(m_discs.m_centerX[discIndex]);
+		FloatLanes centerY = LanesSet(m_discs.m_centerY[discIndex]);
+		float radius = m_discs.m_radius[discIndex];
+		int rowIndex = m_discs.m_shapeIndex[discIndex] * pointStride;
+		for (int pointIndex = 0; pointIndex < pointStride; pointIndex += FLOAT_LANE_COUNT)
+		{
+			FloatLanes pointX = LanesLoadUnaligned(pointsX + pointIndex);
+			FloatLanes pointY = LanesLoadUnaligned(pointsY + pointIndex);
+			FloatLanes fromCenterX = LanesSub(pointX, centerX);
+			FloatLanes fromCenterY = LanesSub(pointY, centerY);
+			FloatLanes distanceSquared = LanesAdd(LanesMul(fromCenterX, fromCenterX), LanesMul(fromCenterY, fromCenterY));
+			FloatLanes isInside = LanesLess(distanceSquared, LanesSet(radius * radius));
+
+			// A zero radius disc has no inside, so a point on the center reaches the division by zero:
+			// leave it on the center, like the scalar GetNormalized of a zero vector does
+			FloatLanes isOffCenter = LanesGreater(distanceSquared, LanesSet(0.f));
+			FloatLanes scale = LanesSelect(isOffCenter, LanesDiv(LanesSet(radius), LanesSqrt(distanceSquared)), LanesSet(0.f));
+			FloatLanes nearestX = LanesSelect(isInside, pointX, LanesAdd(centerX, LanesMul(fromCenterX, scale)));
+			FloatLanes nearestY = LanesSelect(isInside, pointY, LanesAdd(centerY, LanesMul(fromCenterY, scale)));
+			StoreResultLanes(out_results, rowIndex + pointIndex, pointX, pointY, nearestX, nearestY, isInside);
+		}
+	}
+
+	// Triangles, outside points take the closest of the three edges
+	for (int triangleIndex = 0; triangleIndex < (int)m_triangles.m_shapeIndex.size(); ++triangleIndex)
+	{
+		float aX = m_triangles.m_aX[triangleIndex];
+		float aY = m_triangles.m_aY[triangleIndex];
+		float bX = m_triangles.m_bX[triangleIndex];
+		float bY = m_triangles.m_bY[triangleIndex];
+		float cX = m_triangles.m_cX[triangleIndex];
+		float cY = m_triangles.m_cY[triangleIndex];
+		float inverseABSquared = GetSafeInverseLengthSquared(bX - aX, bY - aY);
+		float inverseBCSquared = GetSafeInverseLengthSquared(cX - bX, cY - bY);
+		float inverseCASquared = GetSafeInverseLengthSquared(aX - cX, aY - cY);
+		int rowIndex = m_triangles.m_shapeIndex[triangleIndex] * pointStride;
+		for (int pointIndex = 0; pointIndex < pointStride; pointIndex += FLOAT_LANE_COUNT)
+		{
+			FloatLanes pointX = LanesLoadUnaligned(pointsX + pointIndex);
+			FloatLanes pointY = LanesLoadUnaligned(pointsY + pointIndex);
+			FloatLanes zero = LanesSet(0.f);
+			FloatLanes isInside = LanesAnd(LanesAnd(
+				LanesGreater(GetEdgeCrossLanes(pointX, pointY, aX, aY, bX, bY), zero),
+				LanesGreater(GetEdgeCrossLanes(pointX, pointY, bX, bY, cX, cY), zero)),
+				LanesGreater(GetEdgeCrossLanes(pointX, pointY, cX, cY, aX, aY), zero));
+
+			FloatLanes nearestX, nearestY, edgeX, edgeY;
+			GetNearestPointOnLineLanes(pointX, pointY, aX, aY, bX - aX, bY - aY, inverseABSquared, true, nearestX, nearestY);
+			FloatLanes nearestDistanceSquared = GetDistanceSquaredLanes(pointX, pointY, nearestX, nearestY);
+
+			GetNearestPointOnLineLanes(pointX, pointY, bX, bY, cX - bX, cY - bY, inverseBCSquared, true, edgeX, edgeY);
+			FloatLanes edgeDistanceSquared = GetDistanceSquaredLanes(pointX, pointY, edgeX, edgeY);
+			FloatLanes isCloser = LanesLess(edgeDistanceSquared, nearestDistanceSquared);
+			nearestX = LanesSelect(isCloser, edgeX, nearestX);
+			nearestY = LanesSelect(isCloser, edgeY, nearestY);
+			nearestDistanceSquared = LanesMin(edgeDistanceSquared, nearestDistanceSquared);
+
+			GetNearestPointOnLineLanes(pointX, pointY, cX, cY, aX - cX, aY - cY, inverseCASquared, true, edgeX, edgeY);
+			edgeDistanceSquared = GetDistanceSquaredLanes(pointX, pointY, edgeX, edgeY);
+			isCloser = LanesLess(edgeDistanceSquared, nearestDistanceSquared);
+			nearestX = LanesSelect(isCloser, edgeX, nearestX);
+			nearestY = LanesSelect(isCloser, edgeY, nearestY);
+
+			nearestX = LanesSelect(isInside, pointX, nearestX);
+			nearestY = LanesSelect(isInside, pointY, nearestY);
+			StoreResultLanes(out_results, rowIndex + pointIndex, pointX, pointY, nearestX, nearestY, isInside);
+		}
+	}
+
+	// AABB2s
+	for (int boxIndex = 0; boxIndex < (int)m_boxes.m_shapeIndex.size(); ++boxIndex)
+	{
+		FloatLanes minX = LanesSet(m_boxes.m_minX[boxIndex]);
+		FloatLanes minY = LanesSet(m_boxes.m_minY[boxIndex]);
+		FloatLanes maxX = LanesSet(m_boxes.m_maxX[boxIndex]);
+		FloatLanes maxY = LanesSet(m_boxes.m_maxY[boxIndex]);
+		int rowIndex = m_boxes.m_shapeIndex[boxIndex] * pointStride;
+		for (int pointIndex = 0; pointIndex < pointStride; pointIndex += FLOAT_LANE_COUNT)
+		{
+			FloatLanes pointX = LanesLoadUnaligned(pointsX + pointIndex);
+			FloatLanes pointY = LanesLoadUnaligned(pointsY + pointIndex);
+			FloatLanes isInside = LanesAnd(LanesAnd(LanesLess(minX, pointX), LanesLess(pointX, maxX)),
+				LanesAnd(LanesLess(minY, pointY), LanesLess(pointY, maxY)));
+
+			// Clamping leaves inside points where they are
+			FloatLanes nearestX = LanesMin(LanesMax(pointX, minX), maxX);
+			FloatLanes nearestY = LanesMin(LanesMax(pointY, minY), maxY);
+			StoreResultLanes(out_results, rowIndex + pointIndex, pointX, pointY, nearestX, nearestY, isInside);
+		}
+	}
+
+	// OBB2s, clamped in local space
+	for (int boxIndex = 0; boxIndex < (int)m_orientedBoxes.m_shapeIndex.size(); ++boxIndex)
+	{
+		FloatLanes centerX = LanesSet(m_orientedBoxes.m_centerX[boxIndex]);
+		FloatLanes centerY = LanesSet(m_orientedBoxes.m_centerY[boxIndex]);
+		FloatLanes iBasisX = LanesSet(m_orientedBoxes.m_iBasisX[boxIndex]);
+		FloatLanes iBasisY = LanesSet(m_orientedBoxes.m_iBasisY[boxIndex]);
+		FloatLanes jBasisX = LanesNegate(iBasisY);
+		FloatLanes jBasisY = iBasisX;
+		FloatLanes halfX = LanesSet(m_orientedBoxes.m_halfX[boxIndex]);
+		FloatLanes halfY = LanesSet(m_orientedBoxes.m_halfY[boxIndex]);
+		FloatLanes negativeHalfX = LanesNegate(halfX);
+		FloatLanes negativeHalfY = LanesNegate(halfY);
+		int rowIndex = m_orientedBoxes.m_shapeIndex[boxIndex] * pointStride;
+		for (int pointIndex = 0; pointIndex < pointStride; pointIndex += FLOAT_LANE_COUNT)
+		{
+			FloatLanes pointX = LanesLoadUnaligned(pointsX + pointIndex);
+			FloatLanes pointY = LanesLoadUnaligned(pointsY + pointIndex);
+			FloatLanes fromCenterX = LanesSub(pointX, centerX);
+			FloatLanes fromCenterY = LanesSub(pointY, centerY);
+			FloatLanes localX = LanesAdd(LanesMul(fromCenterX, iBasisX), LanesMul(fromCenterY, iBasisY));
+			FloatLanes localY = LanesAdd(LanesMul(fromCenterX, jBasisX), LanesMul(fromCenterY, jBasisY));
+			FloatLanes isInside = LanesAnd(LanesAnd(LanesLess(negativeHalfX, localX), LanesLess(localX, halfX)),
+				LanesAnd(LanesLess(negativeHalfY, localY), LanesLess(localY, halfY)));
+
+			FloatLanes clampedX = LanesMin(LanesMax(localX, negativeHalfX), halfX);
+			FloatLanes clampedY = LanesMin(LanesMax(localY, negativeHalfY), halfY);
+			FloatLanes nearestX = LanesAdd(centerX, LanesAdd(LanesMul(iBasisX, clampedX), LanesMul(jBasisX, clampedY)));
+			FloatLanes nearestY = LanesAdd(centerY, LanesAdd(LanesMul(iBasisY, clampedX), LanesMul(jBasisY, clampedY)));
+			nearestX = LanesSelect(isInside, pointX, nearestX);
+			nearestY = LanesSelect(isInside, pointY, nearestY);
+			StoreResultLanes(out_results, rowIndex + pointIndex, pointX, pointY, nearestX, nearestY, isInside);
+		}
+	}
+
+	// Capsules, pushed out from the nearest point on the bone
+	for (int capsuleIndex = 0; capsuleIndex < (int)m_capsules.m_shapeIndex.size(); ++capsuleIndex)
+	{
+		float startX = m_capsules.m_startX[capsuleIndex];
+		float startY = m_capsules.m_startY[capsuleIndex];
+		float boneX = m_capsules.m_endX[capsuleIndex] - startX;
+		float boneY = m_capsules.m_endY[capsuleIndex] - startY;
+		float inverseBoneSquared = GetSafeInverseLengthSquared(boneX, boneY);
+		float radius = m_capsules.m_radius[capsuleIndex];
+		int rowIndex = m_capsules.m_shapeIndex[capsuleIndex] * pointStride;
+		for (int pointIndex = 0; pointIndex < pointStride; pointIndex += FLOAT_LANE_COUNT)
+		{
+			FloatLanes pointX = LanesLoadUnaligned(pointsX + pointIndex);
+			FloatLanes pointY = LanesLoadUnaligned(pointsY + pointIndex);
+			FloatLanes boneNearestX, boneNearestY;
+			GetNearestPointOnLineLanes(pointX, pointY, startX, startY, boneX, boneY, inverseBoneSquared, true, boneNearestX, boneNearestY);
+			FloatLanes fromBoneX = LanesSub(pointX, boneNearestX);
+			FloatLanes fromBoneY = LanesSub(pointY, boneNearestY);
+			FloatLanes distanceSquared = LanesAdd(LanesMul(fromBoneX, fromBoneX), LanesMul(fromBoneY, fromBoneY));
+			FloatLanes isInside = LanesLess(distanceSquared, LanesSet(radius * radius));
+
+			// Same guard as the discs, for a zero radius capsule and a point on its bone
+			FloatLanes isOffBone = LanesGreater(distanceSquared, LanesSet(0.f));
+			FloatLanes scale = LanesSelect(isOffBone, LanesDiv(LanesSet(radius), LanesSqrt(distanceSquared)), LanesSet(0.f));
+			FloatLanes nearestX = LanesSelect(isInside, pointX, LanesAdd(boneNearestX, LanesMul(fromBoneX, scale)));
+			FloatLanes nearestY = LanesSelect(isInside, pointY, LanesAdd(boneNearestY, LanesMul(fromBoneY, scale)));
+			StoreResultLanes(out_results, rowIndex + pointIndex, pointX, pointY, nearestX, nearestY, isInside);
+		}
+	}
+
+	// Line segments and infinite lines have no inside
+	FloatLanes isNeverInside = LanesSet(0.f);
+	for (int segmentIndex = 0; segmentIndex < (int)m_lineSegments.m_shapeIndex.size(); ++segmentIndex)
+	{
+		float startX = m_lineSegments.m_startX[segmentIndex];
+		float startY = m_lineSegments.m_startY[segmentIndex];
+		float dispX = m_lineSegments.m_endX[segmentIndex] - startX;
+		float dispY = m_lineSegments.m_endY[segmentIndex] - startY;
+		float inverseLengthSquared = GetSafeInverseLengthSquared(dispX, dispY);
+		int rowIndex = m_lineSegments.m_shapeIndex[segmentIndex] * pointStride;
+		for (int pointIndex = 0; pointIndex < pointStride; pointIndex += FLOAT_LANE_COUNT)
+		{
+			FloatLanes pointX = LanesLoadUnaligned(pointsX + pointIndex);
+			FloatLanes pointY = LanesLoadUnaligned(pointsY + pointIndex);
+			FloatLanes nearestX, nearestY;
+			GetNearestPointOnLineLanes(pointX, pointY, startX, startY, dispX, dispY, inverseLengthSquared, true, nearestX, nearestY);
+			StoreResultLanes(out_results, rowIndex + pointIndex, pointX, pointY, nearestX, nearestY, isNeverInside);
+		}
+	}
+
+	for (int lineIndex = 0; lineIndex < (int)m_infiniteLines.m_shapeIndex.size(); ++lineIndex)
+	{
+		float pointOnLineX = m_infiniteLines.m_pointX[lineIndex];
+		float pointOnLineY = m_infiniteLines.m_pointY[lineIndex];
+		float directionX = m_infiniteLines.m_directionX[lineIndex];
+		float directionY = m_infiniteLines.m_directionY[lineIndex];
+		int rowIndex = m_infiniteLines.m_shapeIndex[lineIndex] * pointStride;
+		for (int pointIndex = 0; pointIndex < pointStride; pointIndex += FLOAT_LANE_COUNT)
+		{
+			FloatLanes pointX = LanesLoadUnaligned(pointsX + pointIndex);
+			FloatLanes pointY = LanesLoadUnaligned(pointsY + pointIndex);
+			FloatLanes nearestX, nearestY;
+			GetNearestPointOnLineLanes(pointX, pointY, pointOnLineX, pointOnLineY, directionX, directionY, 1.f, false, nearestX, nearestY);
+			StoreResultLanes(out_results, rowIndex + pointIndex, pointX, pointY, nearestX, nearestY, isNeverInside);
+		}
+	}
+}
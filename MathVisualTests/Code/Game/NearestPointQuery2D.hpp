@@ -0,0 +1,101 @@
+#pragma once
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Capsule2.hpp"
+#include "Engine/Math/LineSegment2.hpp"
+#include "Engine/Math/OBB2.hpp"
+#include "Engine/Math/Triangle2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Output of NearestPointQuery2D::Query, one row of results per shape
+// Arrays are indexed [shapeIndex * m_pointStride + pointIndex], rows are padded to the SIMD lane count
+struct NearestPointResults2D
+{
+	int m_numShapes = 0;
+	int m_numPoints = 0;
+	int m_pointStride = 0;
+
+	std::vector<float> m_referenceX; // padded copy of the query points
+	std::vector<float> m_referenceY;
+	std::vector<float> m_nearestX;
+	std::vector<float> m_nearestY;
+	std::vector<float> m_distance; // 0 when the point is inside
+	std::vector<float> m_isInside; // 1 or 0
+
+	Vec2 GetNearestPoint(int shapeIndex, int pointIndex) const;
+	float GetDistance(int shapeIndex, int pointIndex) const;
+	bool IsPointInside(int shapeIndex, int pointIndex) const;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Nearest point, distance and inside flag for a batch of reference points against every shape
+// Shapes are stored as one structure of arrays per type. Each shape is broadcast across the
+// SIMD lanes and tested against a block of reference points at a time.
+// Same conventions as the scalar GetNearestPointOn*2D and IsPointInside*2D functions; the
+// nearest point of a point inside a solid shape is the point itself.
+class NearestPointQuery2D
+{
+public:
+	void Clear();
+
+	// Each returns the shape index used in the results, shapes are numbered in insertion order
+	int AddDisc(Vec2 const& center, float radius);
+	int AddTriangle(Triangle2 const& triangle);
+	int AddAABB2(AABB2 const& box);
+	int AddOBB2(OBB2 const& box);
+	int AddCapsule2(Capsule2 const& capsule);
+	int AddLineSegment2(LineSegment2 const& lineSegment);
+	int AddInfiniteLine2(LineSegment2 const& lineThroughPoints);
+
+	int GetNumShapes() const { return m_numShapes; }
+
+	// out_results keeps its capacity between calls, reuse it every frame
+	void Query(int numPoints, Vec2 const* referencePoints, NearestPointResults2D& out_results) const;
+
+private:
+	struct Discs
+	{
+		std::vector<float> m_centerX, m_centerY, m_radius;
+		std::vector<int> m_shapeIndex;
+	} m_discs;
+
+	struct Triangles
+	{
+		std::vector<float> m_aX, m_aY, m_bX, m_bY, m_cX, m_cY; // counter clockwise
+		std::vector<int> m_shapeIndex;
+	} m_triangles;
+
+	struct Boxes
+	{
+		std::vector<float> m_minX, m_minY, m_maxX, m_maxY;
+		std::vector<int> m_shapeIndex;
+	} m_boxes;
+
+	struct OrientedBoxes
+	{
+		std::vector<float> m_centerX, m_centerY, m_iBasisX, m_iBasisY, m_halfX, m_halfY;
+		std::vector<int> m_shapeIndex;
+	} m_orientedBoxes;
+
+	struct Capsules
+	{
+		std::vector<float> m_startX, m_startY, m_endX, m_endY, m_radius;
+		std::vector<int> m_shapeIndex;
+	} m_capsules;
+
+	struct Segments
+	{
+		std::vector<float> m_startX, m_startY, m_endX, m_endY;
+		std::vector<int> m_shapeIndex;
+	} m_lineSegments;
+
+	struct InfiniteLines
+	{
+		std::vector<float> m_pointX, m_pointY, m_directionX, m_directionY; // normalized direction
+		std::vector<int> m_shapeIndex;
+	} m_infiniteLines;
+
+	int m_numShapes = 0;
+};
@@ -0,0 +1,148 @@
+#include "Game/NullRenderer.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+NullRenderer::NullRenderer(RendererConfig const& config)
+	: Renderer(config)
+{
+}
+
+NullRenderer::~NullRenderer()
+{
+}
+
+void NullRenderer::Startup()
+{
+}
+
+void NullRenderer::Shutdown()
+{
+}
+
+void NullRenderer::BeginFrame()
+{
+	m_frameStats = NullRendererFrameStats();
+}
+
+void NullRenderer::EndFrame()
+{
+}
+
+void NullRenderer::ClearScreen(Rgba8 const& clearColor)
+{
+	UNUSED(clearColor);
+}
+
+void NullRenderer::BeginCamera(Camera const& camera)
+{
+	UNUSED(camera);
+}
+
+void NullRenderer::EndCamera(Camera const& camera)
+{
+	UNUSED(camera);
+}
+
+void NullRenderer::DrawVertexArray(std::vector<Vertex_PCU> const& verts)
+{
+	DrawVertexArray(static_cast<int>(verts.size()), verts.data());
+}
+
+void NullRenderer::DrawVertexArray(int numVertexes, Vertex_PCU const* vertexes)
+{
+	UNUSED(vertexes);
+	m_frameStats.m_numDrawCalls++;
+	m_frameStats.m_numVertices += numVertexes;
+}
+
+void NullRenderer::BindTexture(Texture const* texture)
+{
+	UNUSED(texture);
+	m_frameStats.m_numStateCalls++;
+}
+
+void NullRenderer::BindShader(Shader* shader)
+{
+	UNUSED(shader);
+	m_frameStats.m_numStateCalls++;
+}
+
+void NullRenderer::SetBlendMode(BlendMode blendMode)
+{
+	UNUSED(blendMode);
+	m_frameStats.m_numStateCalls++;
+}
+
+void NullRenderer::SetSamplerMode(SamplerMode samplerMode)
+{
+	UNUSED(samplerMode);
+	m_frameStats.m_numStateCalls++;
+}
+
+void NullRenderer::SetRasterizerMode(RasterizerMode rasterizerMode)
+{
+	UNUSED(rasterizerMode);
+	m_frameStats.m_numStateCalls++;
+}
+
+void NullRenderer::SetDepthMode(DepthMode depthMode)
+{
+	UNUSED(depthMode);
+	m_frameStats.m_numStateCalls++;
+}
+
+void NullRenderer::SetModelConstants(Mat44 const& modelToWorldTransform, Rgba8 const& modelColor)
+{
+	UNUSED(modelToWorldTransform);
+	UNUSED(modelColor);
+	m_frameStats.m_numStateCalls++;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Shader* NullRenderer::CreateOrGetShader(char const* shaderName)
+{
+	UNUSED(shaderName);
+	return nullptr;
+}
+
+VertexBuffer* NullRenderer::CreateVertexBuffer(unsigned int size, unsigned int stride)
+{
+	UNUSED(size);
+	UNUSED(stride);
+	return nullptr;
+}
+
+IndexBuffer* NullRenderer::CreateIndexBuffer(unsigned int size)
+{
+	UNUSED(size);
+	return nullptr;
+}
+
+ConstantBuffer* NullRenderer::CreateConstantBuffer(unsigned int size)
+{
+	UNUSED(size);
+	return nullptr;
+}
+
+void NullRenderer::CopyCPUToGPU(void const* data, unsigned int size, VertexBuffer* vbo)
+{
+	UNUSED(data);
+	UNUSED(size);
+	UNUSED(vbo);
+}
+
+void NullRenderer::CopyCPUToGPU(void const* data, unsigned int size, IndexBuffer* ibo)
+{
+	UNUSED(data);
+	UNUSED(size);
+	UNUSED(ibo);
+}
+
+void NullRenderer::CopyCPUToGPU(void const* data, unsigned int size, ConstantBuffer* cbo)
+{
+	UNUSED(data);
+	UNUSED(size);
+	UNUSED(cbo);
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "Engine/Renderer/Renderer.hpp"
+
+//-----------------------------------------------------------------------------------------------
+struct NullRendererFrameStats
+{
+	int m_numDrawCalls = 0;
+	int m_numVertices = 0;
+	int m_numStateCalls = 0; // shader, texture, blend, sampler, rasterizer, depth and model constant calls
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Renderer with no device for headless runs: draws and state changes are only counted, so a game's
+// Render() still builds all of its vertices.
+//
+// Nothing is created on a GPU: shaders and buffers come back nullptr, which the binds and draws above
+// accept. Textures and fonts still go through Renderer's own CreateOrGet functions, so run from the
+// Run folder where Data/ is, and glyph layout works on the real font metrics.
+class NullRenderer : public Renderer
+{
+public:
+	explicit NullRenderer(RendererConfig const& config);
+	virtual ~NullRenderer();
+
+	virtual void Startup() override;
+	virtual void Shutdown() override;
+	virtual void BeginFrame() override;
+	virtual void EndFrame() override;
+
+	virtual void ClearScreen(Rgba8 const& clearColor) override;
+	virtual void BeginCamera(Camera const& camera) override;
+	virtual void EndCamera(Camera const& camera) override;
+	virtual void DrawVertexArray(std::vector<Vertex_PCU> const& verts) override;
+	virtual void DrawVertexArray(int numVertexes, Vertex_PCU const* vertexes) override;
+
+	virtual void BindTexture(Texture const* texture) override;
+	virtual void BindShader(Shader* shader) override;
+	virtual void SetBlendMode(BlendMode blendMode) override;
+	virtual void SetSamplerMode(SamplerMode samplerMode) override;
+	virtual void SetRasterizerMode(RasterizerMode rasterizerMode) override;
+	virtual void SetDepthMode(DepthMode depthMode) override;
+	virtual void SetModelConstants(Mat44 const& modelToWorldTransform = Mat44(), Rgba8 const& modelColor = Rgba8::OPAQUE_WHITE) override;
+
+	virtual Shader* CreateOrGetShader(char const* shaderName) override;
+	virtual VertexBuffer* CreateVertexBuffer(unsigned int size, unsigned int stride) override;
+	virtual IndexBuffer* CreateIndexBuffer(unsigned int size) override;
+	virtual ConstantBuffer* CreateConstantBuffer(unsigned int size) override;
+	virtual void CopyCPUToGPU(void const* data, unsigned int size, VertexBuffer* vbo) override;
+	virtual void CopyCPUToGPU(void const* data, unsigned int size, IndexBuffer* ibo) override;
+	virtual void CopyCPUToGPU(void const* data, unsigned int size, ConstantBuffer* cbo) override;
+
+	// Counts since the last BeginFrame
+	NullRendererFrameStats const& GetFrameStats() const { return m_frameStats; }
+
+private:
+	NullRendererFrameStats m_frameStats;
+};
@@ -0,0 +1,321 @@
+#include "Game/PrimitiveMeshes.hpp"
+#include "Game/FloatLanes.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <cmath>
+
+//-----------------------------------------------------------------------------------------------
+struct PrimitiveInstanceBasis
+{
+	Vec3 m_start;
+	Vec3 m_iBasis;
+	Vec3 m_jBasis;
+	Vec3 m_kBasis;
+	Vec3 m_length;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+int GetNumSlicesForPrimitiveMeshLOD(PrimitiveMeshLOD lod)
+{
+	switch (lod)
+	{
+	case PRIMITIVE_MESH_LOD_LOW:	return 8;
+	case PRIMITIVE_MESH_LOD_MEDIUM:	return 16;
+	case PRIMITIVE_MESH_LOD_HIGH:	return 32;
+	default:						return 16;
+	}
+}
+
+char const* GetNameForPrimitiveMeshType(PrimitiveMeshType type)
+{
+	switch (type)
+	{
+	case PRIMITIVE_MESH_DISC_2D:		return "Disc2D";
+	case PRIMITIVE_MESH_CAPSULE_2D:		return "Capsule2D";
+	case PRIMITIVE_MESH_SPHERE_3D:		return "Sphere3D";
+	case PRIMITIVE_MESH_CYLINDER_3D:	return "Cylinder3D";
+	case PRIMITIVE_MESH_ARROW_3D:		return "Arrow3D";
+	default:							return "Unknown";
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static void AddUnitVert(PrimitiveMesh& mesh, Vertex_PCU const& vert, float x, float y, float z, float w)
+{
+	mesh.m_verts.push_back(vert);
+	mesh.m_localX.push_back(x);
+	mesh.m_localY.push_back(y);
+	mesh.m_localZ.push_back(z);
+	mesh.m_localW.push_back(w);
+}
+
+// Verts tessellated along +Z with radius 1 and length 1: XY stays in radius units, Z becomes w
+static void AddUnitVertsAlongLength(PrimitiveMesh& mesh, std::vector<Vertex_PCU> const& verts)
+{
+	for (Vertex_PCU const& vert : verts)
+	{
+		AddUnitVert(mesh, vert, vert.m_position.x, vert.m_position.y, 0.f, vert.m_position.z);
+	}
+}
+
+static void AddUnitVertsForCapsule2D(PrimitiveMesh& mesh, int numSlices)
+{
+	// Half disc behind the start (w = 0) and in front of the end (w = 1), joined by a band along I
+	Vertex_PCU centerVert(Vec3(), Rgba8::OPAQUE_WHITE);
+	int numSlicesPerCap = numSlices / 2;
+	float degreesPerSlice = 360.f / static_cast<float>(numSlices);
+	for (int capIndex = 0; capIndex < 2; ++capIndex)
+	{
+		float capStartDegrees = (capIndex == 0) ? 90.f : -90.f;
+		float capW = (capIndex == 0) ? 0.f : 1.f;
+		for (int sliceIndex = 0; sliceIndex < numSlicesPerCap; ++sliceIndex)
+		{
+			Vec2 rimA = Vec2::MakeFromPolarDegrees(capStartDegrees + degreesPerSlice * static_cast<float>(sliceIndex));
+			Vec2 rimB = Vec2::MakeFromPolarDegrees(capStartDegrees + degreesPerSlice * static_cast<float>(sliceIndex + 1));
+			AddUnitVert(mesh, centerVert, 0.f, 0.f, 0.f, capW);
+			AddUnitVert(mesh, centerVert, rimA.x, rimA.y, 0.f, capW);
+			AddUnitVert(mesh, centerVert, rimB.x, rimB.y, 0.f, capW);
+		}
+	}
+
+	AddUnitVert(mesh, centerVert, 0.f, -1.f, 0.f, 0.f);
+	AddUnitVert(mesh, centerVert, 0.f, -1.f, 0.f, 1.f);
+	AddUnitVert(mesh, centerVert, 0.f, 1.f, 0.f, 1.f);
+	AddUnitVert(mesh, centerVert, 0.f, -1.f, 0.f, 0.f);
+	AddUnitVert(mesh, centerVert, 0.f, 1.f, 0.f, 1.f);
+	AddUnitVert(mesh, centerVert, 0.f, 1.f, 0.f, 0.f);
+}
+
+static void BuildUnitPrimitiveMesh(PrimitiveMesh& mesh, PrimitiveMeshType type, PrimitiveMeshLOD lod)
+{
+	int numSlices = GetNumSlicesForPrimitiveMeshLOD(lod);
+	std::vector<Vertex_PCU> verts;
+	switch (type)
+	{
+	case PRIMITIVE_MESH_DISC_2D:
+		mesh.m_isPlanar = true;
+		AddVertsForDisc2D(verts, Vec2(), 1.f, Rgba8::OPAQUE_WHITE, numSlices);
+		for (Vertex_PCU const& vert : verts)
+		{
+			AddUnitVert(mesh, vert, vert.m_position.x, vert.m_position.y, 0.f, 0.f);
+		}
+		break;
+	case PRIMITIVE_MESH_CAPSULE_2D:
+		mesh.m_isPlanar = true;
+		mesh.m_isUsingEnd = true;
+		AddUnitVertsForCapsule2D(mesh, numSlices);
+		break;
+	case PRIMITIVE_MESH_SPHERE_3D:
+		AddVertsForSphere3D(verts, Vec3(), 1.f, Rgba8::OPAQUE_WHITE, AABB2::ZERO_TO_ONE, numSlices, numSlices / 2);
+		for (Vertex_PCU const& vert : verts)
+		{
+			AddUnitVert(mesh, vert, vert.m_position.x, vert.m_position.y, vert.m_position.z, 0.f);
+		}
+		break;
+	case PRIMITIVE_MESH_CYLINDER_3D:
+		mesh.m_isUsingEnd = true;
+		AddVertsForCylinder3D(verts, Vec3(), Vec3(0.f, 0.f, 1.f), 1.f, Rgba8::OPAQUE_WHITE, AABB2::ZERO_TO_ONE, numSlices);
+		AddUnitVertsAlongLength(mesh, verts);
+		break;
+	case PRIMITIVE_MESH_ARROW_3D:
+	{
+		mesh.m_isUsingEnd = true;
+		Vec3 headBase(0.f, 0.f, 1.f - ARROW_HEAD_LENGTH_FRACTION);
+		AddVertsForCylinder3D(verts, Vec3(), headBase, 1.f, Rgba8::OPAQUE_WHITE, AABB2::ZERO_TO_ONE, numSlices);
+		AddVertsForCone3D(verts, headBase, Vec3(0.f, 0.f, 1.f), ARROW_HEAD_RADIUS_SCALE, Rgba8::OPAQUE_WHITE, AABB2::ZERO_TO_ONE, numSlices);
+		AddUnitVertsAlongLength(mesh, verts);
+		break;
+	}
+	default:
+		ERROR_AND_DIE("Unknown primitive mesh type");
+	}
+
+	mesh.m_numVerts = static_cast<int>(mesh.m_verts.size());
+	int numPaddedVerts = (mesh.m_numVerts + FLOAT_LANE_COUNT - 1) / FLOAT_LANE_COUNT * FLOAT_LANE_COUNT;
+	mesh.m_localX.resize(numPaddedVerts, 0.f);
+	mesh.m_localY.resize(numPaddedVerts, 0.f);
+	mesh.m_localZ.resize(numPaddedVerts, 0.f);
+	mesh.m_localW.resize(numPaddedVerts, 0.f);
+}
+
+PrimitiveMesh const& GetUnitPrimitiveMesh(PrimitiveMeshType type, PrimitiveMeshLOD lod)
+{
+	struct PrimitiveMeshLibrary
+	{
+		PrimitiveMeshLibrary()
+		{
+			for (int typeIndex = 0; typeIndex < NUM_PRIMITIVE_MESH_TYPES; ++typeIndex)
+			{
+				for (int lodIndex = 0; lodIndex < NUM_PRIMITIVE_MESH_LODS; ++lodIndex)
+				{
+					BuildUnitPrimitiveMesh(m_meshes[typeIndex][lodIndex], static_cast<PrimitiveMeshType>(typeIndex), static_cast<PrimitiveMeshLOD>(lodIndex));
+				}
+			}
+		}
+
+		PrimitiveMesh m_meshes[NUM_PRIMITIVE_MESH_TYPES][NUM_PRIMITIVE_MESH_LODS];
+	};
+
+	static PrimitiveMeshLibrary const s_library;
+	return s_library.m_meshes[type][lod];
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static PrimitiveInstanceBasis GetPrimitiveInstanceBasis(PrimitiveInstance const& instance, bool isPlanar, bool isUsingEnd)
+{
+	PrimitiveInstanceBasis basis;
+	basis.m_start = instance.m_start;
+	basis.m_length = isUsingEnd ? instance.m_end - instance.m_start : Vec3();
+	float radius = instance.m_radius;
+
+	if (isPlanar)
+	{
+		Vec2 forward(1.f, 0.f);
+		if (basis.m_length.x != 0.f || basis.m_length.y != 0.f)
+		{
+			forward = Vec2(basis.m_length.x, basis.m_length.y).GetNormalized();
+		}
+		basis.m_iBasis = Vec3(forward.x, forward.y, 0.f) * radius;
+		basis.m_jBasis = Vec3(-forward.y, forward.x, 0.f) * radius;
+		basis.m_kBasis = Vec3(0.f, 0.f, radius);
+		return basis;
+	}
+
+	float lengthSquared = basis.m_length.GetLengthSquared();
+	if (lengthSquared == 0.f)
+	{
+		basis.m_iBasis = Vec3(radius, 0.f, 0.f);
+		basis.m_jBasis = Vec3(0.f, radius, 0.f);
+		basis.m_kBasis = Vec3(0.f, 0.f, radius);
+		return basis;
+	}
+
+	Vec3 forward = basis.m_length / sqrtf(lengthSquared);
+	// +Z keeps the unit mesh's own X and Y, so a Z-aligned instance matches the engine tessellation
+	Vec3 reference = (fabsf(forward.y) < 0.999f) ? Vec3(0.f, 1.f, 0.f) : Vec3(0.f, 0.f, 1.f);
+	Vec3 iBasis = CrossProduct3D(reference, forward).GetNormalized();
+	Vec3 jBasis = CrossProduct3D(forward, iBasis);
+	basis.m_iBasis = iBasis * radius;
+	basis.m_jBasis = jBasis * radius;
+	basis.m_kBasis = forward * radius;
+	return basis;
+}
+
+static Vertex_PCU* AppendUnitVerts(std::vector<Vertex_PCU>& verts, PrimitiveMesh const& mesh, int numInstances)
+{
+	size_t firstVertIndex = verts.size();
+	verts.reserve(firstVertIndex + static_cast<size_t>(numInstances) * mesh.m_numVerts);
+	for (int instanceIndex = 0; instanceIndex < numInstances; ++instanceIndex)
+	{
+		verts.insert(verts.end(), mesh.m_verts.begin(), mesh.m_verts.end());
+	}
+	return verts.data() + firstVertIndex;
+}
+
+void AddVertsForPrimitiveInstances(std::vector<Vertex_PCU>& verts, PrimitiveMeshType type, PrimitiveMeshLOD lod, int numInstances, PrimitiveInstance const* instances)
+{
+	PrimitiveMesh const& mesh = GetUnitPrimitiveMesh(type, lod);
+	Vertex_PCU* out_verts = AppendUnitVerts(verts, mesh, numInstances);
+
+	alignas(32) float worldX[FLOAT_LANE_COUNT];
+	alignas(32) float worldY[FLOAT_LANE_COUNT];
+	alignas(32) float worldZ[FLOAT_LANE_COUNT];
+	for (int instanceIndex = 0; instanceIndex < numInstances; ++instanceIndex)
+	{
+		PrimitiveInstance const& instance = instances[instanceIndex];
+		PrimitiveInstanceBasis basis = GetPrimitiveInstanceBasis(instance, mesh.m_isPlanar, mesh.m_isUsingEnd);
+		FloatLanes startX = LanesSet(basis.m_start.x);
+		FloatLanes startY = LanesSet(basis.m_start.y);
+		FloatLanes startZ = LanesSet(basis.m_start.z);
+		FloatLanes iX = LanesSet(basis.m_iBasis.x);
+		FloatLanes iY = LanesSet(basis.m_iBasis.y);
+		FloatLanes iZ = LanesSet(basis.m_iBasis.z);
+		FloatLanes jX = LanesSet(basis.m_jBasis.x);
+		FloatLanes jY = LanesSet(basis.m_jBasis.y);
+		FloatLanes jZ = LanesSet(basis.m_jBasis.z);
+		FloatLanes kX = LanesSet(basis.m_kBasis.x);
+		FloatLanes kY = LanesSet(basis.m_kBasis.y);
+		FloatLanes kZ = LanesSet(basis.m_kBasis.z);
+		FloatLanes lengthX = LanesSet(basis.m_length.x);
+		FloatLanes lengthY = LanesSet(basis.m_length.y);
+		FloatLanes lengthZ = LanesSet(basis.m_length.z);
+
+		Vertex_PCU* instanceVerts = out_verts + static_cast<size_t>(instanceIndex) * mesh.m_numVerts;
+		for (int firstLaneVert = 0; firstLaneVert < mesh.m_numVerts; firstLaneVert += FLOAT_LANE_COUNT)
+		{
+			FloatLanes x = LanesLoadUnaligned(mesh.m_localX.data() + firstLaneVert);
+			FloatLanes y = LanesLoadUnaligned(mesh.m_localY.data() + firstLaneVert);
+			FloatLanes z = LanesLoadUnaligned(mesh.m_localZ.data() + firstLaneVert);
+			FloatLanes w = LanesLoadUnaligned(mesh.m_localW.data() + firstLaneVert);
+			LanesStore(worldX, LanesAdd(LanesAdd(startX, LanesMul(x, iX)), LanesAdd(LanesAdd(LanesMul(y, jX), LanesMul(z, kX)), LanesMul(w, lengthX))));
+			LanesStore(worldY, LanesAdd(LanesAdd(startY, LanesMul(x, iY)), LanesAdd(LanesAdd(LanesMul(y, jY), LanesMul(z, kY)), LanesMul(w, lengthY))));
+			LanesStore(worldZ, LanesAdd(LanesAdd(startZ, LanesMul(x, iZ)), LanesAdd(LanesAdd(LanesMul(y, jZ), LanesMul(z, kZ)), LanesMul(w, lengthZ))));
+
+			int numLanesUsed = (mesh.m_numVerts - firstLaneVert < FLOAT_LANE_COUNT) ? mesh.m_numVerts - firstLaneVert : FLOAT_LANE_COUNT;
+			for (int laneIndex = 0; laneIndex < numLanesUsed; ++laneIndex)
+			{
+				Vertex_PCU& vert = instanceVerts[firstLaneVert + laneIndex];
+				vert.m_position = Vec3(worldX[laneIndex], worldY[laneIndex], worldZ[laneIndex]);
+				vert.m_color = instance.m_color;
+			}
+		}
+	}
+}
+
+void AddVertsForPrimitiveInstance(std::vector<Vertex_PCU>& verts, PrimitiveMeshType type, PrimitiveMeshLOD lod, PrimitiveInstance const& instance)
+{
+	AddVertsForPrimitiveInstances(verts, type, lod, 1, &instance);
+}
+
+void AddVertsForPrimitiveInstancesScalar(std::vector<Vertex_PCU>& verts, PrimitiveMeshType type, PrimitiveMeshLOD lod, int numInstances, PrimitiveInstance const* instances)
+{
+	PrimitiveMesh const& mesh = GetUnitPrimitiveMesh(type, lod);
+	Vertex_PCU* out_verts = AppendUnitVerts(verts, mesh, numInstances);
+
+	for (int instanceIndex = 0; instanceIndex < numInstances; ++instanceIndex)
+	{
+		PrimitiveInstance const& instance = instances[instanceIndex];
+		PrimitiveInstanceBasis basis = GetPrimitiveInstanceBasis(instance, mesh.m_isPlanar, mesh.m_isUsingEnd);
+		Vertex_PCU* instanceVerts = out_verts + static_cast<size_t>(instanceIndex) * mesh.m_numVerts;
+		for (int vertIndex = 0; vertIndex < mesh.m_numVerts; ++vertIndex)
+		{
+			Vertex_PCU& vert = instanceVerts[vertIndex];
+			vert.m_position = basis.m_start + basis.m_iBasis * mesh.m_localX[vertIndex] + basis.m_jBasis * mesh.m_localY[vertIndex]
+				+ basis.m_kBasis * mesh.m_localZ[vertIndex] + basis.m_length * mesh.m_localW[vertIndex];
+			vert.m_color = instance.m_color;
+		}
+	}
+}
+
+void AddVertsForPrimitiveTessellated(std::vector<Vertex_PCU>& verts, PrimitiveMeshType type, PrimitiveMeshLOD lod, PrimitiveInstance const& instance)
+{
+	int numSlices = GetNumSlicesForPrimitiveMeshLOD(lod);
+	Vec2 start2D(instance.m_start.x, instance.m_start.y);
+	Vec2 end2D(instance.m_end.x, instance.m_end.y);
+	switch (type)
+	{
+	case PRIMITIVE_MESH_DISC_2D:
+		AddVertsForDisc2D(verts, start2D, instance.m_radius, instance.m_color, numSlices);
+		break;
+	case PRIMITIVE_MESH_CAPSULE_2D:
+		AddVertsForCapsule2D(verts, start2D, end2D, instance.m_radius, instance.m_color);
+		break;
+	case PRIMITIVE_MESH_SPHERE_3D:
+		AddVertsForSphere3D(verts, instance.m_start, instance.m_radius, instance.m_color, AABB2::ZERO_TO_ONE, numSlices, numSlices / 2);
+		break;
+	case PRIMITIVE_MESH_CYLINDER_3D:
+		AddVertsForCylinder3D(verts, instance.m_start, instance.m_end, instance.m_radius, instance.m_color, AABB2::ZERO_TO_ONE, numSlices);
+		break;
+	case PRIMITIVE_MESH_ARROW_3D:
+		AddVertsForArrow3D(verts, instance.m_start, instance.m_end, instance.m_radius, instance.m_color, numSlices);
+		break;
+	default:
+		break;
+	}
+}
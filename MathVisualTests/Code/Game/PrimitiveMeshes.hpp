@@ -0,0 +1,75 @@
+#pragma once
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Unit meshes tessellated once per LOD and stamped out per instance, instead of running the sin/cos
+// of AddVertsForDisc2D, AddVertsForSphere3D, ... again for every shape every frame.
+//
+// Each unit vertex keeps its position as radius units along an instance basis plus a fraction of
+// the instance length, so one affine transform places every mesh type:
+//	world = start + x * I + y * J + z * K + w * (end - start)
+// I, J, K are the instance basis scaled by its radius. 3D meshes run along K (the start to end
+// direction), planar meshes along I and stay in the XY plane with K as world Z. Capsule caps and
+// cylinder/arrow ends use w, so length and radius scale independently.
+enum PrimitiveMeshType
+{
+	PRIMITIVE_MESH_DISC_2D,		// start only
+	PRIMITIVE_MESH_CAPSULE_2D,
+	PRIMITIVE_MESH_SPHERE_3D,	// start only, world aligned like AddVertsForSphere3D
+	PRIMITIVE_MESH_CYLINDER_3D,
+	PRIMITIVE_MESH_ARROW_3D,	// head is the last ARROW_HEAD_LENGTH_FRACTION of the length
+	NUM_PRIMITIVE_MESH_TYPES
+};
+
+enum PrimitiveMeshLOD
+{
+	PRIMITIVE_MESH_LOD_LOW,		// 8 slices, 4 sphere stacks
+	PRIMITIVE_MESH_LOD_MEDIUM,	// 16 slices, 8 sphere stacks
+	PRIMITIVE_MESH_LOD_HIGH,	// 32 slices, 16 sphere stacks, the engine defaults
+	NUM_PRIMITIVE_MESH_LODS
+};
+
+constexpr float ARROW_HEAD_LENGTH_FRACTION = 0.3f;
+constexpr float ARROW_HEAD_RADIUS_SCALE = 2.f;
+
+
+//-----------------------------------------------------------------------------------------------
+struct PrimitiveInstance
+{
+	Vec3 m_start;
+	Vec3 m_end; // ignored by discs and spheres
+	float m_radius = 1.f;
+	Rgba8 m_color = Rgba8::OPAQUE_WHITE;
+};
+
+struct PrimitiveMesh
+{
+	bool m_isPlanar = false;
+	bool m_isUsingEnd = false; // discs and spheres only place by start and radius
+	int m_numVerts = 0;
+	std::vector<Vertex_PCU> m_verts; // white, with the final UVs, positions are overwritten per instance
+
+	// Unit positions split into lanes, padded with zeros to a multiple of FLOAT_LANE_COUNT
+	std::vector<float> m_localX;
+	std::vector<float> m_localY;
+	std::vector<float> m_localZ;
+	std::vector<float> m_localW;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+int GetNumSlicesForPrimitiveMeshLOD(PrimitiveMeshLOD lod);
+PrimitiveMesh const& GetUnitPrimitiveMesh(PrimitiveMeshType type, PrimitiveMeshLOD lod); // built on first use
+
+void AddVertsForPrimitiveInstances(std::vector<Vertex_PCU>& verts, PrimitiveMeshType type, PrimitiveMeshLOD lod, int numInstances, PrimitiveInstance const* instances);
+void AddVertsForPrimitiveInstance(std::vector<Vertex_PCU>& verts, PrimitiveMeshType type, PrimitiveMeshLOD lod, PrimitiveInstance const& instance);
+
+// Same transform one vertex at a time, kept as the reference for the SIMD path
+void AddVertsForPrimitiveInstancesScalar(std::vector<Vertex_PCU>& verts, PrimitiveMeshType type, PrimitiveMeshLOD lod, int numInstances, PrimitiveInstance const* instances);
+
+// The engine call each mesh replaces, with the same slice counts
+void AddVertsForPrimitiveTessellated(std::vector<Vertex_PCU>& verts, PrimitiveMeshType type, PrimitiveMeshLOD lod, PrimitiveInstance const& instance);
+char const* GetNameForPrimitiveMeshType(PrimitiveMeshType type);
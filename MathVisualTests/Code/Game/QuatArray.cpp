@@ -0,0 +1,237 @@
+#include "Game/QuatArray.hpp"
+#include "Game/FloatLanes.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Slerp weight polynomial: sin(t * angle) / sin(angle) = t * (1 + b0 * (1 + b1 * (1 + ...)))
+// with b[i] = (u[i] * t^2 - v[i]) * (cos(angle) - 1), u[i] = 1 / (i * (2i + 1)), v[i] = i / (2i + 1)
+// for i from 1. The last term is scaled to make up for the truncated tail.
+static constexpr int SLERP_FAST_NUM_TERMS = 4;
+static constexpr int SLERP_PRECISE_NUM_TERMS = 8;
+static constexpr float SLERP_FAST_TAIL_SCALE = 1.7594f;
+static constexpr float SLERP_PRECISE_TAIL_SCALE = 1.8529f;
+
+
+//-----------------------------------------------------------------------------------------------
+static int GetPaddedSize(int numQuats)
+{
+	return (numQuats + FLOAT_LANE_COUNT - 1) / FLOAT_LANE_COUNT * FLOAT_LANE_COUNT;
+}
+
+static void ResizeResults(QuatArray const& start, QuatArray& out_results)
+{
+	if (out_results.m_numQuats != start.m_numQuats)
+	{
+		out_results.Resize(start.m_numQuats);
+	}
+}
+
+// Runs kernel(start, end, fraction, out_result) over every block of lanes, xyzw in each array
+// Fractions past the end of the caller's array read as 0
+template<typename KernelType>
+static void ForEachQuatBlock(QuatArray const& start, QuatArray const& end, float const* fractions, QuatArray& out_results, KernelType const& kernel)
+{
+	ResizeResults(start, out_results);
+	int numQuats = start.m_numQuats;
+	int paddedSize = GetPaddedSize(numQuats);
+	for (int blockStart = 0; blockStart < paddedSize; blockStart += FLOAT_LANE_COUNT)
+	{
+		FloatLanes fraction;
+		if (blockStart + FLOAT_LANE_COUNT <= numQuats)
+		{
+			fraction = LanesLoadUnaligned(fractions + blockStart);
+		}
+		else
+		{
+			alignas(32) float tailFractions[FLOAT_LANE_COUNT] = {};
+			for (int quatIndex = blockStart; quatIndex < numQuats; ++quatIndex)
+			{
+				tailFractions[quatIndex - blockStart] = fractions[quatIndex];
+			}
+			fraction = LanesLoad(tailFractions);
+		}
+
+		FloatLanes startQuat[4] = {
+			LanesLoadUnaligned(&start.m_x[blockStart]), LanesLoadUnaligned(&start.m_y[blockStart]),
+			LanesLoadUnaligned(&start.m_z[blockStart]), LanesLoadUnaligned(&start.m_w[blockStart]) };
+		FloatLanes endQuat[4] = {
+			LanesLoadUnaligned(&end.m_x[blockStart]), LanesLoadUnaligned(&end.m_y[blockStart]),
+			LanesLoadUnaligned(&end.m_z[blockStart]), LanesLoadUnaligned(&end.m_w[blockStart]) };
+		FloatLanes result[4];
+		kernel(startQuat, endQuat, fraction, result);
+
+		LanesStoreUnaligned(&out_results.m_x[blockStart], result[0]);
+		LanesStoreUnaligned(&out_results.m_y[blockStart], result[1]);
+		LanesStoreUnaligned(&out_results.m_z[blockStart], result[2]);
+		LanesStoreUnaligned(&out_results.m_w[blockStart], result[3]);
+	}
+}
+
+static FloatLanes GetQuatDot(FloatLanes const* a, FloatLanes const* b)
+{
+	FloatLanes dot = LanesMul(a[0], b[0]);
+	dot = LanesAdd(dot, LanesMul(a[1], b[1]));
+	dot = LanesAdd(dot, LanesMul(a[2], b[2]));
+	return LanesAdd(dot, LanesMul(a[3], b[3]));
+}
+
+static void NormalizeQuat(FloatLanes* quat)
+{
+	FloatLanes inverseLength = LanesDiv(LanesSet(1.f), LanesSqrt(GetQuatDot(quat, quat)));
+	for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+	{
+		quat[componentIndex] = LanesMul(quat[componentIndex], inverseLength);
+	}
+}
+
+static void FlipEndToStartHemisphere(FloatLanes const* startQuat, FloatLanes* endQuat)
+{
+	FloatLanes isOppositeHemisphere = LanesLess(GetQuatDot(startQuat, endQuat), LanesSet(0.f));
+	for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+	{
+		endQuat[componentIndex] = LanesSelect(isOppositeHemisphere, LanesNegate(endQuat[componentIndex]), endQuat[componentIndex]);
+	}
+}
+
+// sin(fraction * angle) / sin(angle) given cosAngleMinusOne = cos(angle) - 1
+template<int NUM_TERMS>
+static FloatLanes GetSlerpWeight(FloatLanes fraction, FloatLanes cosAngleMinusOne, float tailScale)
+{
+	FloatLanes fractionSquared = LanesMul(fraction, fraction);
+	FloatLanes series = LanesSet(1.f);
+	for (int termIndex = NUM_TERMS; termIndex >= 1; --termIndex)
+	{
+		float termScale = (termIndex == NUM_TERMS) ? tailScale : 1.f;
+		float u = termScale / static_cast<float>(termIndex * (2 * termIndex + 1));
+		float v = termScale * static_cast<float>(termIndex) / static_cast<float>(2 * termIndex + 1);
+		FloatLanes b = LanesMul(LanesSub(LanesMul(LanesSet(u), fractionSquared), LanesSet(v)), cosAngleMinusOne);
+		series = LanesAdd(LanesSet(1.f), LanesMul(b, series));
+	}
+	return LanesMul(fraction, series);
+}
+
+// Both quats unit length and within 90 degrees of each other
+static void SlerpShortestPath(FloatLanes const* startQuat, FloatLanes const* endQuat, FloatLanes fraction, SlerpAccuracy accuracy, FloatLanes* out_result)
+{
+	FloatLanes cosAngleMinusOne = LanesSub(GetQuatDot(startQuat, endQuat), LanesSet(1.f));
+	FloatLanes startFraction = LanesSub(LanesSet(1.f), fraction);
+	FloatLanes startWeight;
+	FloatLanes endWeight;
+	if (accuracy == SLERP_ACCURACY_FAST)
+	{
+		startWeight = GetSlerpWeight<SLERP_FAST_NUM_TERMS>(startFraction, cosAngleMinusOne, SLERP_FAST_TAIL_SCALE);
+		endWeight = GetSlerpWeight<SLERP_FAST_NUM_TERMS>(fraction, cosAngleMinusOne, SLERP_FAST_TAIL_SCALE);
+	}
+	else
+	{
+		startWeight = GetSlerpWeight<SLERP_PRECISE_NUM_TERMS>(startFraction, cosAngleMinusOne, SLERP_PRECISE_TAIL_SCALE);
+		endWeight = GetSlerpWeight<SLERP_PRECISE_NUM_TERMS>(fraction, cosAngleMinusOne, SLERP_PRECISE_TAIL_SCALE);
+	}
+	for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+	{
+		out_result[componentIndex] = LanesAdd(LanesMul(startQuat[componentIndex], startWeight), LanesMul(endQuat[componentIndex], endWeight));
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void QuatArray::Resize(int numQuats)
+{
+	int paddedSize = GetPaddedSize(numQuats);
+	m_numQuats = numQuats;
+	m_x.resize(paddedSize);
+	m_y.resize(paddedSize);
+	m_z.resize(paddedSize);
+	m_w.resize(paddedSize);
+	for (int quatIndex = numQuats; quatIndex < paddedSize; ++quatIndex)
+	{
+		SetQuat(quatIndex, Quat::IDENTITY);
+	}
+}
+
+void QuatArray::SetQuat(int quatIndex, Quat const& quat)
+{
+	m_x[quatIndex] = quat.x;
+	m_y[quatIndex] = quat.y;
+	m_z[quatIndex] = quat.z;
+	m_w[quatIndex] = quat.w;
+}
+
+Quat QuatArray::GetQuat(int quatIndex) const
+{
+	return Quat(m_x[quatIndex], m_y[quatIndex], m_z[quatIndex], m_w[quatIndex]);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void LerpQuatArrays(QuatArray const& start, QuatArray const& end, float const* fractions, QuatArray& out_results)
+{
+	ForEachQuatBlock(start, end, fractions, out_results, [](FloatLanes const* startQuat, FloatLanes const* endQuat, FloatLanes fraction, FloatLanes* out_result)
+	{
+		for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+		{
+			out_result[componentIndex] = LanesAdd(startQuat[componentIndex], LanesMul(LanesSub(endQuat[componentIndex], startQuat[componentIndex]), fraction));
+		}
+	});
+}
+
+void NlerpQuatArrays(QuatArray const& start, QuatArray const& end, float const* fractions, QuatArray& out_results, bool isShortestPath)
+{
+	ForEachQuatBlock(start, end, fractions, out_results, [isShortestPath](FloatLanes const* startQuat, FloatLanes const* endQuat, FloatLanes fraction, FloatLanes* out_result)
+	{
+		FloatLanes targetQuat[4] = { endQuat[0], endQuat[1], endQuat[2], endQuat[3] };
+		if (isShortestPath)
+		{
+			FlipEndToStartHemisphere(startQuat, targetQuat);
+		}
+		for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+		{
+			out_result[componentIndex] = LanesAdd(startQuat[componentIndex], LanesMul(LanesSub(targetQuat[componentIndex], startQuat[componentIndex]), fraction));
+		}
+		NormalizeQuat(out_result);
+	});
+}
+
+void SlerpQuatArrays(QuatArray const& start, QuatArray const& end, float const* fractions, QuatArray& out_results, SlerpAccuracy accuracy)
+{
+	ForEachQuatBlock(start, end, fractions, out_results, [accuracy](FloatLanes const* startQuat, FloatLanes const* endQuat, FloatLanes fraction, FloatLanes* out_result)
+	{
+		FloatLanes targetQuat[4] = { endQuat[0], endQuat[1], endQuat[2], endQuat[3] };
+		FlipEndToStartHemisphere(startQuat, targetQuat);
+		SlerpShortestPath(startQuat, targetQuat, fraction, accuracy, out_result);
+	});
+}
+
+void SlerpFullPathQuatArrays(QuatArray const& start, QuatArray const& end, float const* fractions, QuatArray& out_results, SlerpAccuracy accuracy)
+{
+	// Beyond 90 degrees the polynomial loses accuracy, so the arc is split at its midpoint
+	// and each lane slerps along whichever half its fraction falls in
+	ForEachQuatBlock(start, end, fractions, out_results, [accuracy](FloatLanes const* startQuat, FloatLanes const* endQuat, FloatLanes fraction, FloatLanes* out_result)
+	{
+		FloatLanes midQuat[4];
+		for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+		{
+			midQuat[componentIndex] = LanesAdd(startQuat[componentIndex], endQuat[componentIndex]);
+		}
+
+		// Opposite quats sum to zero and every great circle through them is a shortest path,
+		// so those lanes take (-y, x, -w, z), a unit quat 90 degrees from start, as the midpoint
+		FloatLanes isOpposite = LanesLess(GetQuatDot(midQuat, midQuat), LanesSet(1e-6f));
+		FloatLanes const perpendicularQuat[4] = { LanesNegate(startQuat[1]), startQuat[0], LanesNegate(startQuat[3]), startQuat[2] };
+		for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+		{
+			midQuat[componentIndex] = LanesSelect(isOpposite, perpendicularQuat[componentIndex], midQuat[componentIndex]);
+		}
+		NormalizeQuat(midQuat);
+
+		FloatLanes isSecondHalf = LanesLessEqual(LanesSet(0.5f), fraction);
+		FloatLanes halfStart[4];
+		FloatLanes halfEnd[4];
+		for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+		{
+			halfStart[componentIndex] = LanesSelect(isSecondHalf, midQuat[componentIndex], startQuat[componentIndex]);
+			halfEnd[componentIndex] = LanesSelect(isSecondHalf, endQuat[componentIndex], midQuat[componentIndex]);
+		}
+		FloatLanes halfFraction = LanesSub(LanesAdd(fraction, fraction), LanesSelect(isSecondHalf, LanesSet(1.f), LanesSet(0.f)));
+		SlerpShortestPath(halfStart, halfEnd, halfFraction, accuracy, out_result);
+	});
+}
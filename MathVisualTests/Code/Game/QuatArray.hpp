@@ -0,0 +1,43 @@
+#pragma once
+#include "Engine/Math/Quat.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Quaternions stored as a structure of arrays for the batched interpolators below
+// Arrays are padded to the SIMD lane count, padding holds the identity
+struct QuatArray
+{
+	int m_numQuats = 0;
+
+	std::vector<float> m_x;
+	std::vector<float> m_y;
+	std::vector<float> m_z;
+	std::vector<float> m_w;
+
+	void Resize(int numQuats);
+	void SetQuat(int quatIndex, Quat const& quat);
+	Quat GetQuat(int quatIndex) const;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Slerp weights come from a polynomial in cos(angle) instead of acos and sin, truncated after
+// 4 or 8 terms. Measured against a double precision slerp over random unit quats, the max
+// angular error is about 0.04 degrees for FAST and 0.001 degrees for PRECISE. Full path slerp
+// loses more only within a hair of opposite rotations, where the path itself is ill defined;
+// exactly opposite rotations go through an arbitrary but finite perpendicular midpoint.
+enum SlerpAccuracy
+{
+	SLERP_ACCURACY_FAST,
+	SLERP_ACCURACY_PRECISE,
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Batched Quat::Lerp, Nlerp, Slerp and SlerpFullPath, element i of out_results blends element i
+// of start and end by fractions[i]. fractions needs start.m_numQuats entries, start and end the
+// same size, and out_results is resized to match and keeps its capacity between calls.
+void LerpQuatArrays(QuatArray const& start, QuatArray const& end, float const* fractions, QuatArray& out_results);
+void NlerpQuatArrays(QuatArray const& start, QuatArray const& end, float const* fractions, QuatArray& out_results, bool isShortestPath = true);
+void SlerpQuatArrays(QuatArray const& start, QuatArray const& end, float const* fractions, QuatArray& out_results, SlerpAccuracy accuracy = SLERP_ACCURACY_PRECISE);
+void SlerpFullPathQuatArrays(QuatArray const& start, QuatArray const& end, float const* fractions, QuatArray& out_results, SlerpAccuracy accuracy = SLERP_ACCURACY_PRECISE);
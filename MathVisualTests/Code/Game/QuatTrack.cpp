@@ -0,0 +1,203 @@
+#include "Game/QuatTrack.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include <algorithm>
+#include <cmath>
+
+//-----------------------------------------------------------------------------------------------
+static float GetQuatDot(Quat const& a, Quat const& b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+static Quat GetNegated(Quat const& quat)
+{
+	return Quat(-quat.x, -quat.y, -quat.z, -quat.w);
+}
+
+static Quat GetConjugate(Quat const& quat)
+{
+	return Quat(-quat.x, -quat.y, -quat.z, quat.w);
+}
+
+static Quat MultiplyQuats(Quat const& a, Quat const& b)
+{
+	return Quat(
+		a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+		a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+		a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+		a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z);
+}
+
+// Unit quat to its rotation vector (half angle times axis), w is left 0
+static Quat GetLog(Quat const& quat)
+{
+	float vectorLength = sqrtf(quat.x * quat.x + quat.y * quat.y + quat.z * quat.z);
+	float scale = (vectorLength > 1e-6f) ? atan2f(vectorLength, quat.w) / vectorLength : 1.f;
+	return Quat(quat.x * scale, quat.y * scale, quat.z * scale, 0.f);
+}
+
+static Quat GetExp(Quat const& rotationVector)
+{
+	float halfAngle = sqrtf(rotationVector.x * rotationVector.x + rotationVector.y * rotationVector.y + rotationVector.z * rotationVector.z);
+	float scale = (halfAngle > 1e-6f) ? sinf(halfAngle) / halfAngle : 1.f;
+	return Quat(rotationVector.x * scale, rotationVector.y * scale, rotationVector.z * scale, cosf(halfAngle));
+}
+
+// Slerp that keeps the given hemisphere, Squad's inner and outer slerps must not flip
+static Quat SlerpWithoutFlip(Quat const& start, Quat const& end, float fraction)
+{
+	float dot = GetQuatDot(start, end);
+	float startWeight = 1.f - fraction;
+	float endWeight = fraction;
+	if (dot < 0.9995f)
+	{
+		float angle = acosf(dot);
+		float inverseSin = 1.f / sinf(angle);
+		startWeight = sinf(startWeight * angle) * inverseSin;
+		endWeight = sinf(endWeight * angle) * inverseSin;
+	}
+	Quat result(start.x * startWeight + end.x * endWeight, start.y * startWeight + end.y * endWeight,
+		start.z * startWeight + end.z * endWeight, start.w * startWeight + end.w * endWeight);
+	result.Normalize();
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void QuatTrack::SetUniformKeys(std::vector<Quat> const& keyRotations, float keySpacing)
+{
+	GUARANTEE_OR_DIE(!keyRotations.empty() && keySpacing > 0.f, "QuatTrack needs at least one key and a positive spacing!");
+	m_isUniform = true;
+	m_keySpacing = keySpacing;
+	m_keyTimes.clear();
+	m_keyRotations = keyRotations;
+	UpdateControls();
+}
+
+void QuatTrack::SetKeys(std::vector<float> const& keyTimes, std::vector<Quat> const& keyRotations)
+{
+	GUARANTEE_OR_DIE(!keyRotations.empty() && keyTimes.size() == keyRotations.size(), "QuatTrack needs one time per key!");
+	for (int keyIndex = 1; keyIndex < static_cast<int>(keyTimes.size()); ++keyIndex)
+	{
+		GUARANTEE_OR_DIE(keyTimes[keyIndex - 1] < keyTimes[keyIndex], "QuatTrack key times must be strictly increasing!");
+	}
+	m_isUniform = false;
+	m_keyTimes = keyTimes;
+	m_keyRotations = keyRotations;
+	UpdateControls();
+}
+
+float QuatTrack::GetDuration() const
+{
+	if (m_isUniform)
+	{
+		return static_cast<float>(GetNumKeys() - 1) * m_keySpacing;
+	}
+	return m_keyTimes.back() - m_keyTimes.front();
+}
+
+void QuatTrack::UpdateControls()
+{
+	// Same hemisphere as the previous key so every segment takes the short way
+	int numKeys = GetNumKeys();
+	for (int keyIndex = 1; keyIndex < numKeys; ++keyIndex)
+	{
+		if (GetQuatDot(m_keyRotations[keyIndex - 1], m_keyRotations[keyIndex]) < 0.f)
+		{
+			m_keyRotations[keyIndex] = GetNegated(m_keyRotations[keyIndex]);
+		}
+	}
+
+	// s_i = q_i * exp(-(log(q_i^-1 * q_i+1) + log(q_i^-1 * q_i-1)) / 4), end keys are their own control
+	m_keyControls = m_keyRotations;
+	for (int keyIndex = 1; keyIndex < numKeys - 1; ++keyIndex)
+	{
+		Quat const& key = m_keyRotations[keyIndex];
+		Quat inverseKey = GetConjugate(key);
+		Quat toNext = GetLog(MultiplyQuats(inverseKey, m_keyRotations[keyIndex + 1]));
+		Quat toPrevious = GetLog(MultiplyQuats(inverseKey, m_keyRotations[keyIndex - 1]));
+		Quat controlOffset(-0.25f * (toNext.x + toPrevious.x), -0.25f * (toNext.y + toPrevious.y), -0.25f * (toNext.z + toPrevious.z), 0.f);
+		m_keyControls[keyIndex] = MultiplyQuats(key, GetExp(controlOffset));
+	}
+}
+
+void QuatTrack::GetSegmentAndFraction(float time, int& out_segmentIndex, float& out_fraction) const
+{
+	int numSegments = GetNumKeys() - 1;
+	if (numSegments <= 0)
+	{
+		out_segmentIndex = 0;
+		out_fraction = 0.f;
+		return;
+	}
+
+	if (m_isUniform)
+	{
+		float segmentTime = time / m_keySpacing;
+		segmentTime = (segmentTime < 0.f) ? 0.f : ((segmentTime > static_cast<float>(numSegments)) ? static_cast<float>(numSegments) : segmentTime);
+		int segmentIndex = static_cast<int>(segmentTime);
+		segmentIndex = (segmentIndex < numSegments) ? segmentIndex : numSegments - 1;
+		out_segmentIndex = segmentIndex;
+		out_fraction = segmentTime - static_cast<float>(segmentIndex);
+		return;
+	}
+
+	// First key after the time ends the segment
+	int endKeyIndex = static_cast<int>(std::upper_bound(m_keyTimes.begin(), m_keyTimes.end(), time) - m_keyTimes.begin());
+	endKeyIndex = (endKeyIndex < 1) ? 1 : ((endKeyIndex > numSegments) ? numSegments : endKeyIndex);
+	float startTime = m_keyTimes[endKeyIndex - 1];
+	float segmentDuration = m_keyTimes[endKeyIndex] - startTime;
+	float fraction = (segmentDuration > 0.f) ? (time - startTime) / segmentDuration : 0.f;
+	out_segmentIndex = endKeyIndex - 1;
+	out_fraction = (fraction < 0.f) ? 0.f : ((fraction > 1.f) ? 1.f : fraction);
+}
+
+Quat QuatTrack::Sample(float time) const
+{
+	if (GetNumKeys() == 1)
+	{
+		return m_keyRotations[0];
+	}
+
+	int segmentIndex = 0;
+	float fraction = 0.f;
+	GetSegmentAndFraction(time, segmentIndex, fraction);
+	Quat keyBlend = SlerpWithoutFlip(m_keyRotations[segmentIndex], m_keyRotations[segmentIndex + 1], fraction);
+	Quat controlBlend = SlerpWithoutFlip(m_keyControls[segmentIndex], m_keyControls[segmentIndex + 1], fraction);
+	return SlerpWithoutFlip(keyBlend, controlBlend, 2.f * fraction * (1.f - fraction));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void QuatTrackBatchSampler::Sample(int numTracks, QuatTrack const* tracks, float const* times, QuatArray& out_rotations, SlerpAccuracy accuracy)
+{
+	m_startKeys.Resize(numTracks);
+	m_endKeys.Resize(numTracks);
+	m_startControls.Resize(numTracks);
+	m_endControls.Resize(numTracks);
+	m_fractions.resize(numTracks);
+	m_squadWeights.resize(numTracks);
+
+	// Segment lookup per track, then everything after it is three batched slerps
+	for (int trackIndex = 0; trackIndex < numTracks; ++trackIndex)
+	{
+		QuatTrack const& track = tracks[trackIndex];
+		int segmentIndex = 0;
+		float fraction = 0.f;
+		track.GetSegmentAndFraction(times[trackIndex], segmentIndex, fraction);
+		int endKeyIndex = (track.GetNumKeys() > 1) ? segmentIndex + 1 : segmentIndex;
+
+		m_startKeys.SetQuat(trackIndex, track.GetKeyRotation(segmentIndex));
+		m_endKeys.SetQuat(trackIndex, track.GetKeyRotation(endKeyIndex));
+		m_startControls.SetQuat(trackIndex, track.GetKeyControl(segmentIndex));
+		m_endControls.SetQuat(trackIndex, track.GetKeyControl(endKeyIndex));
+		m_fractions[trackIndex] = fraction;
+		m_squadWeights[trackIndex] = 2.f * fraction * (1.f - fraction);
+	}
+
+	// Squad's slerps must not flip to the short way: the controls of neighboring keys can sit in
+	// opposite hemispheres even when the keys do not
+	SlerpFullPathQuatArrays(m_startKeys, m_endKeys, m_fractions.data(), m_keyBlends, accuracy);
+	SlerpFullPathQuatArrays(m_startControls, m_endControls, m_fractions.data(), m_controlBlends, accuracy);
+	SlerpFullPathQuatArrays(m_keyBlends, m_controlBlends, m_squadWeights.data(), out_rotations, accuracy);
+}
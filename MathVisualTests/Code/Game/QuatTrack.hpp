@@ -0,0 +1,57 @@
+#pragma once
+#include "Game/QuatArray.hpp"
+#include "Engine/Math/Quat.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Rotation keys joined by Squad (spherical cubic) segments, smooth through every key where
+// piecewise Slerp has a velocity jump. The intermediate control quat of every key is computed
+// once when the keys are set, sampling is then three slerps.
+// Uniformly spaced keys find their segment with one divide, others with a binary search.
+class QuatTrack
+{
+public:
+	void SetUniformKeys(std::vector<Quat> const& keyRotations, float keySpacing);
+	void SetKeys(std::vector<float> const& keyTimes, std::vector<Quat> const& keyRotations); // times strictly increasing
+
+	int GetNumKeys() const { return (int)m_keyRotations.size(); }
+	float GetDuration() const;
+	bool IsUniform() const { return m_isUniform; }
+
+	// Times are clamped to the track
+	Quat Sample(float time) const;
+	void GetSegmentAndFraction(float time, int& out_segmentIndex, float& out_fraction) const;
+
+	Quat const& GetKeyRotation(int keyIndex) const { return m_keyRotations[keyIndex]; }
+	Quat const& GetKeyControl(int keyIndex) const { return m_keyControls[keyIndex]; }
+
+private:
+	void UpdateControls();
+
+private:
+	bool m_isUniform = true;
+	float m_keySpacing = 1.f; // uniform only
+	std::vector<float> m_keyTimes; // non-uniform only
+	std::vector<Quat> m_keyRotations; // each in the same hemisphere as the one before it
+	std::vector<Quat> m_keyControls;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Samples many tracks at once, track i at times[i], with the SIMD slerps of QuatArray
+// Keeps its gather arrays between calls, reuse one sampler every frame
+class QuatTrackBatchSampler
+{
+public:
+	void Sample(int numTracks, QuatTrack const* tracks, float const* times, QuatArray& out_rotations, SlerpAccuracy accuracy = SLERP_ACCURACY_PRECISE);
+
+private:
+	QuatArray m_startKeys;
+	QuatArray m_endKeys;
+	QuatArray m_startControls;
+	QuatArray m_endControls;
+	QuatArray m_keyBlends;
+	QuatArray m_controlBlends;
+	std::vector<float> m_fractions;
+	std::vector<float> m_squadWeights;
+};
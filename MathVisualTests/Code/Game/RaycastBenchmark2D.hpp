@@ -0,0 +1,161 @@
+#pragma once
+#include "Game/BVH2D.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/RaycastScene2D.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <cmath>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// The benchmark shared by the disc, line segment and AABB2 raycast modes: the per-shape loop the
+// modes used before against their SoA scene, over the same random rays, with about the same number
+// of shape tests at every scene size.
+//
+// ShapeType is the mode's shape, constructed from the scene dimensions like the modes spawn them.
+// addShapeToScene(scene, shape), raycastVsShape(shape, rayStart, rayForwardNormal, rayLength) and
+// getShapeBounds(shape) are lambdas around the mode's own code, so the loops inline them like the
+// mode's own loops do.
+//
+// Each scene size also reports BVH2D build time and closest/any hit throughput on the same rays,
+// checked against the scalar loop.
+//
+// The packet column is the multi-ray SceneType::RaycastClosest, whose SIMD lanes are rays: each shape
+// is read once per packet of rays instead of once per ray.
+template<typename ShapeType, typename SceneType, typename AddShapeToSceneFunction, typename RaycastVsShapeFunction, typename GetShapeBoundsFunction>
+void RunRaycastBenchmark2D(BenchmarkReport& report, char const* shapeNames, AddShapeToSceneFunction addShapeToScene, RaycastVsShapeFunction raycastVsShape,
+	GetShapeBoundsFunction getShapeBounds)
+{
+	constexpr int NUM_SHAPE_TESTS = 50000000;
+	int const sceneSizes[] = { 1000, 100000, 1000000 };
+	Vec2 sceneDimensions = Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y);
+
+	report.AddSection(Stringf("Raycast vs %s (Mrays/s)", shapeNames));
+	for (int numShapes : sceneSizes)
+	{
+		std::vector<ShapeType> shapeList;
+		SceneType scene;
+		shapeList.reserve(numShapes);
+		scene.Reserve(numShapes);
+		for (int shapeIndex = 0; shapeIndex < numShapes; ++shapeIndex)
+		{
+			ShapeType const& shape = shapeList.emplace_back(sceneDimensions);
+			addShapeToScene(scene, shape);
+		}
+
+		int numRays = NUM_SHAPE_TESTS / numShapes;
+		std::vector<Vec2> rayStarts(numRays);
+		std::vector<Vec2> rayEnds(numRays);
+		for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+		{
+			rayStarts[rayIndex] = Vec2(g_rng.RollRandomFloatInRange(0.f, SCREEN_SIZE_X), g_rng.RollRandomFloatInRange(0.f, SCREEN_SIZE_Y));
+			rayEnds[rayIndex] = Vec2(g_rng.RollRandomFloatInRange(0.f, SCREEN_SIZE_X), g_rng.RollRandomFloatInRange(0.f, SCREEN_SIZE_Y));
+		}
+
+		std::vector<float> scalarImpactDists(numRays, -1.f);
+		BenchmarkTimer scalarTimer;
+		for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+		{
+			Vec2 const& startPos = rayStarts[rayIndex];
+			for (ShapeType const& shape : shapeList)
+			{
+				Vec2 disp = rayEnds[rayIndex] - startPos;
+				RaycastResult2D result = raycastVsShape(shape, startPos, disp.GetNormalized(), disp.GetLength());
+				if (result.m_didImpact && (scalarImpactDists[rayIndex] < 0.f || result.m_impactDist < scalarImpactDists[rayIndex]))
+				{
+					scalarImpactDists[rayIndex] = result.m_impactDist;
+				}
+			}
+		}
+		double scalarSeconds = scalarTimer.GetElapsedSeconds();
+
+		std::vector<Vec2> rayForwardNormals(numRays);
+		std::vector<float> rayLengths(numRays);
+		std::vector<RaycastSceneHit2D> hits(numRays);
+		BenchmarkTimer sceneTimer;
+		for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+		{
+			Vec2 disp = rayEnds[rayIndex] - rayStarts[rayIndex];
+			rayForwardNormals[rayIndex] = disp.GetNormalized();
+			rayLengths[rayIndex] = disp.GetLength();
+		}
+		scene.RaycastClosest(numRays, rayStarts.data(), rayForwardNormals.data(), rayLengths.data(), hits.data());
+		double sceneSeconds = sceneTimer.GetElapsedSeconds();
+
+		// BVH: build time over the same shapes, then closest hit and any hit over the same rays
+		BenchmarkTimer bvhBuildTimer;
+		std::vector<AABB2> shapeBounds;
+		shapeBounds.reserve(numShapes);
+		for (ShapeType const& shape : shapeList)
+		{
+			shapeBounds.push_back(getShapeBounds(shape));
+		}
+		BVH2D shapeBVH;
+		shapeBVH.Build(shapeBounds);
+		double bvhBuildMilliseconds = bvhBuildTimer.GetElapsedMilliseconds();
+
+		std::vector<float> bvhImpactDists(numRays, -1.f);
+		BenchmarkTimer bvhClosestTimer;
+		for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+		{
+			float& closestImpactDist = bvhImpactDists[rayIndex];
+			auto leafRaycast = [&](int shapeIndex, float closestDist)
+				{
+					RaycastResult2D result = raycastVsShape(shapeList[shapeIndex], rayStarts[rayIndex], rayForwardNormals[rayIndex], rayLengths[rayIndex]);
+					if (!result.m_didImpact || result.m_impactDist >= closestDist)
+					{
+						return -1.f;
+					}
+					closestImpactDist = result.m_impactDist;
+					return result.m_impactDist;
+				};
+			shapeBVH.RaycastClosest(rayStarts[rayIndex], rayForwardNormals[rayIndex], rayLengths[rayIndex], leafRaycast);
+		}
+		double bvhClosestSeconds = bvhClosestTimer.GetElapsedSeconds();
+
+		int numAnyHits = 0;
+		BenchmarkTimer bvhAnyTimer;
+		for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+		{
+			auto leafHit = [&](int shapeIndex)
+				{
+					return raycastVsShape(shapeList[shapeIndex], rayStarts[rayIndex], rayForwardNormals[rayIndex], rayLengths[rayIndex]).m_didImpact;
+				};
+			numAnyHits += shapeBVH.RaycastAny(rayStarts[rayIndex], rayForwardNormals[rayIndex], rayLengths[rayIndex], leafHit) ? 1 : 0;
+		}
+		double bvhAnySeconds = bvhAnyTimer.GetElapsedSeconds();
+
+		int numMismatches = 0;
+		int numBVHMismatches = 0;
+		int numScalarHits = 0;
+		for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+		{
+			bool didScalarImpact = scalarImpactDists[rayIndex] >= 0.f;
+			if (didScalarImpact != hits[rayIndex].DidImpact()
+				|| (didScalarImpact && fabsf(scalarImpactDists[rayIndex] - hits[rayIndex].m_impactDist) > 0.01f))
+			{
+				++numMismatches;
+			}
+			if (didScalarImpact != (bvhImpactDists[rayIndex] >= 0.f)
+				|| (didScalarImpact && fabsf(scalarImpactDists[rayIndex] - bvhImpactDists[rayIndex]) > 0.01f))
+			{
+				++numBVHMismatches;
+			}
+			if (didScalarImpact)
+			{
+				++numScalarHits;
+			}
+		}
+
+		double scalarMegaRaysPerSecond = static_cast<double>(numRays) * 1e-6 / scalarSeconds;
+		double sceneMegaRaysPerSecond = static_cast<double>(numRays) * 1e-6 / sceneSeconds;
+		report.AddLine(Stringf("%7d shapes: scalar %9.4f, packet %9.4f (x%.1f), %d mismatches",
+			numShapes, scalarMegaRaysPerSecond, sceneMegaRaysPerSecond, sceneMegaRaysPerSecond / scalarMegaRaysPerSecond, numMismatches));
+		double bvhClosestMegaRaysPerSecond = static_cast<double>(numRays) * 1e-6 / bvhClosestSeconds;
+		double bvhAnyMegaRaysPerSecond = static_cast<double>(numRays) * 1e-6 / bvhAnySeconds;
+		report.AddLine(Stringf("        BVH build %.1f ms (%d nodes, depth %d), closest %9.4f, any %9.4f, %d mismatches%s",
+			bvhBuildMilliseconds, shapeBVH.GetNumNodes(), shapeBVH.GetDepth(), bvhClosestMegaRaysPerSecond, bvhAnyMegaRaysPerSecond,
+			numBVHMismatches, (numAnyHits == numScalarHits) ? "" : " (any hit count differs)"));
+	}
+}
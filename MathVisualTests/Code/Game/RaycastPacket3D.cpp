@@ -0,0 +1,402 @@
+#include "Game/RaycastPacket3D.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+//-----------------------------------------------------------------------------------------------
+static constexpr float LANE_NEAR_ZERO = 1e-20f;
+static constexpr float LANE_FAR_DIST = 1e30f;
+
+// Per-packet values shared by every shape kernel
+struct PacketRays
+{
+	FloatLanes m_startX, m_startY, m_startZ;
+	FloatLanes m_fwdX, m_fwdY, m_fwdZ;
+	FloatLanes m_inverseFwdX, m_inverseFwdY, m_inverseFwdZ;
+	FloatLanes m_maxLength;
+};
+
+// Closest impact so far per lane, the user index lanes hold int bits
+struct PacketClosestHits
+{
+	FloatLanes m_impactDist;
+	FloatLanes m_normalX, m_normalY, m_normalZ;
+	FloatLanes m_userIndex;
+	FloatLanes m_didImpact;
+	FloatLanes m_maxLength; // also rejects start-inside impacts on unused lanes
+};
+
+static FloatLanes GetSafeInverse(FloatLanes value)
+{
+	// Axis-aligned rays would produce inf * 0 = NaN in the slab tests
+	FloatLanes magnitude = LanesMax(value, LanesNegate(value));
+	FloatLanes safeValue = LanesSelect(LanesLess(magnitude, LanesSet(LANE_NEAR_ZERO)), LanesSet(LANE_NEAR_ZERO), value);
+	return LanesDiv(LanesSet(1.f), safeValue);
+}
+
+static void UpdateClosestHits(PacketClosestHits& closest, FloatLanes isImpact, FloatLanes impactDist, FloatLanes normalX, FloatLanes normalY, FloatLanes normalZ, int userIndex)
+{
+	// First impact is taken as is, later ones only if strictly closer, like the scalar loop
+	FloatLanes isCloser = LanesOr(LanesLess(impactDist, closest.m_impactDist), LanesAndNot(closest.m_didImpact, isImpact));
+	FloatLanes isTaken = LanesAnd(LanesAnd(isImpact, isCloser), LanesLessEqual(impactDist, closest.m_maxLength));
+	if (!IsAnyLaneSet(isTaken))
+	{
+		return;
+	}
+
+	closest.m_impactDist = LanesSelect(isTaken, impactDist, closest.m_impactDist);
+	closest.m_normalX = LanesSelect(isTaken, normalX, closest.m_normalX);
+	closest.m_normalY = LanesSelect(isTaken, normalY, closest.m_normalY);
+	closest.m_normalZ = LanesSelect(isTaken, normalZ, closest.m_normalZ);
+	closest.m_userIndex = LanesSelect(isTaken, LanesSetIndex(userIndex), closest.m_userIndex);
+	closest.m_didImpact = LanesOr(closest.m_didImpact, isTaken);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Slab test against [mins, maxs] in whichever space start/inverseFwd are expressed
+// Writes the entry normal on the entering axis, or -fwd when the ray starts inside
+static FloatLanes RaycastSlabs(FloatLanes const start[3], FloatLanes const fwd[3], FloatLanes const inverseFwd[3], FloatLanes const mins[3], FloatLanes const maxs[3], FloatLanes maxLength, FloatLanes& out_impactDist, FloatLanes out_normal[3])
+{
+	FloatLanes nearDists[3];
+	FloatLanes enterDist = LanesSet(-LANE_FAR_DIST);
+	FloatLanes exitDist = LanesSet(LANE_FAR_DIST);
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		FloatLanes distA = LanesMul(LanesSub(mins[axis], start[axis]), inverseFwd[axis]);
+		FloatLanes distB = LanesMul(LanesSub(maxs[axis], start[axis]), inverseFwd[axis]);
+		nearDists[axis] = LanesMin(distA, distB);
+		enterDist = LanesMax(enterDist, nearDists[axis]);
+		exitDist = LanesMin(exitDist, LanesMax(distA, distB));
+	}
+
+	FloatLanes zero = LanesSet(0.f);
+	FloatLanes isInside = LanesAnd(LanesLess(enterDist, zero), LanesLess(zero, exitDist));
+	FloatLanes isEntering = LanesAnd(LanesLessEqual(enterDist, exitDist), LanesAnd(LanesLessEqual(zero, enterDist), LanesLessEqual(enterDist, maxLength)));
+
+	// The entering axis is the one whose near slab is furthest along the ray
+	FloatLanes isAxisX = LanesAnd(LanesLessEqual(nearDists[1], nearDists[0]), LanesLessEqual(nearDists[2], nearDists[0]));
+	FloatLanes isAxisY = LanesAndNot(isAxisX, LanesLessEqual(nearDists[2], nearDists[1]));
+	FloatLanes isAxisZ = LanesAndNot(LanesOr(isAxisX, isAxisY), LanesLessEqual(zero, zero));
+	FloatLanes const isAxis[3] = { isAxisX, isAxisY, isAxisZ };
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		FloatLanes facingNormal = LanesSelect(LanesLess(zero, fwd[axis]), LanesSet(-1.f), LanesSet(1.f));
+		FloatLanes entryNormal = LanesAnd(isAxis[axis], facingNormal);
+		out_normal[axis] = LanesSelect(isInside, LanesNegate(fwd[axis]), entryNormal);
+	}
+
+	out_impactDist = LanesSelect(isInside, zero, enterDist);
+	return LanesOr(isInside, isEntering);
+}
+
+//-----------------------------------------------------------------------------------------------
+RayPacket3D::RayPacket3D()
+{
+	for (int laneIndex = 0; laneIndex < RAY_PACKET_SIZE; ++laneIndex)
+	{
+		m_fwdX[laneIndex] = 1.f;
+		m_maxLength[laneIndex] = -1.f;
+	}
+}
+
+void RayPacket3D::SetRay(int laneIndex, Vec3 const& rayStart, Vec3 const& rayForwardNormal, float rayLength)
+{
+	m_startX[laneIndex] = rayStart.x;
+	m_startY[laneIndex] = rayStart.y;
+	m_startZ[laneIndex] = rayStart.z;
+	m_fwdX[laneIndex] = rayForwardNormal.x;
+	m_fwdY[laneIndex] = rayForwardNormal.y;
+	m_fwdZ[laneIndex] = rayForwardNormal.z;
+	m_maxLength[laneIndex] = rayLength;
+}
+
+//-----------------------------------------------------------------------------------------------
+RaycastResult3D RayPacketHits3D::GetRaycastResult(RayPacket3D const& rays, int laneIndex) const
+{
+	RaycastResult3D result;
+	result.m_rayStartPos = Vec3(rays.m_startX[laneIndex], rays.m_startY[laneIndex], rays.m_startZ[laneIndex]);
+	result.m_rayFwdNormal = Vec3(rays.m_fwdX[laneIndex], rays.m_fwdY[laneIndex], rays.m_fwdZ[laneIndex]);
+	result.m_rayMaxLength = rays.m_maxLength[laneIndex];
+	if (!DidImpact(laneIndex))
+	{
+		return result;
+	}
+
+	result.m_didImpact = true;
+	result.m_impactDist = m_impactDist[laneIndex];
+	result.m_impactPos = result.m_rayStartPos + result.m_rayFwdNormal * result.m_impactDist;
+	result.m_impactNormal = Vec3(m_impactNormalX[laneIndex], m_impactNormalY[laneIndex], m_impactNormalZ[laneIndex]);
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RaycastShapeSet3D::Clear()
+{
+	m_spheres = Spheres();
+	m_boxes = Boxes();
+	m_zCylinders = ZCylinders();
+	m_orientedBoxes = OrientedBoxes();
+	m_planes = Planes();
+}
+
+void RaycastShapeSet3D::AddSphere(Vec3 const& center, float radius, int userIndex)
+{
+	m_spheres.m_centerX.push_back(center.x);
+	m_spheres.m_centerY.push_back(center.y);
+	m_spheres.m_centerZ.push_back(center.z);
+	m_spheres.m_radius.push_back(radius);
+	m_spheres.m_userIndex.push_back(userIndex);
+}
+
+void RaycastShapeSet3D::AddAABB3(AABB3 const& bounds, int userIndex)
+{
+	m_boxes.m_minX.push_back(bounds.m_mins.x);
+	m_boxes.m_minY.push_back(bounds.m_mins.y);
+	m_boxes.m_minZ.push_back(bounds.m_mins.z);
+	m_boxes.m_maxX.push_back(bounds.m_maxs.x);
+	m_boxes.m_maxY.push_back(bounds.m_maxs.y);
+	m_boxes.m_maxZ.push_back(bounds.m_maxs.z);
+	m_boxes.m_userIndex.push_back(userIndex);
+}
+
+void RaycastShapeSet3D::AddZCylinder(Vec2 const& centerXY, FloatRange const& minMaxZ, float radius, int userIndex)
+{
+	m_zCylinders.m_centerX.push_back(centerXY.x);
+	m_zCylinders.m_centerY.push_back(centerXY.y);
+	m_zCylinders.m_minZ.push_back(minMaxZ.m_min);
+	m_zCylinders.m_maxZ.push_back(minMaxZ.m_max);
+	m_zCylinders.m_radius.push_back(radius);
+	m_zCylinders.m_userIndex.push_back(userIndex);
+}
+
+void RaycastShapeSet3D::AddOBB3(OBB3 const& box, int userIndex)
+{
+	m_orientedBoxes.m_centerX.push_back(box.m_center.x);
+	m_orientedBoxes.m_centerY.push_back(box.m_center.y);
+	m_orientedBoxes.m_centerZ.push_back(box.m_center.z);
+	m_orientedBoxes.m_iBasisX.push_back(box.m_iBasis.x);
+	m_orientedBoxes.m_iBasisY.push_back(box.m_iBasis.y);
+	m_orientedBoxes.m_iBasisZ.push_back(box.m_iBasis.z);
+	m_orientedBoxes.m_jBasisX.push_back(box.m_jBasis.x);
+	m_orientedBoxes.m_jBasisY.push_back(box.m_jBasis.y);
+	m_orientedBoxes.m_jBasisZ.push_back(box.m_jBasis.z);
+	m_orientedBoxes.m_kBasisX.push_back(box.m_kBasis.x);
+	m_orientedBoxes.m_kBasisY.push_back(box.m_kBasis.y);
+	m_orientedBoxes.m_kBasisZ.push_back(box.m_kBasis.z);
+	m_orientedBoxes.m_halfX.push_back(box.m_halfDimensions.x);
+	m_orientedBoxes.m_halfY.push_back(box.m_halfDimensions.y);
+	m_orientedBoxes.m_halfZ.push_back(box.m_halfDimensions.z);
+	m_orientedBoxes.m_userIndex.push_back(userIndex);
+}
+
+void RaycastShapeSet3D::AddPlane3(Plane3 const& plane, int userIndex)
+{
+	m_planes.m_normalX.push_back(plane.m_normal.x);
+	m_planes.m_normalY.push_back(plane.m_normal.y);
+	m_planes.m_normalZ.push_back(plane.m_normal.z);
+	m_planes.m_distFromOrigin.push_back(DotProduct3D(plane.GetNearestPoint(Vec3::ZERO), plane.m_normal));
+	m_planes.m_userIndex.push_back(userIndex);
+}
+
+int RaycastShapeSet3D::GetNumShapes() const
+{
+	return (int)(m_spheres.m_userIndex.size() + m_boxes.m_userIndex.size() + m_zCylinders.m_userIndex.size()
+		+ m_orientedBoxes.m_userIndex.size() + m_planes.m_userIndex.size());
+}
+
+//-----------------------------------------------------------------------------------------------
+void RaycastShapeSet3D::RaycastClosest(RayPacket3D const& rays, RayPacketHits3D& out_hits) const
+{
+	PacketRays packet;
+	packet.m_startX = LanesLoad(rays.m_startX);
+	packet.m_startY = LanesLoad(rays.m_startY);
+	packet.m_startZ = LanesLoad(rays.m_startZ);
+	packet.m_fwdX = LanesLoad(rays.m_fwdX);
+	packet.m_fwdY = LanesLoad(rays.m_fwdY);
+	packet.m_fwdZ = LanesLoad(rays.m_fwdZ);
+	packet.m_inverseFwdX = GetSafeInverse(packet.m_fwdX);
+	packet.m_inverseFwdY = GetSafeInverse(packet.m_fwdY);
+	packet.m_inverseFwdZ = GetSafeInverse(packet.m_fwdZ);
+	packet.m_maxLength = LanesLoad(rays.m_maxLength);
+
+	FloatLanes zero = LanesSet(0.f);
+	PacketClosestHits closest;
+	closest.m_impactDist = packet.m_maxLength;
+	closest.m_normalX = zero;
+	closest.m_normalY = zero;
+	closest.m_normalZ = zero;
+	closest.m_userIndex = LanesSetIndex(-1);
+	closest.m_didImpact = zero;
+	closest.m_maxLength = packet.m_maxLength;
+
+	// Spheres: closest approach along the ray, then back off by the half chord
+	for (int shapeIndex = 0; shapeIndex < (int)m_spheres.m_userIndex.size(); ++shapeIndex)
+	{
+		float radius = m_spheres.m_radius[shapeIndex];
+		FloatLanes radiusSquared = LanesSet(radius * radius);
+		FloatLanes toCenterX = LanesSub(LanesSet(m_spheres.m_centerX[shapeIndex]), packet.m_startX);
+		FloatLanes toCenterY = LanesSub(LanesSet(m_spheres.m_centerY[shapeIndex]), packet.m_startY);
+		FloatLanes toCenterZ = LanesSub(LanesSet(m_spheres.m_centerZ[shapeIndex]), packet.m_startZ);
+
+		FloatLanes centerDistSquared = LanesAdd(LanesAdd(LanesMul(toCenterX, toCenterX), LanesMul(toCenterY, toCenterY)), LanesMul(toCenterZ, toCenterZ));
+		FloatLanes alongRay = LanesAdd(LanesAdd(LanesMul(toCenterX, packet.m_fwdX), LanesMul(toCenterY, packet.m_fwdY)), LanesMul(toCenterZ, packet.m_fwdZ));
+		FloatLanes offRaySquared = LanesSub(centerDistSquared, LanesMul(alongRay, alongRay));
+		FloatLanes enterDist = LanesSub(alongRay, LanesSqrt(LanesMax(LanesSub(radiusSquared, offRaySquared), zero)));
+
+		FloatLanes isInside = LanesLess(centerDistSquared, radiusSquared);
+		FloatLanes isEntering = LanesAnd(LanesLessEqual(offRaySquared, radiusSquared), LanesAnd(LanesLessEqual(zero, enterDist), LanesLessEqual(enterDist, packet.m_maxLength)));
+		FloatLanes isImpact = LanesOr(isInside, isEntering);
+		if (!IsAnyLaneSet(isImpact))
+		{
+			continue;
+		}
+
+		FloatLanes impactDist = LanesSelect(isInside, zero, enterDist);
+		FloatLanes inverseRadius = LanesSet(1.f / radius);
+		FloatLanes normalX = LanesMul(LanesSub(LanesMul(packet.m_fwdX, impactDist), toCenterX), inverseRadius);
+		FloatLanes normalY = LanesMul(LanesSub(LanesMul(packet.m_fwdY, impactDist), toCenterY), inverseRadius);
+		FloatLanes normalZ = LanesMul(LanesSub(LanesMul(packet.m_fwdZ, impactDist), toCenterZ), inverseRadius);
+		normalX = LanesSelect(isInside, LanesNegate(packet.m_fwdX), normalX);
+		normalY = LanesSelect(isInside, LanesNegate(packet.m_fwdY), normalY);
+		normalZ = LanesSelect(isInside, LanesNegate(packet.m_fwdZ), normalZ);
+		UpdateClosestHits(closest, isImpact, impactDist, normalX, normalY, normalZ, m_spheres.m_userIndex[shapeIndex]);
+	}
+
+	// Axis aligned boxes
+	FloatLanes const start[3] = { packet.m_startX, packet.m_startY, packet.m_startZ };
+	FloatLanes const fwd[3] = { packet.m_fwdX, packet.m_fwdY, packet.m_fwdZ };
+	FloatLanes const inverseFwd[3] = { packet.m_inverseFwdX, packet.m_inverseFwdY, packet.m_inverseFwdZ };
+	for (int shapeIndex = 0; shapeIndex < (int)m_boxes.m_userIndex.size(); ++shapeIndex)
+	{
+		FloatLanes const boxMins[3] = { LanesSet(m_boxes.m_minX[shapeIndex]), LanesSet(m_boxes.m_minY[shapeIndex]), LanesSet(m_boxes.m_minZ[shapeIndex]) };
+		FloatLanes const boxMaxs[3] = { LanesSet(m_boxes.m_maxX[shapeIndex]), LanesSet(m_boxes.m_maxY[shapeIndex]), LanesSet(m_boxes.m_maxZ[shapeIndex]) };
+
+		FloatLanes impactDist;
+		FloatLanes normal[3];
+		FloatLanes isImpact = RaycastSlabs(start, fwd, inverseFwd, boxMins, boxMaxs, packet.m_maxLength, impactDist, normal);
+		if (IsAnyLaneSet(isImpact))
+		{
+			UpdateClosestHits(closest, isImpact, impactDist, normal[0], normal[1], normal[2], m_boxes.m_userIndex[shapeIndex]);
+		}
+	}
+
+	// Z cylinders: a disc interval in xy intersected with a slab interval in z
+	for (int shapeIndex = 0; shapeIndex < (int)m_zCylinders.m_userIndex.size(); ++shapeIndex)
+	{
+		float radius = m_zCylinders.m_radius[shapeIndex];
+		FloatLanes minZ = LanesSet(m_zCylinders.m_minZ[shapeIndex]);
+		FloatLanes maxZ = LanesSet(m_zCylinders.m_maxZ[shapeIndex]);
+		FloatLanes offsetX = LanesSub(packet.m_startX, LanesSet(m_zCylinders.m_centerX[shapeIndex]));
+		FloatLanes offsetY = LanesSub(packet.m_startY, LanesSet(m_zCylinders.m_centerY[shapeIndex]));
+
+		FloatLanes a = LanesAdd(LanesMul(packet.m_fwdX, packet.m_fwdX), LanesMul(packet.m_fwdY, packet.m_fwdY));
+		FloatLanes b = LanesAdd(LanesMul(offsetX, packet.m_fwdX), LanesMul(offsetY, packet.m_fwdY));
+		FloatLanes c = LanesSub(LanesAdd(LanesMul(offsetX, offsetX), LanesMul(offsetY, offsetY)), LanesSet(radius * radius));
+		FloatLanes discriminant = LanesSub(LanesMul(b, b), LanesMul(a, c));
+
+		// Vertical rays never cross the side, they are inside the disc for all distances or never
+		FloatLanes isVertical = LanesLess(a, LanesSet(LANE_NEAR_ZERO));
+		FloatLanes safeA = LanesSelect(isVertical, LanesSet(1.f), a);
+		FloatLanes rootDist = LanesSqrt(LanesMax(discriminant, zero));
+		FloatLanes discEnterDist = LanesSelect(isVertical, LanesSet(-LANE_FAR_DIST), LanesDiv(LanesNegate(LanesAdd(b, rootDist)), safeA));
+		FloatLanes discExitDist = LanesSelect(isVertical, LanesSet(LANE_FAR_DIST), LanesDiv(LanesSub(rootDist, b), safeA));
+		FloatLanes isCrossingDisc = LanesSelect(isVertical, LanesLessEqual(c, zero), LanesLessEqual(zero, discriminant));
+
+		FloatLanes slabDistA = LanesMul(LanesSub(minZ, packet.m_startZ), packet.m_inverseFwdZ);
+		FloatLanes slabDistB = LanesMul(LanesSub(maxZ, packet.m_startZ), packet.m_inverseFwdZ);
+		FloatLanes slabEnterDist = LanesMin(slabDistA, slabDistB);
+		FloatLanes slabExitDist = LanesMax(slabDistA, slabDistB);
+
+		FloatLanes enterDist = LanesMax(discEnterDist, slabEnterDist);
+		FloatLanes exitDist = LanesMin(discExitDist, slabExitDist);
+		FloatLanes isInside = LanesAnd(LanesLess(c, zero), LanesAnd(LanesLess(minZ, packet.m_startZ), LanesLess(packet.m_startZ, maxZ)));
+		FloatLanes isEntering = LanesAnd(isCrossingDisc, LanesAnd(LanesLessEqual(enterDist, exitDist), LanesAnd(LanesLessEqual(zero, enterDist), LanesLessEqual(enterDist, packet.m_maxLength))));
+		FloatLanes isImpact = LanesOr(isInside, isEntering);
+		if (!IsAnyLaneSet(isImpact))
+		{
+			continue;
+		}
+
+		FloatLanes impactDist = LanesSelect(isInside, zero, enterDist);
+		FloatLanes isEnteringCap = LanesLessEqual(discEnterDist, slabEnterDist);
+		FloatLanes inverseRadius = LanesSet(1.f / radius);
+		FloatLanes sideNormalX = LanesMul(LanesAdd(offsetX, LanesMul(packet.m_fwdX, impactDist)), inverseRadius);
+		FloatLanes sideNormalY = LanesMul(LanesAdd(offsetY, LanesMul(packet.m_fwdY, impactDist)), inverseRadius);
+		FloatLanes capNormalZ = LanesSelect(LanesLess(zero, packet.m_fwdZ), LanesSet(-1.f), LanesSet(1.f));
+
+		FloatLanes normalX = LanesSelect(isEnteringCap, zero, sideNormalX);
+		FloatLanes normalY = LanesSelect(isEnteringCap, zero, sideNormalY);
+		FloatLanes normalZ = LanesSelect(isEnteringCap, capNormalZ, zero);
+		normalX = LanesSelect(isInside, LanesNegate(packet.m_fwdX), normalX);
+		normalY = LanesSelect(isInside, LanesNegate(packet.m_fwdY), normalY);
+		normalZ = LanesSelect(isInside, LanesNegate(packet.m_fwdZ), normalZ);
+		UpdateClosestHits(closest, isImpact, impactDist, normalX, normalY, normalZ, m_zCylinders.m_userIndex[shapeIndex]);
+	}
+
+	// Oriented boxes: the rays are moved into box space, then slab tested against the half dimensions
+	for (int shapeIndex = 0; shapeIndex < (int)m_orientedBoxes.m_userIndex.size(); ++shapeIndex)
+	{
+		OrientedBoxes const& boxes = m_orientedBoxes;
+		FloatLanes const basisX[3] = { LanesSet(boxes.m_iBasisX[shapeIndex]), LanesSet(boxes.m_jBasisX[shapeIndex]), LanesSet(boxes.m_kBasisX[shapeIndex]) };
+		FloatLanes const basisY[3] = { LanesSet(boxes.m_iBasisY[shapeIndex]), LanesSet(boxes.m_jBasisY[shapeIndex]), LanesSet(boxes.m_kBasisY[shapeIndex]) };
+		FloatLanes const basisZ[3] = { LanesSet(boxes.m_iBasisZ[shapeIndex]), LanesSet(boxes.m_jBasisZ[shapeIndex]), LanesSet(boxes.m_kBasisZ[shapeIndex]) };
+		FloatLanes offsetX = LanesSub(packet.m_startX, LanesSet(boxes.m_centerX[shapeIndex]));
+		FloatLanes offsetY = LanesSub(packet.m_startY, LanesSet(boxes.m_centerY[shapeIndex]));
+		FloatLanes offsetZ = LanesSub(packet.m_startZ, LanesSet(boxes.m_centerZ[shapeIndex]));
+
+		FloatLanes localStart[3];
+		FloatLanes localFwd[3];
+		FloatLanes localInverseFwd[3];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			localStart[axis] = LanesAdd(LanesAdd(LanesMul(offsetX, basisX[axis]), LanesMul(offsetY, basisY[axis])), LanesMul(offsetZ, basisZ[axis]));
+			localFwd[axis] = LanesAdd(LanesAdd(LanesMul(packet.m_fwdX, basisX[axis]), LanesMul(packet.m_fwdY, basisY[axis])), LanesMul(packet.m_fwdZ, basisZ[axis]));
+			localInverseFwd[axis] = GetSafeInverse(localFwd[axis]);
+		}
+		FloatLanes const halfDimensions[3] = { LanesSet(boxes.m_halfX[shapeIndex]), LanesSet(boxes.m_halfY[shapeIndex]), LanesSet(boxes.m_halfZ[shapeIndex]) };
+		FloatLanes const localMins[3] = { LanesNegate(halfDimensions[0]), LanesNegate(halfDimensions[1]), LanesNegate(halfDimensions[2]) };
+
+		FloatLanes impactDist;
+		FloatLanes localNormal[3];
+		FloatLanes isImpact = RaycastSlabs(localStart, localFwd, localInverseFwd, localMins, halfDimensions, packet.m_maxLength, impactDist, localNormal);
+		if (!IsAnyLaneSet(isImpact))
+		{
+			continue;
+		}
+
+		// Back to world space, the inside case -localFwd maps back to -fwd as well
+		FloatLanes normalX = LanesAdd(LanesAdd(LanesMul(localNormal[0], basisX[0]), LanesMul(localNormal[1], basisX[1])), LanesMul(localNormal[2], basisX[2]));
+		FloatLanes normalY = LanesAdd(LanesAdd(LanesMul(localNormal[0], basisY[0]), LanesMul(localNormal[1], basisY[1])), LanesMul(localNormal[2], basisY[2]));
+		FloatLanes normalZ = LanesAdd(LanesAdd(LanesMul(localNormal[0], basisZ[0]), LanesMul(localNormal[1], basisZ[1])), LanesMul(localNormal[2], basisZ[2]));
+		UpdateClosestHits(closest, isImpact, impactDist, normalX, normalY, normalZ, boxes.m_userIndex[shapeIndex]);
+	}
+
+	// Planes are two sided, the normal faces back toward the ray start
+	for (int shapeIndex = 0; shapeIndex < (int)m_planes.m_userIndex.size(); ++shapeIndex)
+	{
+		FloatLanes normalX = LanesSet(m_planes.m_normalX[shapeIndex]);
+		FloatLanes normalY = LanesSet(m_planes.m_normalY[shapeIndex]);
+		FloatLanes normalZ = LanesSet(m_planes.m_normalZ[shapeIndex]);
+		FloatLanes startAltitude = LanesSub(LanesAdd(LanesAdd(LanesMul(packet.m_startX, normalX), LanesMul(packet.m_startY, normalY)), LanesMul(packet.m_startZ, normalZ)), LanesSet(m_planes.m_distFromOrigin[shapeIndex]));
+		FloatLanes fwdAltitude = LanesAdd(LanesAdd(LanesMul(packet.m_fwdX, normalX), LanesMul(packet.m_fwdY, normalY)), LanesMul(packet.m_fwdZ, normalZ));
+
+		FloatLanes fwdMagnitude = LanesMax(fwdAltitude, LanesNegate(fwdAltitude));
+		FloatLanes isParallel = LanesLess(fwdMagnitude, LanesSet(LANE_NEAR_ZERO));
+		FloatLanes impactDist = LanesDiv(LanesNegate(startAltitude), LanesSelect(isParallel, LanesSet(1.f), fwdAltitude));
+		FloatLanes isImpact = LanesAndNot(isParallel, LanesAnd(LanesLessEqual(zero, impactDist), LanesLessEqual(impactDist, packet.m_maxLength)));
+		if (!IsAnyLaneSet(isImpact))
+		{
+			continue;
+		}
+
+		FloatLanes isAbove = LanesLess(zero, startAltitude);
+		normalX = LanesSelect(isAbove, normalX, LanesNegate(normalX));
+		normalY = LanesSelect(isAbove, normalY, LanesNegate(normalY));
+		normalZ = LanesSelect(isAbove, normalZ, LanesNegate(normalZ));
+		UpdateClosestHits(closest, isImpact, impactDist, normalX, normalY, normalZ, m_planes.m_userIndex[shapeIndex]);
+	}
+
+	LanesStore(out_hits.m_impactDist, closest.m_impactDist);
+	LanesStore(out_hits.m_impactNormalX, closest.m_normalX);
+	LanesStore(out_hits.m_impactNormalY, closest.m_normalY);
+	LanesStore(out_hits.m_impactNormalZ, closest.m_normalZ);
+	LanesStoreIndexes(out_hits.m_userIndex, closest.m_userIndex);
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "Game/FloatLanes.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/FloatRange.hpp"
+#include "Engine/Math/OBB3.hpp"
+#include "Engine/Math/Plane3.hpp"
+#include "Engine/Math/RaycastUtils.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// One ray per SIMD lane: 8 with AVX enabled (/arch:AVX), 4 with SSE otherwise
+constexpr int RAY_PACKET_SIZE = FLOAT_LANE_COUNT;
+
+
+//-----------------------------------------------------------------------------------------------
+struct RayPacket3D
+{
+	alignas(32) float m_startX[RAY_PACKET_SIZE] = {};
+	alignas(32) float m_startY[RAY_PACKET_SIZE] = {};
+	alignas(32) float m_startZ[RAY_PACKET_SIZE] = {};
+	alignas(32) float m_fwdX[RAY_PACKET_SIZE] = {};
+	alignas(32) float m_fwdY[RAY_PACKET_SIZE] = {};
+	alignas(32) float m_fwdZ[RAY_PACKET_SIZE] = {};
+	alignas(32) float m_maxLength[RAY_PACKET_SIZE] = {}; // unused lanes keep a negative length and never hit
+
+	RayPacket3D();
+	void SetRay(int laneIndex, Vec3 const& rayStart, Vec3 const& rayForwardNormal, float rayLength);
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct RayPacketHits3D
+{
+	alignas(32) float m_impactDist[RAY_PACKET_SIZE] = {};
+	alignas(32) float m_impactNormalX[RAY_PACKET_SIZE] = {};
+	alignas(32) float m_impactNormalY[RAY_PACKET_SIZE] = {};
+	alignas(32) float m_impactNormalZ[RAY_PACKET_SIZE] = {};
+	int m_userIndex[RAY_PACKET_SIZE] = {}; // -1 on a miss
+
+	bool DidImpact(int laneIndex) const { return m_userIndex[laneIndex] != -1; }
+	RaycastResult3D GetRaycastResult(RayPacket3D const& rays, int laneIndex) const;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Raycast targets stored as one structure of arrays per shape type
+// A packet is traced against every shape of every type, each shape is broadcast across the ray lanes
+class RaycastShapeSet3D
+{
+public:
+	void Clear();
+	void AddSphere(Vec3 const& center, float radius, int userIndex);
+	void AddAABB3(AABB3 const& bounds, int userIndex);
+	void AddZCylinder(Vec2 const& centerXY, FloatRange const& minMaxZ, float radius, int userIndex);
+	void AddOBB3(OBB3 const& box, int userIndex);
+	void AddPlane3(Plane3 const& plane, int userIndex);
+
+	int GetNumShapes() const;
+
+	// Closest impact per lane over all shapes, same conventions as the scalar RaycastVs*3D functions
+	void RaycastClosest(RayPacket3D const& rays, RayPacketHits3D& out_hits) const;
+
+private:
+	struct Spheres
+	{
+		std::vector<float> m_centerX, m_centerY, m_centerZ, m_radius;
+		std::vector<int> m_userIndex;
+	} m_spheres;
+
+	struct Boxes
+	{
+		std::vector<float> m_minX, m_minY, m_minZ, m_maxX, m_maxY, m_maxZ;
+		std::vector<int> m_userIndex;
+	} m_boxes;
+
+	struct ZCylinders
+	{
+		std::vector<float> m_centerX, m_centerY, m_minZ, m_maxZ, m_radius;
+		std::vector<int> m_userIndex;
+	} m_zCylinders;
+
+	struct OrientedBoxes
+	{
+		std::vector<float> m_centerX, m_centerY, m_centerZ;
+		std::vector<float> m_iBasisX, m_iBasisY, m_iBasisZ;
+		std::vector<float> m_jBasisX, m_jBasisY, m_jBasisZ;
+		std::vector<float> m_kBasisX, m_kBasisY, m_kBasisZ;
+		std::vector<float> m_halfX, m_halfY, m_halfZ;
+		std::vector<int> m_userIndex;
+	} m_orientedBoxes;
+
+	struct Planes
+	{
+		std::vector<float> m_normalX, m_normalY, m_normalZ, m_distFromOrigin;
+		std::vector<int> m_userIndex;
+	} m_planes;
+};
@@ -0,0 +1,492 @@
+#include "Game/RaycastScene2D.hpp"
+#include "Game/FloatLanes.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+//-----------------------------------------------------------------------------------------------
+static constexpr float SCENE_NEAR_ZERO = 1e-20f;
+static constexpr float SCENE_FAR_POSITION = 1e30f;
+
+static int GetPaddedSize(int numShapes)
+{
+	return ((numShapes + FLOAT_LANE_COUNT - 1) / FLOAT_LANE_COUNT) * FLOAT_LANE_COUNT;
+}
+
+// Closest impact so far per lane, the index lanes hold int bits
+struct SceneClosestLanes
+{
+	FloatLanes m_impactDist;
+	FloatLanes m_shapeIndex;
+	FloatLanes m_didImpact;
+
+	explicit SceneClosestLanes(float rayLength)
+		: m_impactDist(LanesSet(rayLength))
+		, m_shapeIndex(LanesSetIndex(-1))
+		, m_didImpact(LanesSet(0.f))
+	{
+	}
+
+	void Update(FloatLanes isImpact, FloatLanes impactDist, int firstShapeIndex)
+	{
+		// Per lane, shapes come in increasing index order, so strictly closer keeps the first of equal hits
+		FloatLanes isCloser = LanesOr(LanesLess(impactDist, m_impactDist), LanesAndNot(m_didImpact, isImpact));
+		FloatLanes isTaken = LanesAnd(isImpact, isCloser);
+		m_impactDist = LanesSelect(isTaken, impactDist, m_impactDist);
+		m_shapeIndex = LanesSelect(isTaken, LanesSetIndexSequence(firstShapeIndex), m_shapeIndex);
+		m_didImpact = LanesOr(m_didImpact, isTaken);
+	}
+
+	RaycastSceneHit2D GetClosestHit() const
+	{
+		alignas(32) float impactDists[FLOAT_LANE_COUNT];
+		int shapeIndexes[FLOAT_LANE_COUNT];
+		LanesStore(impactDists, m_impactDist);
+		LanesStoreIndexes(shapeIndexes, m_shapeIndex);
+
+		RaycastSceneHit2D closestHit;
+		for (int laneIndex = 0; laneIndex < FLOAT_LANE_COUNT; ++laneIndex)
+		{
+			int shapeIndex = shapeIndexes[laneIndex];
+			if (shapeIndex == -1)
+			{
+				continue;
+			}
+			float impactDist = impactDists[laneIndex];
+			if (!closestHit.DidImpact() || impactDist < closestHit.m_impactDist
+				|| (impactDist == closestHit.m_impactDist && shapeIndex < closestHit.m_shapeIndex))
+			{
+				closestHit.m_shapeIndex = shapeIndex;
+				closestHit.m_impactDist = impactDist;
+			}
+		}
+		return closestHit;
+	}
+};
+
+static FloatLanes GetSafeInverse(float value)
+{
+	// Axis-aligned rays would produce inf * 0 = NaN in the slab tests
+	float safeValue = (fabsf(value) < SCENE_NEAR_ZERO) ? SCENE_NEAR_ZERO : value;
+	return LanesSet(1.f / safeValue);
+}
+
+static FloatLanes GetSafeInverseLanes(FloatLanes value)
+{
+	FloatLanes magnitude = LanesMax(value, LanesNegate(value));
+	FloatLanes safeValue = LanesSelect(LanesLess(magnitude, LanesSet(SCENE_NEAR_ZERO)), LanesSet(SCENE_NEAR_ZERO), value);
+	return LanesDiv(LanesSet(1.f), safeValue);
+}
+
+// One ray per lane for the multi-ray kernels, each shape is broadcast across the packet
+struct ScenePacketRays
+{
+	FloatLanes m_startX, m_startY;
+	FloatLanes m_fwdX, m_fwdY;
+	FloatLanes m_inverseFwdX, m_inverseFwdY;
+	FloatLanes m_maxLength;
+};
+
+// Closest impact so far per ray lane, the index lanes hold int bits
+struct ScenePacketClosestHits
+{
+	FloatLanes m_impactDist;
+	FloatLanes m_shapeIndex;
+	FloatLanes m_didImpact;
+
+	explicit ScenePacketClosestHits(FloatLanes maxLength)
+		: m_impactDist(maxLength)
+		, m_shapeIndex(LanesSetIndex(-1))
+		, m_didImpact(LanesSet(0.f))
+	{
+	}
+
+	void Update(FloatLanes isImpact, FloatLanes impactDist, int shapeIndex)
+	{
+		// Shapes come in increasing index order, so strictly closer keeps the first of equal hits like the single ray kernels
+		FloatLanes isCloser = LanesOr(LanesLess(impactDist, m_impactDist), LanesAndNot(m_didImpact, isImpact));
+		FloatLanes isTaken = LanesAnd(isImpact, isCloser);
+		m_impactDist = LanesSelect(isTaken, impactDist, m_impactDist);
+		m_shapeIndex = LanesSelect(isTaken, LanesSetIndex(shapeIndex), m_shapeIndex);
+		m_didImpact = LanesOr(m_didImpact, isTaken);
+	}
+};
+
+// Rays are gathered into packets of FLOAT_LANE_COUNT, a short last packet repeats its last ray and drops those lanes on store.
+// raycastPacket(packetRays, closestHits) runs every shape against the packet, so the shape arrays stream once per packet instead of once per ray.
+template<typename RaycastPacketFunction>
+static void RaycastClosestInRayPackets(int numRays, Vec2 const* rayStarts, Vec2 const* rayForwardNormals, float const* rayLengths, RaycastSceneHit2D* out_hits,
+	RaycastPacketFunction const& raycastPacket)
+{
+	alignas(32) float laneValues[5][FLOAT_LANE_COUNT]; // start xy, fwd xy, length
+	alignas(32) float impactDists[FLOAT_LANE_COUNT];
+	int shapeIndexes[FLOAT_LANE_COUNT];
+
+	for (int firstRayIndex = 0; firstRayIndex < numRays; firstRayIndex += FLOAT_LANE_COUNT)
+	{
+		int numPacketRays = (numRays - firstRayIndex < FLOAT_LANE_COUNT) ? numRays - firstRayIndex : FLOAT_LANE_COUNT;
+		for (int laneIndex = 0; laneIndex < FLOAT_LANE_COUNT; ++laneIndex)
+		{
+			int rayIndex = firstRayIndex + ((laneIndex < numPacketRays) ? laneIndex : numPacketRays - 1);
+			laneValues[0][laneIndex] = rayStarts[rayIndex].x;
+			laneValues[1][laneIndex] = rayStarts[rayIndex].y;
+			laneValues[2][laneIndex] = rayForwardNormals[rayIndex].x;
+			laneValues[3][laneIndex] = rayForwardNormals[rayIndex].y;
+			laneValues[4][laneIndex] = rayLengths[rayIndex];
+		}
+
+		ScenePacketRays rays;
+		rays.m_startX = LanesLoad(laneValues[0]);
+		rays.m_startY = LanesLoad(laneValues[1]);
+		rays.m_fwdX = LanesLoad(laneValues[2]);
+		rays.m_fwdY = LanesLoad(laneValues[3]);
+		rays.m_inverseFwdX = GetSafeInverseLanes(rays.m_fwdX);
+		rays.m_inverseFwdY = GetSafeInverseLanes(rays.m_fwdY);
+		rays.m_maxLength = LanesLoad(laneValues[4]);
+
+		ScenePacketClosestHits closest(rays.m_maxLength);
+		raycastPacket(rays, closest);
+
+		LanesStore(impactDists, closest.m_impactDist);
+		LanesStoreIndexes(shapeIndexes, closest.m_shapeIndex);
+		for (int laneIndex = 0; laneIndex < numPacketRays; ++laneIndex)
+		{
+			RaycastSceneHit2D& hit = out_hits[firstRayIndex + laneIndex];
+			hit.m_shapeIndex = shapeIndexes[laneIndex];
+			hit.m_impactDist = (hit.m_shapeIndex == -1) ? 0.f : impactDists[laneIndex];
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void DiscRaycastScene2D::Clear()
+{
+	m_centerX.clear();
+	m_centerY.clear();
+	m_radiusSquared.clear();
+	m_radius.clear();
+	m_numShapes = 0;
+}
+
+void DiscRaycastScene2D::Reserve(int numDiscs)
+{
+	int paddedSize = GetPaddedSize(numDiscs);
+	m_centerX.reserve(paddedSize);
+	m_centerY.reserve(paddedSize);
+	m_radiusSquared.reserve(paddedSize);
+	m_radius.reserve(paddedSize);
+}
+
+int DiscRaycastScene2D::AddDisc(Vec2 const& center, float radius)
+{
+	int shapeIndex = m_numShapes++;
+	if (shapeIndex == (int)m_centerX.size())
+	{
+		int paddedSize = GetPaddedSize(m_numShapes);
+		m_centerX.resize(paddedSize, 0.f);
+		m_centerY.resize(paddedSize, 0.f);
+		m_radiusSquared.resize(paddedSize, -1.f);
+		m_radius.resize(paddedSize, 0.f);
+	}
+
+	m_centerX[shapeIndex] = center.x;
+	m_centerY[shapeIndex] = center.y;
+	m_radiusSquared[shapeIndex] = radius * radius;
+	m_radius[shapeIndex] = radius;
+	return shapeIndex;
+}
+
+RaycastSceneHit2D DiscRaycastScene2D::RaycastClosest(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const
+{
+	FloatLanes startX = LanesSet(rayStart.x);
+	FloatLanes startY = LanesSet(rayStart.y);
+	FloatLanes fwdX = LanesSet(rayForwardNormal.x);
+	FloatLanes fwdY = LanesSet(rayForwardNormal.y);
+	FloatLanes maxLength = LanesSet(rayLength);
+	FloatLanes zero = LanesSet(0.f);
+
+	SceneClosestLanes closest(rayLength);
+	for (int firstIndex = 0; firstIndex < (int)m_centerX.size(); firstIndex += FLOAT_LANE_COUNT)
+	{
+		FloatLanes toCenterX = LanesSub(LanesLoadUnaligned(&m_centerX[firstIndex]), startX);
+		FloatLanes toCenterY = LanesSub(LanesLoadUnaligned(&m_centerY[firstIndex]), startY);
+		FloatLanes radiusSquared = LanesLoadUnaligned(&m_radiusSquared[firstIndex]);
+
+		FloatLanes centerDistSquared = LanesAdd(LanesMul(toCenterX, toCenterX), LanesMul(toCenterY, toCenterY));
+		FloatLanes alongRay = LanesAdd(LanesMul(toCenterX, fwdX), LanesMul(toCenterY, fwdY));
+		FloatLanes offRaySquared = LanesSub(centerDistSquared, LanesMul(alongRay, alongRay));
+		FloatLanes enterDist = LanesSub(alongRay, LanesSqrt(LanesMax(LanesSub(radiusSquared, offRaySquared), zero)));
+
+		FloatLanes isInside = LanesLess(centerDistSquared, radiusSquared);
+		FloatLanes isEntering = LanesAnd(LanesLessEqual(offRaySquared, radiusSquared), LanesAnd(LanesLessEqual(zero, enterDist), LanesLessEqual(enterDist, maxLength)));
+		FloatLanes isImpact = LanesOr(isInside, isEntering);
+		if (IsAnyLaneSet(isImpact))
+		{
+			closest.Update(isImpact, LanesSelect(isInside, zero, enterDist), firstIndex);
+		}
+	}
+	return closest.GetClosestHit();
+}
+
+void DiscRaycastScene2D::RaycastClosest(int numRays, Vec2 const* rayStarts, Vec2 const* rayForwardNormals, float const* rayLengths, RaycastSceneHit2D* out_hits) const
+{
+	auto raycastPacket = [this](ScenePacketRays const& rays, ScenePacketClosestHits& closest)
+		{
+			FloatLanes zero = LanesSet(0.f);
+			for (int shapeIndex = 0; shapeIndex < m_numShapes; ++shapeIndex)
+			{
+				FloatLanes toCenterX = LanesSub(LanesSet(m_centerX[shapeIndex]), rays.m_startX);
+				FloatLanes toCenterY = LanesSub(LanesSet(m_centerY[shapeIndex]), rays.m_startY);
+				FloatLanes radiusSquared = LanesSet(m_radiusSquared[shapeIndex]);
+
+				FloatLanes centerDistSquared = LanesAdd(LanesMul(toCenterX, toCenterX), LanesMul(toCenterY, toCenterY));
+				FloatLanes alongRay = LanesAdd(LanesMul(toCenterX, rays.m_fwdX), LanesMul(toCenterY, rays.m_fwdY));
+				FloatLanes offRaySquared = LanesSub(centerDistSquared, LanesMul(alongRay, alongRay));
+				FloatLanes enterDist = LanesSub(alongRay, LanesSqrt(LanesMax(LanesSub(radiusSquared, offRaySquared), zero)));
+
+				FloatLanes isInside = LanesLess(centerDistSquared, radiusSquared);
+				FloatLanes isEntering = LanesAnd(LanesLessEqual(offRaySquared, radiusSquared), LanesAnd(LanesLessEqual(zero, enterDist), LanesLessEqual(enterDist, rays.m_maxLength)));
+				FloatLanes isImpact = LanesOr(isInside, isEntering);
+				if (IsAnyLaneSet(isImpact))
+				{
+					closest.Update(isImpact, LanesSelect(isInside, zero, enterDist), shapeIndex);
+				}
+			}
+		};
+	RaycastClosestInRayPackets(numRays, rayStarts, rayForwardNormals, rayLengths, out_hits, raycastPacket);
+}
+
+RaycastResult2D DiscRaycastScene2D::GetRaycastResult(RaycastSceneHit2D const& hit, Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const
+{
+	if (!hit.DidImpact())
+	{
+		return RaycastResult2D();
+	}
+	Vec2 center(m_centerX[hit.m_shapeIndex], m_centerY[hit.m_shapeIndex]);
+	return RaycastVsDisc2D(rayStart, rayForwardNormal, rayLength, center, m_radius[hit.m_shapeIndex]);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void LineSegmentRaycastScene2D::Clear()
+{
+	m_startX.clear();
+	m_startY.clear();
+	m_endX.clear();
+	m_endY.clear();
+	m_numShapes = 0;
+}
+
+void LineSegmentRaycastScene2D::Reserve(int numSegments)
+{
+	int paddedSize = GetPaddedSize(numSegments);
+	m_startX.reserve(paddedSize);
+	m_startY.reserve(paddedSize);
+	m_endX.reserve(paddedSize);
+	m_endY.reserve(paddedSize);
+}
+
+int LineSegmentRaycastScene2D::AddLineSegment(Vec2 const& start, Vec2 const& end)
+{
+	int shapeIndex = m_numShapes++;
+	if (shapeIndex == (int)m_startX.size())
+	{
+		int paddedSize = GetPaddedSize(m_numShapes);
+		m_startX.resize(paddedSize, 0.f);
+		m_startY.resize(paddedSize, 0.f);
+		m_endX.resize(paddedSize, 0.f);
+		m_endY.resize(paddedSize, 0.f);
+	}
+
+	m_startX[shapeIndex] = start.x;
+	m_startY[shapeIndex] = start.y;
+	m_endX[shapeIndex] = end.x;
+	m_endY[shapeIndex] = end.y;
+	return shapeIndex;
+}
+
+RaycastSceneHit2D LineSegmentRaycastScene2D::RaycastClosest(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const
+{
+	FloatLanes startX = LanesSet(rayStart.x);
+	FloatLanes startY = LanesSet(rayStart.y);
+	FloatLanes fwdX = LanesSet(rayForwardNormal.x);
+	FloatLanes fwdY = LanesSet(rayForwardNormal.y);
+	FloatLanes maxLength = LanesSet(rayLength);
+	FloatLanes zero = LanesSet(0.f);
+	FloatLanes one = LanesSet(1.f);
+	FloatLanes nearZero = LanesSet(SCENE_NEAR_ZERO);
+
+	// start + t * fwd = segmentStart + u * segmentDisp, solved with 2D cross products
+	SceneClosestLanes closest(rayLength);
+	for (int firstIndex = 0; firstIndex < (int)m_startX.size(); firstIndex += FLOAT_LANE_COUNT)
+	{
+		FloatLanes segmentStartX = LanesLoadUnaligned(&m_startX[firstIndex]);
+		FloatLanes segmentStartY = LanesLoadUnaligned(&m_startY[firstIndex]);
+		FloatLanes segmentDispX = LanesSub(LanesLoadUnaligned(&m_endX[firstIndex]), segmentStartX);
+		FloatLanes segmentDispY = LanesSub(LanesLoadUnaligned(&m_endY[firstIndex]), segmentStartY);
+		FloatLanes toSegmentX = LanesSub(segmentStartX, startX);
+		FloatLanes toSegmentY = LanesSub(segmentStartY, startY);
+
+		FloatLanes denominator = LanesSub(LanesMul(fwdX, segmentDispY), LanesMul(fwdY, segmentDispX));
+		FloatLanes isParallel = LanesLess(LanesMax(denominator, LanesNegate(denominator)), nearZero);
+		FloatLanes inverseDenominator = LanesDiv(one, LanesSelect(isParallel, one, denominator));
+		FloatLanes impactDist = LanesMul(LanesSub(LanesMul(toSegmentX, segmentDispY), LanesMul(toSegmentY, segmentDispX)), inverseDenominator);
+		FloatLanes segmentFraction = LanesMul(LanesSub(LanesMul(toSegmentX, fwdY), LanesMul(toSegmentY, fwdX)), inverseDenominator);
+
+		FloatLanes isOnRay = LanesAnd(LanesLessEqual(zero, impactDist), LanesLessEqual(impactDist, maxLength));
+		FloatLanes isOnSegment = LanesAnd(LanesLessEqual(zero, segmentFraction), LanesLessEqual(segmentFraction, one));
+		FloatLanes isImpact = LanesAndNot(isParallel, LanesAnd(isOnRay, isOnSegment));
+		if (IsAnyLaneSet(isImpact))
+		{
+			closest.Update(isImpact, impactDist, firstIndex);
+		}
+	}
+	return closest.GetClosestHit();
+}
+
+void LineSegmentRaycastScene2D::RaycastClosest(int numRays, Vec2 const* rayStarts, Vec2 const* rayForwardNormals, float const* rayLengths, RaycastSceneHit2D* out_hits) const
+{
+	auto raycastPacket = [this](ScenePacketRays const& rays, ScenePacketClosestHits& closest)
+		{
+			FloatLanes zero = LanesSet(0.f);
+			FloatLanes one = LanesSet(1.f);
+			FloatLanes nearZero = LanesSet(SCENE_NEAR_ZERO);
+			for (int shapeIndex = 0; shapeIndex < m_numShapes; ++shapeIndex)
+			{
+				FloatLanes segmentDispX = LanesSet(m_endX[shapeIndex] - m_startX[shapeIndex]);
+				FloatLanes segmentDispY = LanesSet(m_endY[shapeIndex] - m_startY[shapeIndex]);
+				FloatLanes toSegmentX = LanesSub(LanesSet(m_startX[shapeIndex]), rays.m_startX);
+				FloatLanes toSegmentY = LanesSub(LanesSet(m_startY[shapeIndex]), rays.m_startY);
+
+				FloatLanes denominator = LanesSub(LanesMul(rays.m_fwdX, segmentDispY), LanesMul(rays.m_fwdY, segmentDispX));
+				FloatLanes isParallel = LanesLess(LanesMax(denominator, LanesNegate(denominator)), nearZero);
+				FloatLanes inverseDenominator = LanesDiv(one, LanesSelect(isParallel, one, denominator));
+				FloatLanes impactDist = LanesMul(LanesSub(LanesMul(toSegmentX, segmentDispY), LanesMul(toSegmentY, segmentDispX)), inverseDenominator);
+				FloatLanes segmentFraction = LanesMul(LanesSub(LanesMul(toSegmentX, rays.m_fwdY), LanesMul(toSegmentY, rays.m_fwdX)), inverseDenominator);
+
+				FloatLanes isOnRay = LanesAnd(LanesLessEqual(zero, impactDist), LanesLessEqual(impactDist, rays.m_maxLength));
+				FloatLanes isOnSegment = LanesAnd(LanesLessEqual(zero, segmentFraction), LanesLessEqual(segmentFraction, one));
+				FloatLanes isImpact = LanesAndNot(isParallel, LanesAnd(isOnRay, isOnSegment));
+				if (IsAnyLaneSet(isImpact))
+				{
+					closest.Update(isImpact, impactDist, shapeIndex);
+				}
+			}
+		};
+	RaycastClosestInRayPackets(numRays, rayStarts, rayForwardNormals, rayLengths, out_hits, raycastPacket);
+}
+
+RaycastResult2D LineSegmentRaycastScene2D::GetRaycastResult(RaycastSceneHit2D const& hit, Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const
+{
+	if (!hit.DidImpact())
+	{
+		return RaycastResult2D();
+	}
+	Vec2 start(m_startX[hit.m_shapeIndex], m_startY[hit.m_shapeIndex]);
+	Vec2 end(m_endX[hit.m_shapeIndex], m_endY[hit.m_shapeIndex]);
+	return RaycastVsLineSegment2D(rayStart, rayForwardNormal, rayLength, start, end);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void AABB2RaycastScene2D::Clear()
+{
+	m_minX.clear();
+	m_minY.clear();
+	m_maxX.clear();
+	m_maxY.clear();
+	m_numShapes = 0;
+}
+
+void AABB2RaycastScene2D::Reserve(int numBoxes)
+{
+	int paddedSize = GetPaddedSize(numBoxes);
+	m_minX.reserve(paddedSize);
+	m_minY.reserve(paddedSize);
+	m_maxX.reserve(paddedSize);
+	m_maxY.reserve(paddedSize);
+}
+
+int AABB2RaycastScene2D::AddAABB2(AABB2 const& box)
+{
+	int shapeIndex = m_numShapes++;
+	if (shapeIndex == (int)m_minX.size())
+	{
+		int paddedSize = GetPaddedSize(m_numShapes);
+		m_minX.resize(paddedSize, SCENE_FAR_POSITION);
+		m_minY.resize(paddedSize, SCENE_FAR_POSITION);
+		m_maxX.resize(paddedSize, SCENE_FAR_POSITION);
+		m_maxY.resize(paddedSize, SCENE_FAR_POSITION);
+	}
+
+	m_minX[shapeIndex] = box.m_mins.x;
+	m_minY[shapeIndex] = box.m_mins.y;
+	m_maxX[shapeIndex] = box.m_maxs.x;
+	m_maxY[shapeIndex] = box.m_maxs.y;
+	return shapeIndex;
+}
+
+RaycastSceneHit2D AABB2RaycastScene2D::RaycastClosest(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const
+{
+	FloatLanes startX = LanesSet(rayStart.x);
+	FloatLanes startY = LanesSet(rayStart.y);
+	FloatLanes inverseFwdX = GetSafeInverse(rayForwardNormal.x);
+	FloatLanes inverseFwdY = GetSafeInverse(rayForwardNormal.y);
+	FloatLanes maxLength = LanesSet(rayLength);
+	FloatLanes zero = LanesSet(0.f);
+
+	SceneClosestLanes closest(rayLength);
+	for (int firstIndex = 0; firstIndex < (int)m_minX.size(); firstIndex += FLOAT_LANE_COUNT)
+	{
+		FloatLanes distAX = LanesMul(LanesSub(LanesLoadUnaligned(&m_minX[firstIndex]), startX), inverseFwdX);
+		FloatLanes distBX = LanesMul(LanesSub(LanesLoadUnaligned(&m_maxX[firstIndex]), startX), inverseFwdX);
+		FloatLanes distAY = LanesMul(LanesSub(LanesLoadUnaligned(&m_minY[firstIndex]), startY), inverseFwdY);
+		FloatLanes distBY = LanesMul(LanesSub(LanesLoadUnaligned(&m_maxY[firstIndex]), startY), inverseFwdY);
+		FloatLanes enterDist = LanesMax(LanesMin(distAX, distBX), LanesMin(distAY, distBY));
+		FloatLanes exitDist = LanesMin(LanesMax(distAX, distBX), LanesMax(distAY, distBY));
+
+		FloatLanes isInside = LanesAnd(LanesLess(enterDist, zero), LanesLess(zero, exitDist));
+		FloatLanes isEntering = LanesAnd(LanesLessEqual(enterDist, exitDist), LanesAnd(LanesLessEqual(zero, enterDist), LanesLessEqual(enterDist, maxLength)));
+		FloatLanes isImpact = LanesOr(isInside, isEntering);
+		if (IsAnyLaneSet(isImpact))
+		{
+			closest.Update(isImpact, LanesSelect(isInside, zero, enterDist), firstIndex);
+		}
+	}
+	return closest.GetClosestHit();
+}
+
+void AABB2RaycastScene2D::RaycastClosest(int numRays, Vec2 const* rayStarts, Vec2 const* rayForwardNormals, float const* rayLengths, RaycastSceneHit2D* out_hits) const
+{
+	auto raycastPacket = [this](ScenePacketRays const& rays, ScenePacketClosestHits& closest)
+		{
+			FloatLanes zero = LanesSet(0.f);
+			for (int shapeIndex = 0; shapeIndex < m_numShapes; ++shapeIndex)
+			{
+				FloatLanes distAX = LanesMul(LanesSub(LanesSet(m_minX[shapeIndex]), rays.m_startX), rays.m_inverseFwdX);
+				FloatLanes distBX = LanesMul(LanesSub(LanesSet(m_maxX[shapeIndex]), rays.m_startX), rays.m_inverseFwdX);
+				FloatLanes distAY = LanesMul(LanesSub(LanesSet(m_minY[shapeIndex]), rays.m_startY), rays.m_inverseFwdY);
+				FloatLanes distBY = LanesMul(LanesSub(LanesSet(m_maxY[shapeIndex]), rays.m_startY), rays.m_inverseFwdY);
+				FloatLanes enterDist = LanesMax(LanesMin(distAX, distBX), LanesMin(distAY, distBY));
+				FloatLanes exitDist = LanesMin(LanesMax(distAX, distBX), LanesMax(distAY, distBY));
+
+				FloatLanes isInside = LanesAnd(LanesLess(enterDist, zero), LanesLess(zero, exitDist));
+				FloatLanes isEntering = LanesAnd(LanesLessEqual(enterDist, exitDist), LanesAnd(LanesLessEqual(zero, enterDist), LanesLessEqual(enterDist, rays.m_maxLength)));
+				FloatLanes isImpact = LanesOr(isInside, isEntering);
+				if (IsAnyLaneSet(isImpact))
+				{
+					closest.Update(isImpact, LanesSelect(isInside, zero, enterDist), shapeIndex);
+				}
+			}
+		};
+	RaycastClosestInRayPackets(numRays, rayStarts, rayForwardNormals, rayLengths, out_hits, raycastPacket);
+}
+
+RaycastResult2D AABB2RaycastScene2D::GetRaycastResult(RaycastSceneHit2D const& hit, Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const
+{
+	if (!hit.DidImpact())
+	{
+		return RaycastResult2D();
+	}
+	AABB2 box(Vec2(m_minX[hit.m_shapeIndex], m_minY[hit.m_shapeIndex]), Vec2(m_maxX[hit.m_shapeIndex], m_maxY[hit.m_shapeIndex]));
+	return RaycastVsAABB2D(rayStart, rayForwardNormal, rayLength, box);
+}
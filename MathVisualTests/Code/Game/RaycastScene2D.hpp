@@ -0,0 +1,85 @@
+#pragma once
+#include "Engine/Math/RaycastUtils.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+struct RaycastSceneHit2D
+{
+	int		m_shapeIndex = -1; // -1 on a miss
+	float	m_impactDist = 0.f;
+
+	bool DidImpact() const { return m_shapeIndex != -1; }
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Structure of arrays scenes for the 2D raycast modes, one per primitive type
+// Shape arrays are padded to the SIMD lane count with shapes that can never be hit,
+// so the closest hit kernels test a whole block of shapes per ray without a tail loop.
+// Only the winning shape goes through the scalar RaycastVs*2D function, for the full result.
+// The multi-ray RaycastClosest flips that around: rays are packed one per lane and every shape is broadcast across the packet.
+class DiscRaycastScene2D
+{
+public:
+	void Clear();
+	void Reserve(int numDiscs);
+	int AddDisc(Vec2 const& center, float radius);
+	int GetNumShapes() const { return m_numShapes; }
+
+	RaycastSceneHit2D RaycastClosest(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const;
+	void RaycastClosest(int numRays, Vec2 const* rayStarts, Vec2 const* rayForwardNormals, float const* rayLengths, RaycastSceneHit2D* out_hits) const;
+	RaycastResult2D GetRaycastResult(RaycastSceneHit2D const& hit, Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const;
+
+private:
+	std::vector<float> m_centerX;
+	std::vector<float> m_centerY;
+	std::vector<float> m_radiusSquared; // negative for padding
+	std::vector<float> m_radius;
+	int m_numShapes = 0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+class LineSegmentRaycastScene2D
+{
+public:
+	void Clear();
+	void Reserve(int numSegments);
+	int AddLineSegment(Vec2 const& start, Vec2 const& end);
+	int GetNumShapes() const { return m_numShapes; }
+
+	RaycastSceneHit2D RaycastClosest(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const;
+	void RaycastClosest(int numRays, Vec2 const* rayStarts, Vec2 const* rayForwardNormals, float const* rayLengths, RaycastSceneHit2D* out_hits) const;
+	RaycastResult2D GetRaycastResult(RaycastSceneHit2D const& hit, Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const;
+
+private:
+	std::vector<float> m_startX;
+	std::vector<float> m_startY;
+	std::vector<float> m_endX;
+	std::vector<float> m_endY; // zero length segments for padding
+	int m_numShapes = 0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+class AABB2RaycastScene2D
+{
+public:
+	void Clear();
+	void Reserve(int numBoxes);
+	int AddAABB2(AABB2 const& box);
+	int GetNumShapes() const { return m_numShapes; }
+
+	RaycastSceneHit2D RaycastClosest(Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const;
+	void RaycastClosest(int numRays, Vec2 const* rayStarts, Vec2 const* rayForwardNormals, float const* rayLengths, RaycastSceneHit2D* out_hits) const;
+	RaycastResult2D GetRaycastResult(RaycastSceneHit2D const& hit, Vec2 const& rayStart, Vec2 const& rayForwardNormal, float rayLength) const;
+
+private:
+	std::vector<float> m_minX;
+	std::vector<float> m_minY;
+	std::vector<float> m_maxX;
+	std::vector<float> m_maxY; // far away points for padding
+	int m_numShapes = 0;
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/Spline.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <algorithm>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Cumulative arc length of a spline at evenly spaced input keys, for constant speed traversal.
+// Build it whenever the spline points change, every distance query after that is a binary
+// search in the table plus one Newton step on the spline itself, with no re-integration.
+// Input keys are expected to run from 0 to the number of segments, as in every spline here.
+//
+// The table keeps no pointer to its spline, so it copies and moves with its owner: queries that
+// refine on the curve take the spline again, and it must be the one passed to the last Build.
+template<typename SplineType, typename PositionType>
+class SplineArcLengthTable
+{
+public:
+	void Build(SplineType const& spline, int samplesPerSegment = 32);
+	void Invalidate();
+	bool IsValid() const { return !m_cumulativeLengths.empty(); }
+
+	float GetSplineLength() const;
+	float GetInputKeyAtDistance(SplineType const& spline, float distanceAlongSpline) const;
+	PositionType GetPositionAtDistance(SplineType const& spline, float distanceAlongSpline) const;
+
+	// On the polyline through the samples, with no refinement on the curve. With one sample per
+	// segment this is the piecewise linear path through the spline points.
+	PositionType GetSampledPositionAtDistance(float distanceAlongSpline) const;
+
+private:
+	int GetUpperSampleIndexAtDistance(float distanceAlongSpline) const;
+	float GetSpeedAtInputKey(SplineType const& spline, float inputKey) const;
+
+private:
+	float m_keyStep = 1.f;
+	float m_maxKey = 0.f;
+	std::vector<PositionType> m_samplePositions; // at input key (index * m_keyStep)
+	std::vector<float> m_cumulativeLengths; // chord length sum up to each sample
+};
+
+typedef SplineArcLengthTable<Spline2D, Vec2> SplineArcLengthTable2D;
+typedef SplineArcLengthTable<Spline3D, Vec3> SplineArcLengthTable3D;
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename SplineType, typename PositionType>
+void SplineArcLengthTable<SplineType, PositionType>::Build(SplineType const& spline, int samplesPerSegment)
+{
+	int numSegments = spline.GetNumberOfSplineSegments();
+	int numSamples = (numSegments > 0) ? numSegments * samplesPerSegment + 1 : 1;
+	m_keyStep = 1.f / static_cast<float>(samplesPerSegment);
+	m_maxKey = static_cast<float>(numSegments);
+
+	m_samplePositions.resize(numSamples);
+	m_cumulativeLengths.resize(numSamples);
+	float cumulativeLength = 0.f;
+	for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+	{
+		m_samplePositions[sampleIndex] = spline.GetPositionAtInputKey(static_cast<float>(sampleIndex) * m_keyStep);
+		if (sampleIndex > 0)
+		{
+			cumulativeLength += (m_samplePositions[sampleIndex] - m_samplePositions[sampleIndex - 1]).GetLength();
+		}
+		m_cumulativeLengths[sampleIndex] = cumulativeLength;
+	}
+}
+
+template<typename SplineType, typename PositionType>
+void SplineArcLengthTable<SplineType, PositionType>::Invalidate()
+{
+	m_samplePositions.clear();
+	m_cumulativeLengths.clear();
+}
+
+template<typename SplineType, typename PositionType>
+float SplineArcLengthTable<SplineType, PositionType>::GetSplineLength() const
+{
+	GUARANTEE_OR_DIE(IsValid(), "Spline arc length table used before Build!");
+	return m_cumulativeLengths.back();
+}
+
+template<typename SplineType, typename PositionType>
+int SplineArcLengthTable<SplineType, PositionType>::GetUpperSampleIndexAtDistance(float distanceAlongSpline) const
+{
+	// First sample at or past the distance, the distance lies in the interval just before it
+	return static_cast<int>(std::lower_bound(m_cumulativeLengths.begin(), m_cumulativeLengths.end(), distanceAlongSpline) - m_cumulativeLengths.begin());
+}
+
+template<typename SplineType, typename PositionType>
+float SplineArcLengthTable<SplineType, PositionType>::GetInputKeyAtDistance(SplineType const& spline, float distanceAlongSpline) const
+{
+	GUARANTEE_OR_DIE(IsValid(), "Spline arc length table used before Build!");
+	if (distanceAlongSpline <= 0.f || m_cumulativeLengths.size() < 2)
+	{
+		return 0.f;
+	}
+	if (distanceAlongSpline >= m_cumulativeLengths.back())
+	{
+		return m_maxKey;
+	}
+
+	int upperIndex = GetUpperSampleIndexAtDistance(distanceAlongSpline);
+	int lowerIndex = upperIndex - 1;
+	float lowerLength = m_cumulativeLengths[lowerIndex];
+	float intervalLength = m_cumulativeLengths[upperIndex] - lowerLength;
+	float lowerKey = static_cast<float>(lowerIndex) * m_keyStep;
+	if (intervalLength <= 0.f)
+	{
+		return lowerKey;
+	}
+	float inputKey = lowerKey + m_keyStep * (distanceAlongSpline - lowerLength) / intervalLength;
+
+	// One Newton step on the chord from the lower sample, the error left is far below a pixel
+	float speed = GetSpeedAtInputKey(spline, inputKey);
+	if (speed > 0.f)
+	{
+		float chordLength = (spline.GetPositionAtInputKey(inputKey) - m_samplePositions[lowerIndex]).GetLength();
+		inputKey -= (lowerLength + chordLength - distanceAlongSpline) / speed;
+		inputKey = std::min(std::max(inputKey, lowerKey), lowerKey + m_keyStep);
+	}
+	return inputKey;
+}
+
+template<typename SplineType, typename PositionType>
+PositionType SplineArcLengthTable<SplineType, PositionType>::GetPositionAtDistance(SplineType const& spline, float distanceAlongSpline) const
+{
+	return spline.GetPositionAtInputKey(GetInputKeyAtDistance(spline, distanceAlongSpline));
+}
+
+template<typename SplineType, typename PositionType>
+PositionType SplineArcLengthTable<SplineType, PositionType>::GetSampledPositionAtDistance(float distanceAlongSpline) const
+{
+	GUARANTEE_OR_DIE(IsValid(), "Spline arc length table used before Build!");
+	if (distanceAlongSpline <= 0.f || m_cumulativeLengths.size() < 2)
+	{
+		return m_samplePositions.front();
+	}
+	if (distanceAlongSpline >= m_cumulativeLengths.back())
+	{
+		return m_samplePositions.back();
+	}
+
+	int upperIndex = GetUpperSampleIndexAtDistance(distanceAlongSpline);
+	int lowerIndex = upperIndex - 1;
+	float intervalLength = m_cumulativeLengths[upperIndex] - m_cumulativeLengths[lowerIndex];
+	if (intervalLength <= 0.f)
+	{
+		return m_samplePositions[lowerIndex];
+	}
+	float fraction = (distanceAlongSpline - m_cumulativeLengths[lowerIndex]) / intervalLength;
+	return m_samplePositions[lowerIndex] + (m_samplePositions[upperIndex] - m_samplePositions[lowerIndex]) * fraction;
+}
+
+template<typename SplineType, typename PositionType>
+float SplineArcLengthTable<SplineType, PositionType>::GetSpeedAtInputKey(SplineType const& spline, float inputKey) const
+{
+	// Central difference, Spline3D has no tangent accessor
+	float halfStep = m_keyStep * 0.01f;
+	float startKey = std::max(inputKey - halfStep, 0.f);
+	float endKey = std::min(inputKey + halfStep, m_maxKey);
+	if (endKey <= startKey)
+	{
+		return 0.f;
+	}
+	return (spline.GetPositionAtInputKey(endKey) - spline.GetPositionAtInputKey(startKey)).GetLength() / (endKey - startKey);
+}
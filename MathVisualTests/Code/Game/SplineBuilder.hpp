@@ -0,0 +1,24 @@
+#pragma once
+#include "Engine/Math/Spline.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <algorithm>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Orders control points by x in place, O(n log n), for splines that should run left to right
+template<typename PositionType>
+void SortSplinePointsAlongX(std::vector<PositionType>& points)
+{
+	std::sort(points.begin(), points.end(), [](PositionType const& a, PositionType const& b) { return a.x < b.x; });
+}
+
+// Catmull-Rom spline through unsorted points, the points are sorted in place and handed straight
+// to the spline, which derives every tangent from its two neighbors in a single pass
+template<typename SplineType, typename PositionType>
+void BuildCatmullRomSplineFromUnsortedPoints(SplineType& spline, std::vector<PositionType>& points, bool updateSpline)
+{
+	SortSplinePointsAlongX(points);
+	spline.ClearAllSplinePoints();
+	spline.SetFromCatmullRomAlgorithm(points, updateSpline);
+}
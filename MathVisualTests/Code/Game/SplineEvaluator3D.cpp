@@ -0,0 +1,192 @@
+#include "Game/SplineEvaluator3D.hpp"
+#include "Game/FloatLanes.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include <cmath>
+
+//-----------------------------------------------------------------------------------------------
+static constexpr int NUM_SEGMENT_CHANNELS = 6; // position xyz, scale xyz
+static constexpr int NUM_SEGMENT_COEFFICIENTS = NUM_SEGMENT_CHANNELS * 4;
+
+
+//-----------------------------------------------------------------------------------------------
+static int GetPaddedSize(int numKeys)
+{
+	return (numKeys + FLOAT_LANE_COUNT - 1) / FLOAT_LANE_COUNT * FLOAT_LANE_COUNT;
+}
+
+// Monomial coefficients of the cubic through values at t = 0, 1/3, 2/3 and 1
+static void SetCubicCoefficientsFromThirds(float* out_coefficients, float value0, float value1, float value2, float value3)
+{
+	out_coefficients[0] = value0;
+	out_coefficients[1] = 0.5f * (-11.f * value0 + 18.f * value1 - 9.f * value2 + 2.f * value3);
+	out_coefficients[2] = 0.5f * (18.f * value0 - 45.f * value1 + 36.f * value2 - 9.f * value3);
+	out_coefficients[3] = 0.5f * (-9.f * value0 + 27.f * value1 - 27.f * value2 + 9.f * value3);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Vec3 SplineSamples3D::GetPosition(int sampleIndex) const
+{
+	return Vec3(m_positionX[sampleIndex], m_positionY[sampleIndex], m_positionZ[sampleIndex]);
+}
+
+Quat SplineSamples3D::GetRotation(int sampleIndex) const
+{
+	return Quat(m_rotationX[sampleIndex], m_rotationY[sampleIndex], m_rotationZ[sampleIndex], m_rotationW[sampleIndex]);
+}
+
+Vec3 SplineSamples3D::GetScale(int sampleIndex) const
+{
+	return Vec3(m_scaleX[sampleIndex], m_scaleY[sampleIndex], m_scaleZ[sampleIndex]);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void SplineEvaluator3D::Build(Spline3D const& spline, int rotationSamplesPerSegment)
+{
+	GUARANTEE_OR_DIE(rotationSamplesPerSegment > 0, "SplineEvaluator3D needs at least one rotation sample per segment!");
+	m_numSegments = spline.GetNumberOfSplineSegments();
+	m_rotationSamplesPerSegment = rotationSamplesPerSegment;
+	m_segmentCoefficients.resize(m_numSegments * NUM_SEGMENT_COEFFICIENTS);
+	for (int segmentIndex = 0; segmentIndex < m_numSegments; ++segmentIndex)
+	{
+		float startKey = static_cast<float>(segmentIndex);
+		Vec3 positions[4];
+		Vec3 scales[4];
+		for (int thirdIndex = 0; thirdIndex < 4; ++thirdIndex)
+		{
+			float inputKey = startKey + static_cast<float>(thirdIndex) * (1.f / 3.f);
+			positions[thirdIndex] = spline.GetPositionAtInputKey(inputKey);
+			scales[thirdIndex] = spline.GetScaleAtInputKey(inputKey);
+		}
+
+		float* coefficients = &m_segmentCoefficients[segmentIndex * NUM_SEGMENT_COEFFICIENTS];
+		SetCubicCoefficientsFromThirds(coefficients + 0, positions[0].x, positions[1].x, positions[2].x, positions[3].x);
+		SetCubicCoefficientsFromThirds(coefficients + 4, positions[0].y, positions[1].y, positions[2].y, positions[3].y);
+		SetCubicCoefficientsFromThirds(coefficients + 8, positions[0].z, positions[1].z, positions[2].z, positions[3].z);
+		SetCubicCoefficientsFromThirds(coefficients + 12, scales[0].x, scales[1].x, scales[2].x, scales[3].x);
+		SetCubicCoefficientsFromThirds(coefficients + 16, scales[0].y, scales[1].y, scales[2].y, scales[3].y);
+		SetCubicCoefficientsFromThirds(coefficients + 20, scales[0].z, scales[1].z, scales[2].z, scales[3].z);
+	}
+
+	// One extra sample so the last interval has an end
+	int numRotationSamples = m_numSegments * m_rotationSamplesPerSegment + 1;
+	m_rotationSamples.resize(numRotationSamples * 4);
+	float sampleStep = 1.f / static_cast<float>(m_rotationSamplesPerSegment);
+	for (int sampleIndex = 0; sampleIndex < numRotationSamples; ++sampleIndex)
+	{
+		Quat rotation = spline.GetQuaternionAtInputKey(static_cast<float>(sampleIndex) * sampleStep);
+		float* sample = &m_rotationSamples[sampleIndex * 4];
+		sample[0] = rotation.x;
+		sample[1] = rotation.y;
+		sample[2] = rotation.z;
+		sample[3] = rotation.w;
+		if (sampleIndex > 0)
+		{
+			float const* previousSample = sample - 4;
+			float dot = sample[0] * previousSample[0] + sample[1] * previousSample[1] + sample[2] * previousSample[2] + sample[3] * previousSample[3];
+			if (dot < 0.f)
+			{
+				sample[0] = -sample[0];
+				sample[1] = -sample[1];
+				sample[2] = -sample[2];
+				sample[3] = -sample[3];
+			}
+		}
+	}
+}
+
+void SplineEvaluator3D::Evaluate(int numKeys, float const* inputKeys, SplineSamples3D& out_samples) const
+{
+	int paddedSize = GetPaddedSize(numKeys);
+	out_samples.m_numSamples = numKeys;
+	out_samples.m_positionX.resize(paddedSize);
+	out_samples.m_positionY.resize(paddedSize);
+	out_samples.m_positionZ.resize(paddedSize);
+	out_samples.m_rotationX.resize(paddedSize);
+	out_samples.m_rotationY.resize(paddedSize);
+	out_samples.m_rotationZ.resize(paddedSize);
+	out_samples.m_rotationW.resize(paddedSize);
+	out_samples.m_scaleX.resize(paddedSize);
+	out_samples.m_scaleY.resize(paddedSize);
+	out_samples.m_scaleZ.resize(paddedSize);
+	if (m_numSegments <= 0)
+	{
+		return;
+	}
+
+	float* channelOutputs[NUM_SEGMENT_CHANNELS] = {
+		out_samples.m_positionX.data(), out_samples.m_positionY.data(), out_samples.m_positionZ.data(),
+		out_samples.m_scaleX.data(), out_samples.m_scaleY.data(), out_samples.m_scaleZ.data() };
+	float* rotationOutputs[4] = {
+		out_samples.m_rotationX.data(), out_samples.m_rotationY.data(), out_samples.m_rotationZ.data(), out_samples.m_rotationW.data() };
+
+	float maxKey = static_cast<float>(m_numSegments);
+	float rotationSamplesPerSegment = static_cast<float>(m_rotationSamplesPerSegment);
+	int lastRotationInterval = m_numSegments * m_rotationSamplesPerSegment - 1;
+
+	alignas(32) float segmentT[FLOAT_LANE_COUNT];
+	alignas(32) float rotationFraction[FLOAT_LANE_COUNT];
+	alignas(32) float coefficientLanes[NUM_SEGMENT_COEFFICIENTS][FLOAT_LANE_COUNT];
+	alignas(32) float rotationLanes[8][FLOAT_LANE_COUNT]; // start xyzw, end xyzw
+
+	for (int blockStart = 0; blockStart < paddedSize; blockStart += FLOAT_LANE_COUNT)
+	{
+		// Segment lookup, one floor per key, and a transpose of what each key needs into lanes
+		// Padding lanes repeat the last key, their results are never read
+		for (int laneIndex = 0; laneIndex < FLOAT_LANE_COUNT; ++laneIndex)
+		{
+			int keyIndex = blockStart + laneIndex;
+			float inputKey = inputKeys[(keyIndex < numKeys) ? keyIndex : numKeys - 1];
+			inputKey = (inputKey < 0.f) ? 0.f : ((inputKey > maxKey) ? maxKey : inputKey);
+
+			int segmentIndex = static_cast<int>(inputKey);
+			segmentIndex = (segmentIndex < m_numSegments) ? segmentIndex : m_numSegments - 1;
+			segmentT[laneIndex] = inputKey - static_cast<float>(segmentIndex);
+			float const* coefficients = &m_segmentCoefficients[segmentIndex * NUM_SEGMENT_COEFFICIENTS];
+			for (int coefficientIndex = 0; coefficientIndex < NUM_SEGMENT_COEFFICIENTS; ++coefficientIndex)
+			{
+				coefficientLanes[coefficientIndex][laneIndex] = coefficients[coefficientIndex];
+			}
+
+			float rotationKey = inputKey * rotationSamplesPerSegment;
+			int rotationInterval = static_cast<int>(rotationKey);
+			rotationInterval = (rotationInterval < lastRotationInterval) ? rotationInterval : lastRotationInterval;
+			rotationFraction[laneIndex] = rotationKey - static_cast<float>(rotationInterval);
+			float const* rotationSample = &m_rotationSamples[rotationInterval * 4];
+			for (int componentIndex = 0; componentIndex < 8; ++componentIndex)
+			{
+				rotationLanes[componentIndex][laneIndex] = rotationSample[componentIndex];
+			}
+		}
+
+		// Position and scale share the segment t
+		FloatLanes t = LanesLoad(segmentT);
+		for (int channelIndex = 0; channelIndex < NUM_SEGMENT_CHANNELS; ++channelIndex)
+		{
+			float const (*channel)[FLOAT_LANE_COUNT] = &coefficientLanes[channelIndex * 4];
+			FloatLanes value = LanesLoad(channel[3]);
+			value = LanesAdd(LanesMul(value, t), LanesLoad(channel[2]));
+			value = LanesAdd(LanesMul(value, t), LanesLoad(channel[1]));
+			value = LanesAdd(LanesMul(value, t), LanesLoad(channel[0]));
+			LanesStoreUnaligned(channelOutputs[channelIndex] + blockStart, value);
+		}
+
+		// Rotation is an nlerp between neighboring samples
+		FloatLanes fraction = LanesLoad(rotationFraction);
+		FloatLanes components[4];
+		FloatLanes lengthSquared = LanesSet(0.f);
+		for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+		{
+			FloatLanes start = LanesLoad(rotationLanes[componentIndex]);
+			FloatLanes end = LanesLoad(rotationLanes[componentIndex + 4]);
+			components[componentIndex] = LanesAdd(start, LanesMul(LanesSub(end, start), fraction));
+			lengthSquared = LanesAdd(lengthSquared, LanesMul(components[componentIndex], components[componentIndex]));
+		}
+		FloatLanes inverseLength = LanesDiv(LanesSet(1.f), LanesSqrt(lengthSquared));
+		for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+		{
+			LanesStoreUnaligned(rotationOutputs[componentIndex] + blockStart, LanesMul(components[componentIndex], inverseLength));
+		}
+	}
+}
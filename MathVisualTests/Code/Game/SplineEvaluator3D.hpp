@@ -0,0 +1,57 @@
+#pragma once
+#include "Engine/Math/Quat.hpp"
+#include "Engine/Math/Spline.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Output of SplineEvaluator3D::Evaluate, one entry per input key
+// Arrays are padded to the SIMD lane count
+struct SplineSamples3D
+{
+	int m_numSamples = 0;
+
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+	std::vector<float> m_rotationX;
+	std::vector<float> m_rotationY;
+	std::vector<float> m_rotationZ;
+	std::vector<float> m_rotationW;
+	std::vector<float> m_scaleX;
+	std::vector<float> m_scaleY;
+	std::vector<float> m_scaleZ;
+
+	Vec3 GetPosition(int sampleIndex) const;
+	Quat GetRotation(int sampleIndex) const;
+	Vec3 GetScale(int sampleIndex) const;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Position, rotation and scale of a Spline3D for a whole array of input keys at once
+// Build bakes the spline: every segment's position and scale become cubic coefficients (exact,
+// the segments are cubics in their local t) and rotation is sampled densely and nlerped.
+// Evaluate finds each key's segment in O(1), so keys can come in any order, and then runs the
+// shared basis powers through all three channels for a block of keys per SIMD pass.
+// Input keys are expected to run from 0 to the number of segments, as in every spline here.
+class SplineEvaluator3D
+{
+public:
+	void Build(Spline3D const& spline, int rotationSamplesPerSegment = 16);
+	int GetNumberOfSplineSegments() const { return m_numSegments; }
+
+	// out_samples keeps its capacity between calls, reuse it every frame
+	void Evaluate(int numKeys, float const* inputKeys, SplineSamples3D& out_samples) const;
+
+private:
+	int m_numSegments = 0;
+	int m_rotationSamplesPerSegment = 1;
+
+	// [segment][channel][power], channels are position xyz then scale xyz,
+	// value = c0 + t * (c1 + t * (c2 + t * c3))
+	std::vector<float> m_segmentCoefficients;
+
+	// [sample][xyzw], each sample is in the same hemisphere as the one before it
+	std::vector<float> m_rotationSamples;
+};
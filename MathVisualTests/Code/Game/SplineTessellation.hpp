@@ -0,0 +1,83 @@
+#pragma once
+#include "Engine/Math/Spline.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Adaptive replacement for GetPositionListWithSubdivisions, each segment gets just enough
+// uniform steps to stay within flatnessTolerance (world units, pixels for the 2D screen camera)
+// of the true curve, so straight stretches get a single chord and tight bends get many.
+//
+// Every spline segment is a cubic in its local t, four samples recover its Bezier hull and
+// Wang's formula turns the hull's second differences into the step count. The counts are
+// summed first so the output is sized once and filled in place.
+// Input keys are expected to run from 0 to the number of segments, as in every spline here.
+constexpr int SPLINE_TESSELLATION_MAX_SUBDIVISIONS = 256;
+constexpr float SPLINE_TESSELLATION_MIN_TOLERANCE = 1e-4f;
+
+//-----------------------------------------------------------------------------------------------
+template<typename SplineType, typename PositionType>
+int GetAdaptiveSubdivisionsForSplineSegment(SplineType const& spline, int segmentIndex, float flatnessTolerance)
+{
+	float startKey = static_cast<float>(segmentIndex);
+	PositionType p0 = spline.GetPositionAtInputKey(startKey);
+	PositionType p1 = spline.GetPositionAtInputKey(startKey + 1.f / 3.f);
+	PositionType p2 = spline.GetPositionAtInputKey(startKey + 2.f / 3.f);
+	PositionType p3 = spline.GetPositionAtInputKey(startKey + 1.f);
+
+	// Bezier control points of the cubic through the four samples
+	PositionType a = 27.f * p1 - 8.f * p0 - p3;
+	PositionType b = 27.f * p2 - p0 - 8.f * p3;
+	PositionType b1 = (2.f * a - b) * (1.f / 18.f);
+	PositionType b2 = (2.f * b - a) * (1.f / 18.f);
+
+	float secondDifference1 = (p0 - 2.f * b1 + b2).GetLength();
+	float secondDifference2 = (b1 - 2.f * b2 + p3).GetLength();
+	float maxSecondDifference = std::max(secondDifference1, secondDifference2);
+
+	// Wang's formula for degree 3: n = sqrt(3 * 2 / 8 * max|second difference| / tolerance)
+	// Clamped as a float first, a zero or NaN tolerance or a blown-up curve would overflow the int cast
+	float tolerance = (flatnessTolerance > SPLINE_TESSELLATION_MIN_TOLERANCE) ? flatnessTolerance : SPLINE_TESSELLATION_MIN_TOLERANCE;
+	float numSubdivisions = ceilf(sqrtf(0.75f * maxSecondDifference / tolerance));
+	if (!(numSubdivisions <= static_cast<float>(SPLINE_TESSELLATION_MAX_SUBDIVISIONS)))
+	{
+		return SPLINE_TESSELLATION_MAX_SUBDIVISIONS;
+	}
+	return std::max(static_cast<int>(numSubdivisions), 1);
+}
+
+template<typename SplineType, typename PositionType>
+void GetAdaptivePositionListForSpline(SplineType const& spline, std::vector<PositionType>& out_positions, float flatnessTolerance)
+{
+	out_positions.clear();
+	int numSegments = spline.GetNumberOfSplineSegments();
+	if (numSegments <= 0)
+	{
+		return;
+	}
+
+	std::vector<int> subdivisionsPerSegment(numSegments);
+	int numPositions = 1;
+	for (int segmentIndex = 0; segmentIndex < numSegments; ++segmentIndex)
+	{
+		subdivisionsPerSegment[segmentIndex] = GetAdaptiveSubdivisionsForSplineSegment<SplineType, PositionType>(spline, segmentIndex, flatnessTolerance);
+		numPositions += subdivisionsPerSegment[segmentIndex];
+	}
+
+	out_positions.resize(numPositions);
+	int positionIndex = 0;
+	for (int segmentIndex = 0; segmentIndex < numSegments; ++segmentIndex)
+	{
+		int numSubdivisions = subdivisionsPerSegment[segmentIndex];
+		float step = 1.f / static_cast<float>(numSubdivisions);
+		float startKey = static_cast<float>(segmentIndex);
+		for (int subdivisionIndex = 0; subdivisionIndex < numSubdivisions; ++subdivisionIndex)
+		{
+			out_positions[positionIndex++] = spline.GetPositionAtInputKey(startKey + static_cast<float>(subdivisionIndex) * step);
+		}
+	}
+	out_positions[positionIndex] = spline.GetPositionAtInputKey(static_cast<float>(numSegments));
+}
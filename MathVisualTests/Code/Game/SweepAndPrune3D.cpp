@@ -0,0 +1,306 @@
+#include "Game/SweepAndPrune3D.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+
+//-----------------------------------------------------------------------------------------------
+static float GetAxisValue(Vec3 const& vec, int axis)
+{
+	return (axis == 0) ? vec.x : ((axis == 1) ? vec.y : vec.z);
+}
+
+// The one endpoint order for the full sort and the insertion sort: mins before maxs on equal values,
+// so bounds that only touch are overlapping on this axis, matching DoBoundsOverlap
+static bool IsEndpointSortedBefore(SweepAndPruneEndpoint3D const& a, SweepAndPruneEndpoint3D const& b)
+{
+	return a.m_value < b.m_value || (a.m_value == b.m_value && !a.IsMax() && b.IsMax());
+}
+
+static bool AreBoundsEqual(AABB3 const& boundsA, AABB3 const& boundsB)
+{
+	return boundsA.m_mins == boundsB.m_mins && boundsA.m_maxs == boundsB.m_maxs;
+}
+
+//-----------------------------------------------------------------------------------------------
+void SweepAndPrune3D::Clear()
+{
+	m_proxies.clear();
+	m_infiniteProxyIds.clear();
+	m_movedProxyIds.clear();
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		m_endpoints[axis].clear();
+	}
+	m_pairs.clear();
+	m_isRebuildNeeded = false;
+}
+
+int SweepAndPrune3D::CreateProxy(AABB3 const& bounds, int userIndex)
+{
+	int proxyId = (int)m_proxies.size();
+	SweepAndPruneProxy3D proxy;
+	proxy.m_bounds = bounds;
+	proxy.m_userIndex = userIndex;
+	m_proxies.push_back(proxy);
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		SweepAndPruneEndpoint3D minEndpoint;
+		minEndpoint.m_proxyIdAndIsMax = proxyId << 1;
+		SweepAndPruneEndpoint3D maxEndpoint;
+		maxEndpoint.m_proxyIdAndIsMax = (proxyId << 1) | 1;
+		m_endpoints[axis].push_back(minEndpoint);
+		m_endpoints[axis].push_back(maxEndpoint);
+	}
+
+	// Bulk creation is sorted and swept once, insertion sort is only for frame to frame motion
+	m_isRebuildNeeded = true;
+	return proxyId;
+}
+
+int SweepAndPrune3D::CreateInfiniteProxy(Plane3 const& plane, int userIndex)
+{
+	int proxyId = (int)m_proxies.size();
+	SweepAndPruneProxy3D proxy;
+	proxy.m_plane = plane;
+	proxy.m_userIndex = userIndex;
+	proxy.m_isInfinite = true;
+	m_proxies.push_back(proxy);
+
+	m_infiniteProxyIds.push_back(proxyId);
+	m_isRebuildNeeded = true;
+	return proxyId;
+}
+
+void SweepAndPrune3D::MoveProxy(int proxyId, AABB3 const& bounds)
+{
+	SweepAndPruneProxy3D& proxy = m_proxies[proxyId];
+	GUARANTEE_OR_DIE(!proxy.m_isInfinite, "Use MoveInfiniteProxy for infinite proxies!");
+	if (AreBoundsEqual(proxy.m_bounds, bounds))
+	{
+		return;
+	}
+
+	proxy.m_bounds = bounds;
+	if (!proxy.m_hasMoved)
+	{
+		proxy.m_hasMoved = true;
+		m_movedProxyIds.push_back(proxyId);
+	}
+}
+
+void SweepAndPrune3D::MoveInfiniteProxy(int proxyId, Plane3 const& plane)
+{
+	SweepAndPruneProxy3D& proxy = m_proxies[proxyId];
+	GUARANTEE_OR_DIE(proxy.m_isInfinite, "Use MoveProxy for finite proxies!");
+	proxy.m_plane = plane;
+	if (!proxy.m_hasMoved)
+	{
+		proxy.m_hasMoved = true;
+		m_movedProxyIds.push_back(proxyId);
+	}
+}
+
+void SweepAndPrune3D::UpdatePairs()
+{
+	if (m_isRebuildNeeded)
+	{
+		RebuildSortedAxes();
+	}
+	else if (!m_movedProxyIds.empty())
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			InsertionSortAxis(axis);
+		}
+		for (int proxyId : m_movedProxyIds)
+		{
+			UpdateInfinitePairs(proxyId);
+		}
+	}
+
+	MarkPairsDirtyForMovedProxies();
+}
+
+int SweepAndPrune3D::GetNumPairs() const
+{
+	return (int)m_pairs.size();
+}
+
+//-----------------------------------------------------------------------------------------------
+uint64_t SweepAndPrune3D::GetPairKey(int proxyIdA, int proxyIdB)
+{
+	if (proxyIdA > proxyIdB)
+	{
+		std::swap(proxyIdA, proxyIdB);
+	}
+	return (static_cast<uint64_t>(proxyIdA) << 32) | static_cast<uint64_t>(proxyIdB);
+}
+
+void SweepAndPrune3D::AddPair(int proxyIdA, int proxyIdB)
+{
+	// A pair reported again (e.g. entering overlap on several axes at once) keeps its cached state
+	m_pairs.emplace(GetPairKey(proxyIdA, proxyIdB), SweepAndPrunePair3D());
+}
+
+void SweepAndPrune3D::RemovePair(int proxyIdA, int proxyIdB)
+{
+	m_pairs.erase(GetPairKey(proxyIdA, proxyIdB));
+}
+
+void SweepAndPrune3D::MarkPairsDirtyForMovedProxies()
+{
+	if (m_movedProxyIds.empty())
+	{
+		return;
+	}
+
+	for (auto& keyAndPair : m_pairs)
+	{
+		int proxyIdA = static_cast<int>(keyAndPair.first >> 32);
+		int proxyIdB = static_cast<int>(keyAndPair.first & 0xFFFFFFFFu);
+		if (m_proxies[proxyIdA].m_hasMoved || m_proxies[proxyIdB].m_hasMoved)
+		{
+			keyAndPair.second.m_isNarrowphaseDirty = true;
+		}
+	}
+
+	for (int proxyId : m_movedProxyIds)
+	{
+		m_proxies[proxyId].m_hasMoved = false;
+	}
+	m_movedProxyIds.clear();
+}
+
+void SweepAndPrune3D::RebuildSortedAxes()
+{
+	m_pairs.clear();
+	m_isRebuildNeeded = false;
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		std::vector<SweepAndPruneEndpoint3D>& endpoints = m_endpoints[axis];
+		for (SweepAndPruneEndpoint3D& endpoint : endpoints)
+		{
+			AABB3 const& bounds = m_proxies[endpoint.GetProxyId()].m_bounds;
+			endpoint.m_value = GetAxisValue(endpoint.IsMax() ? bounds.m_maxs : bounds.m_mins, axis);
+		}
+		std::sort(endpoints.begin(), endpoints.end(), IsEndpointSortedBefore);
+	}
+
+	// Sweep the x axis with an active list, the other two axes are checked directly
+	std::vector<int> activeProxyIds;
+	for (SweepAndPruneEndpoint3D const& endpoint : m_endpoints[0])
+	{
+		int proxyId = endpoint.GetProxyId();
+		if (endpoint.IsMax())
+		{
+			activeProxyIds.erase(std::find(activeProxyIds.begin(), activeProxyIds.end(), proxyId));
+			continue;
+		}
+
+		for (int activeProxyId : activeProxyIds)
+		{
+			if (DoBoundsOverlap(proxyId, activeProxyId))
+			{
+				AddPair(proxyId, activeProxyId);
+			}
+		}
+		activeProxyIds.push_back(proxyId);
+	}
+
+	for (int infiniteProxyId : m_infiniteProxyIds)
+	{
+		UpdateInfinitePairs(infiniteProxyId);
+	}
+}
+
+void SweepAndPrune3D::InsertionSortAxis(int axis)
+{
+	std::vector<SweepAndPruneEndpoint3D>& endpoints = m_endpoints[axis];
+	for (SweepAndPruneEndpoint3D& endpoint : endpoints)
+	{
+		AABB3 const& bounds = m_proxies[endpoint.GetProxyId()].m_bounds;
+		endpoint.m_value = GetAxisValue(endpoint.IsMax() ? bounds.m_maxs : bounds.m_mins, axis);
+	}
+
+	// Every swap between a min and a max is an overlap change on this axis
+	int numEndpoints = (int)endpoints.size();
+	for (int endpointIndex = 1; endpointIndex < numEndpoints; ++endpointIndex)
+	{
+		SweepAndPruneEndpoint3D key = endpoints[endpointIndex];
+		int proxyId = key.GetProxyId();
+		int insertIndex = endpointIndex - 1;
+		while (insertIndex >= 0 && IsEndpointSortedBefore(key, endpoints[insertIndex]))
+		{
+			SweepAndPruneEndpoint3D const& other = endpoints[insertIndex];
+			int otherProxyId = other.GetProxyId();
+			if (!key.IsMax() && other.IsMax())
+			{
+				// A min moved below another max: the bounds may have started overlapping
+				if (DoBoundsOverlap(proxyId, otherProxyId))
+				{
+					AddPair(proxyId, otherProxyId);
+				}
+			}
+			else if (key.IsMax() && !other.IsMax())
+			{
+				// A max moved below another min: the bounds are now separated on this axis
+				RemovePair(proxyId, otherProxyId);
+			}
+
+			endpoints[insertIndex + 1] = other;
+			--insertIndex;
+		}
+		endpoints[insertIndex + 1] = key;
+	}
+}
+
+void SweepAndPrune3D::UpdateInfinitePairs(int proxyId)
+{
+	SweepAndPruneProxy3D const& proxy = m_proxies[proxyId];
+	if (proxy.m_isInfinite)
+	{
+		// A moved plane is checked against the bounds of every finite proxy, and paired with every other plane
+		int numProxies = (int)m_proxies.size();
+		for (int otherProxyId = 0; otherProxyId < numProxies; ++otherProxyId)
+		{
+			if (otherProxyId == proxyId)
+			{
+				continue;
+			}
+
+			SweepAndPruneProxy3D const& other = m_proxies[otherProxyId];
+			if (other.m_isInfinite || DoAABBAndPlaneOverlap3D(other.m_bounds, proxy.m_plane))
+			{
+				AddPair(proxyId, otherProxyId);
+			}
+			else
+			{
+				RemovePair(proxyId, otherProxyId);
+			}
+		}
+		return;
+	}
+
+	for (int infiniteProxyId : m_infiniteProxyIds)
+	{
+		if (DoAABBAndPlaneOverlap3D(proxy.m_bounds, m_proxies[infiniteProxyId].m_plane))
+		{
+			AddPair(proxyId, infiniteProxyId);
+		}
+		else
+		{
+			RemovePair(proxyId, infiniteProxyId);
+		}
+	}
+}
+
+bool SweepAndPrune3D::DoBoundsOverlap(int proxyIdA, int proxyIdB) const
+{
+	AABB3 const& boundsA = m_proxies[proxyIdA].m_bounds;
+	AABB3 const& boundsB = m_proxies[proxyIdB].m_bounds;
+	return boundsA.m_mins.x <= boundsB.m_maxs.x && boundsA.m_maxs.x >= boundsB.m_mins.x
+		&& boundsA.m_mins.y <= boundsB.m_maxs.y && boundsA.m_maxs.y >= boundsB.m_mins.y
+		&& boundsA.m_mins.z <= boundsB.m_maxs.z && boundsA.m_maxs.z >= boundsB.m_mins.z;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Plane3.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+struct SweepAndPruneProxy3D
+{
+	AABB3	m_bounds;
+	Plane3	m_plane; // infinite proxies only
+	int		m_userIndex = -1;
+	bool	m_isInfinite = false;
+	bool	m_hasMoved = false;
+};
+
+struct SweepAndPruneEndpoint3D
+{
+	float	m_value = 0.f;
+	int		m_proxyIdAndIsMax = 0; // (proxyId << 1) | isMax
+
+	int GetProxyId() const { return m_proxyIdAndIsMax >> 1; }
+	bool IsMax() const { return (m_proxyIdAndIsMax & 1) != 0; }
+};
+
+struct SweepAndPrunePair3D
+{
+	bool	m_isNarrowphaseDirty = true;
+	bool	m_isTouching = false;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Incremental sort and sweep broadphase
+// Endpoints stay sorted on all three axes between frames, so each update is an insertion sort
+// that is close to O(n) while objects move a little per frame. Overlapping bounds are kept in a
+// persistent pair set, and the narrowphase only reruns for new pairs or pairs with a moved proxy.
+// Planes have no finite bounds, they are paired against the bounds of every finite proxy instead.
+class SweepAndPrune3D
+{
+public:
+	void Clear();
+	int CreateProxy(AABB3 const& bounds, int userIndex);
+	int CreateInfiniteProxy(Plane3 const& plane, int userIndex);
+	void MoveProxy(int proxyId, AABB3 const& bounds);
+	void MoveInfiniteProxy(int proxyId, Plane3 const& plane);
+
+	void UpdatePairs();
+
+	// narrowphase(userIndexA, userIndexB) only runs for new or changed pairs, the result is cached
+	template<typename NarrowphaseFunc>
+	void QueryTouchingPairs(NarrowphaseFunc& narrowphase, std::vector<std::pair<int, int>>& out_userIndexPairs);
+
+	int GetNumPairs() const;
+
+private:
+	static uint64_t GetPairKey(int proxyIdA, int proxyIdB);
+	void AddPair(int proxyIdA, int proxyIdB);
+	void RemovePair(int proxyIdA, int proxyIdB);
+	void MarkPairsDirtyForMovedProxies();
+
+	void RebuildSortedAxes();
+	void InsertionSortAxis(int axis);
+	void UpdateInfinitePairs(int proxyId);
+	bool DoBoundsOverlap(int proxyIdA, int proxyIdB) const;
+
+private:
+	std::vector<SweepAndPruneProxy3D> m_proxies;
+	std::vector<int> m_infiniteProxyIds;
+	std::vector<int> m_movedProxyIds;
+	std::vector<SweepAndPruneEndpoint3D> m_endpoints[3];
+	std::unordered_map<uint64_t, SweepAndPrunePair3D> m_pairs;
+	bool m_isRebuildNeeded = false;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename NarrowphaseFunc>
+void SweepAndPrune3D::QueryTouchingPairs(NarrowphaseFunc& narrowphase, std::vector<std::pair<int, int>>& out_userIndexPairs)
+{
+	for (auto& keyAndPair : m_pairs)
+	{
+		int proxyIdA = static_cast<int>(keyAndPair.first >> 32);
+		int proxyIdB = static_cast<int>(keyAndPair.first & 0xFFFFFFFFu);
+		SweepAndPrunePair3D& pair = keyAndPair.second;
+		int userIndexA = m_proxies[proxyIdA].m_userIndex;
+		int userIndexB = m_proxies[proxyIdB].m_userIndex;
+
+		if (pair.m_isNarrowphaseDirty)
+		{
+			pair.m_isTouching = narrowphase(userIndexA, userIndexB);
+			pair.m_isNarrowphaseDirty = false;
+		}
+		if (pair.m_isTouching)
+		{
+			out_userIndexPairs.emplace_back(userIndexA, userIndexB);
+		}
+	}
+}
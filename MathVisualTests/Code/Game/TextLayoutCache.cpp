@@ -0,0 +1,68 @@
+#include "Game/TextLayoutCache.hpp"
+#include <functional>
+
+
+//-----------------------------------------------------------------------------------------------
+TextLayoutCache::TextLayoutCache()
+{
+	m_entries.reserve(TEXT_LAYOUT_CACHE_SIZE);
+}
+
+void TextLayoutCache::AddVertsForTextInBox2D(std::vector<Vertex_PCU>& verts, BitmapFont& font, std::string const& text, AABB2 const& box, float cellHeight,
+	Rgba8 const& tint, float cellAspect, Vec2 const& alignment, TextBoxMode mode)
+{
+	std::vector<Vertex_PCU> const& cachedVerts = GetOrAddVertsForTextInBox2D(font, text, box, cellHeight, tint, cellAspect, alignment, mode);
+	verts.insert(verts.end(), cachedVerts.begin(), cachedVerts.end());
+}
+
+std::vector<Vertex_PCU> const& TextLayoutCache::GetOrAddVertsForTextInBox2D(BitmapFont& font, std::string const& text, AABB2 const& box, float cellHeight,
+	Rgba8 const& tint, float cellAspect, Vec2 const& alignment, TextBoxMode mode)
+{
+	m_currentTick++;
+	size_t textHash = std::hash<std::string>()(text);
+
+	TextLayoutEntry* leastRecentlyUsedEntry = nullptr;
+	for (TextLayoutEntry& entry : m_entries)
+	{
+		if (entry.m_textHash == textHash && entry.m_font == &font && entry.m_cellHeight == cellHeight && entry.m_cellAspect == cellAspect && entry.m_mode == mode
+			&& entry.m_box.m_mins == box.m_mins && entry.m_box.m_maxs == box.m_maxs && entry.m_alignment == alignment && entry.m_tint == tint
+			&& entry.m_text == text)
+		{
+			entry.m_lastUsedTick = m_currentTick;
+			m_numHits++;
+			return entry.m_verts;
+		}
+		if (leastRecentlyUsedEntry == nullptr || entry.m_lastUsedTick < leastRecentlyUsedEntry->m_lastUsedTick)
+		{
+			leastRecentlyUsedEntry = &entry;
+		}
+	}
+
+	m_numMisses++;
+	TextLayoutEntry* newEntry = leastRecentlyUsedEntry;
+	if (static_cast<int>(m_entries.size()) < TEXT_LAYOUT_CACHE_SIZE)
+	{
+		m_entries.emplace_back();
+		newEntry = &m_entries.back();
+	}
+	newEntry->m_font = &font;
+	newEntry->m_textHash = textHash;
+	newEntry->m_text = text;
+	newEntry->m_box = box;
+	newEntry->m_cellHeight = cellHeight;
+	newEntry->m_tint = tint;
+	newEntry->m_cellAspect = cellAspect;
+	newEntry->m_alignment = alignment;
+	newEntry->m_mode = mode;
+	newEntry->m_lastUsedTick = m_currentTick;
+	newEntry->m_verts.clear();
+	font.AddVertsForTextInBox2D(newEntry->m_verts, text, box, cellHeight, tint, cellAspect, alignment, mode);
+	return newEntry->m_verts;
+}
+
+void TextLayoutCache::Clear()
+{
+	m_entries.clear();
+	m_numHits = 0;
+	m_numMisses = 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+constexpr int TEXT_LAYOUT_CACHE_SIZE = 32; // least recently used layout is replaced when full
+
+
+//-----------------------------------------------------------------------------------------------
+// Remembers the glyph verts of recent BitmapFont::AddVertsForTextInBox2D calls, so text that is
+// the same every frame (usage lines, benchmark reports) is laid out once and then only copied.
+// Entries are keyed by font, text, box and every layout parameter; the text hash is checked
+// first and the full string confirms a hit.
+class TextLayoutCache
+{
+public:
+	TextLayoutCache();
+
+	// Appends to verts exactly what font.AddVertsForTextInBox2D would have
+	void AddVertsForTextInBox2D(std::vector<Vertex_PCU>& verts, BitmapFont& font, std::string const& text, AABB2 const& box, float cellHeight,
+		Rgba8 const& tint = Rgba8::OPAQUE_WHITE, float cellAspect = 1.f, Vec2 const& alignment = Vec2(0.5f, 0.5f), TextBoxMode mode = TextBoxMode::SHRINK_TO_FIT);
+
+	// Valid until TEXT_LAYOUT_CACHE_SIZE other layouts have been requested; entries never move
+	std::vector<Vertex_PCU> const& GetOrAddVertsForTextInBox2D(BitmapFont& font, std::string const& text, AABB2 const& box, float cellHeight,
+		Rgba8 const& tint = Rgba8::OPAQUE_WHITE, float cellAspect = 1.f, Vec2 const& alignment = Vec2(0.5f, 0.5f), TextBoxMode mode = TextBoxMode::SHRINK_TO_FIT);
+
+	void Clear();
+	int GetNumHits() const { return m_numHits; }
+	int GetNumMisses() const { return m_numMisses; }
+
+private:
+	struct TextLayoutEntry
+	{
+		BitmapFont const* m_font = nullptr;
+		size_t m_textHash = 0;
+		std::string m_text;
+		AABB2 m_box;
+		float m_cellHeight = 0.f;
+		Rgba8 m_tint;
+		float m_cellAspect = 0.f;
+		Vec2 m_alignment;
+		TextBoxMode m_mode = TextBoxMode::SHRINK_TO_FIT;
+
+		unsigned int m_lastUsedTick = 0;
+		std::vector<Vertex_PCU> m_verts;
+	};
+
+	std::vector<TextLayoutEntry> m_entries; // capacity reserved up front so returned verts stay put
+	unsigned int m_currentTick = 0;
+	int m_numHits = 0;
+	int m_numMisses = 0;
+};